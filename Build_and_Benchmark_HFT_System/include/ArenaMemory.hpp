@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// Backing memory for the book/OMS arenas
+// -----------------------------------------------------------------------------
+// OrderStore slabs, the IdIndex table and FixedPool chunks (map-book and
+// engine level nodes) take their memory from ArenaBuffer. By default that is
+// the aligned global heap. With huge pages enabled, buffers of at least
+// kHugePageBytes / 2 are rounded up to 2MB pages: explicit hugetlb pages when
+// the kernel has some reserved, else a 2MB-aligned mapping with
+// MADV_HUGEPAGE (transparent huge pages), else plain 4K pages.
+//
+// Placement: reserve() writes every record/bucket/block it carves, so the
+// thread that calls it first-touches the pages and the kernel puts them on
+// that thread's NUMA node. Pin the owning thread before reserving.
+// -----------------------------------------------------------------------------
+
+constexpr std::size_t kHugePageBytes = std::size_t{2} << 20;
+
+/// Process-wide arena policy; set once at startup, before books are reserved.
+struct ArenaMemoryPolicy {
+    bool huge_pages = false;
+};
+
+inline ArenaMemoryPolicy& arenaMemoryPolicy() noexcept {
+    static ArenaMemoryPolicy policy;
+    return policy;
+}
+
+/// Bytes currently held per backing kind (for startup reports/benchmarks).
+struct ArenaMemoryStats {
+    std::atomic<std::size_t> heap_bytes{0};
+    std::atomic<std::size_t> hugetlb_bytes{0};
+    std::atomic<std::size_t> thp_bytes{0};   // MADV_HUGEPAGE advised (kernel may still split)
+};
+
+inline ArenaMemoryStats& arenaMemoryStats() noexcept {
+    static ArenaMemoryStats stats;
+    return stats;
+}
+
+/// Owning, move-only block of arena memory (uninitialized bytes).
+class ArenaBuffer {
+public:
+    enum class Backing : std::uint8_t { None, Heap, HugeTlb, Transparent };
+
+    ArenaBuffer() = default;
+
+    ArenaBuffer(std::size_t bytes, std::size_t align) { allocate(bytes, align); }
+
+    ArenaBuffer(ArenaBuffer&& o) noexcept { *this = std::move(o); }
+    ArenaBuffer& operator=(ArenaBuffer&& o) noexcept {
+        if (this != &o) {
+            release();
+            std::swap(data_, o.data_);
+            std::swap(bytes_, o.bytes_);
+            std::swap(align_, o.align_);
+            std::swap(backing_, o.backing_);
+        }
+        return *this;
+    }
+    ArenaBuffer(const ArenaBuffer&) = delete;
+    ArenaBuffer& operator=(const ArenaBuffer&) = delete;
+
+    ~ArenaBuffer() { release(); }
+
+    void* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return bytes_; } // usable bytes (>= requested)
+    Backing backing() const noexcept { return backing_; }
+    explicit operator bool() const noexcept { return data_ != nullptr; }
+
+private:
+    void allocate(std::size_t bytes, std::size_t align) {
+        if (bytes == 0) return;
+        align_ = align < alignof(std::max_align_t) ? alignof(std::max_align_t) : align;
+#if defined(__linux__)
+        if (arenaMemoryPolicy().huge_pages && bytes >= kHugePageBytes / 2 && align_ <= kHugePageBytes) {
+            const std::size_t rounded = (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+            if (mapHuge(rounded)) return;
+        }
+#endif
+        data_ = ::operator new(bytes, std::align_val_t{align_});
+        bytes_ = bytes;
+        backing_ = Backing::Heap;
+        arenaMemoryStats().heap_bytes.fetch_add(bytes_, std::memory_order_relaxed);
+    }
+
+#if defined(__linux__)
+    bool mapHuge(std::size_t bytes) noexcept {
+#if defined(MAP_HUGETLB)
+        void* explicit_huge = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (explicit_huge != MAP_FAILED) {
+            take(explicit_huge, bytes, Backing::HugeTlb);
+            return true;
+        }
+#endif
+#if defined(MADV_HUGEPAGE)
+        // Over-map by one huge page, trim to a 2MB-aligned window, then advise
+        void* raw = ::mmap(nullptr, bytes + kHugePageBytes, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) return false;
+        const auto base = reinterpret_cast<std::uintptr_t>(raw);
+        const std::uintptr_t aligned = (base + kHugePageBytes - 1) & ~(kHugePageBytes - 1);
+        if (aligned > base) ::munmap(raw, aligned - base);
+        const std::size_t tail = (base + bytes + kHugePageBytes) - (aligned + bytes);
+        if (tail) ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+        void* p = reinterpret_cast<void*>(aligned);
+        ::madvise(p, bytes, MADV_HUGEPAGE);
+        take(p, bytes, Backing::Transparent);
+        return true;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    void take(void* p, std::size_t bytes, Backing b) noexcept {
+        data_ = p;
+        bytes_ = bytes;
+        backing_ = b;
+        auto& s = arenaMemoryStats();
+        (b == Backing::HugeTlb ? s.hugetlb_bytes : s.thp_bytes).fetch_add(bytes, std::memory_order_relaxed);
+    }
+#endif
+
+    void release() noexcept {
+        if (!data_) return;
+        auto& s = arenaMemoryStats();
+        switch (backing_) {
+        case Backing::Heap:
+            ::operator delete(data_, std::align_val_t{align_});
+            s.heap_bytes.fetch_sub(bytes_, std::memory_order_relaxed);
+            break;
+#if defined(__linux__)
+        case Backing::HugeTlb:
+            ::munmap(data_, bytes_);
+            s.hugetlb_bytes.fetch_sub(bytes_, std::memory_order_relaxed);
+            break;
+        case Backing::Transparent:
+            ::munmap(data_, bytes_);
+            s.thp_bytes.fetch_sub(bytes_, std::memory_order_relaxed);
+            break;
+#endif
+        default:
+            break;
+        }
+        data_ = nullptr;
+        bytes_ = 0;
+        backing_ = Backing::None;
+    }
+
+    void* data_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::size_t align_ = alignof(std::max_align_t);
+    Backing backing_ = Backing::None;
+};
@@ -0,0 +1,154 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "SpscRing.hpp"
+#include "ThreadAffinity.hpp"
+#include "TradeLogger.hpp"
+
+/// What push() does when the ring is full.
+enum class Backpressure : unsigned char {
+    Block, // wait for space, yielding the CPU between attempts
+    Spin,  // wait for space, busy-spinning (lowest handoff latency, burns a core)
+    Drop   // discard the trade and count it
+};
+
+/// Counters exposed by AsyncTradeLogger::stats().
+struct LoggerStats {
+    std::uint64_t pushed     = 0; // accepted into the ring
+    std::uint64_t written    = 0; // formatted to the file by the writer thread
+    std::uint64_t dropped    = 0; // discarded under Backpressure::Drop
+    std::uint64_t stalls     = 0; // pushes that found the ring full (Block/Spin)
+    std::uint64_t high_water = 0; // max ring occupancy observed after a push
+};
+
+/// Asynchronous CSV trade logger.
+/// - push() only copies the POD trade into an SPSC ring: no formatting, no I/O
+///   on the matching thread
+/// - A dedicated writer thread (optionally pinned to a core) drains the ring in
+///   batches and formats rows with the same layout as TradeLogger
+/// - Single producer: call push()/append()/flush() from one thread only
+template <typename TradeT>
+class AsyncTradeLogger {
+public:
+    explicit AsyncTradeLogger(std::string path,
+                              std::size_t ring_capacity = 1 << 16,
+                              Backpressure policy = Backpressure::Block,
+                              int writer_cpu = -1)
+        : path_(std::move(path)), policy_(policy), writer_cpu_(writer_cpu), ring_(ring_capacity) {
+        file_.open(path_, std::ios::out | std::ios::trunc);
+        writeTradeCsvHeader(file_);
+        writer_ = std::thread([this] { run(); });
+    }
+
+    AsyncTradeLogger(const AsyncTradeLogger&) = delete;
+    AsyncTradeLogger& operator=(const AsyncTradeLogger&) = delete;
+
+    ~AsyncTradeLogger() {
+        stop_.store(true, std::memory_order_release);
+        writer_.join(); // writer drains everything left before exiting
+        file_.close();
+    }
+
+    void push(const TradeT& t) {
+        if (!ring_.try_push(t)) {
+            if (policy_ == Backpressure::Drop) {
+                bump(dropped_);
+                return;
+            }
+            bump(stalls_);
+            while (!ring_.try_push(t)) {
+                if (policy_ == Backpressure::Block) std::this_thread::yield();
+                else                                cpu_relax();
+            }
+        }
+        bump(pushed_);
+        // The cached occupancy only over-estimates, so the shared consumer index
+        // is re-read only when it suggests a new peak
+        const std::uint64_t hw = high_water_.load(std::memory_order_relaxed);
+        if (ring_.producer_size() > hw) {
+            const auto occ = static_cast<std::uint64_t>(ring_.producer_refresh());
+            if (occ > hw) high_water_.store(occ, std::memory_order_relaxed);
+        }
+    }
+
+    // Lets the logger be passed straight to MatchingEngine::submit as a trade sink
+    void operator()(const TradeT& t) { push(t); }
+
+    void append(const std::vector<TradeT>& trades) {
+        for (const auto& t : trades) push(t);
+    }
+
+    // Block until every accepted trade is written and the file is flushed
+    void flush() {
+        const std::uint64_t target = pushed_.load(std::memory_order_relaxed);
+        while (written_.load(std::memory_order_acquire) < target) std::this_thread::yield();
+        const std::uint64_t req = flush_req_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        while (flush_ack_.load(std::memory_order_acquire) < req) std::this_thread::yield();
+    }
+
+    LoggerStats stats() const noexcept {
+        LoggerStats s;
+        s.pushed     = pushed_.load(std::memory_order_relaxed);
+        s.written    = written_.load(std::memory_order_relaxed);
+        s.dropped    = dropped_.load(std::memory_order_relaxed);
+        s.stalls     = stalls_.load(std::memory_order_relaxed);
+        s.high_water = high_water_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    std::size_t ring_capacity() const noexcept { return ring_.capacity(); }
+
+private:
+    static constexpr std::size_t kDrainBatch = 1024;
+
+    // Producer-owned counters: single writer, so a plain load+store is enough
+    static void bump(std::atomic<std::uint64_t>& c) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void run() {
+        if (writer_cpu_ >= 0) pin_current_thread(writer_cpu_);
+        while (true) {
+            const std::size_t n = ring_.consume(
+                [this](const TradeT& t) { writeTradeCsvRow(file_, t); }, kDrainBatch);
+            if (n > 0) {
+                written_.fetch_add(n, std::memory_order_release);
+                continue;
+            }
+            // Ring empty: service flush requests, then exit or idle
+            const std::uint64_t req = flush_req_.load(std::memory_order_acquire);
+            if (flush_ack_.load(std::memory_order_relaxed) != req) {
+                file_.flush();
+                flush_ack_.store(req, std::memory_order_release);
+            }
+            if (stop_.load(std::memory_order_acquire) && ring_.empty()) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        file_.flush();
+    }
+
+    std::string path_;
+    Backpressure policy_;
+    int writer_cpu_;
+    std::ofstream file_; // touched only by the writer thread after construction
+    SpscRing<TradeT> ring_;
+
+    // Producer-written
+    alignas(64) std::atomic<std::uint64_t> pushed_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> stalls_{0};
+    std::atomic<std::uint64_t> high_water_{0};
+    std::atomic<std::uint64_t> flush_req_{0};
+    // Writer-written
+    alignas(64) std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> flush_ack_{0};
+    std::atomic<bool> stop_{false};
+
+    std::thread writer_; // last: starts after everything above is constructed
+};
@@ -0,0 +1,358 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+#include "PerfCounters.hpp"
+#include "ThreadAffinity.hpp"
+#include "TscClock.hpp"
+
+// Keeps `value` (and everything it depends on) alive without a volatile store
+// per iteration: an empty asm the optimizer must assume reads it.
+template <typename T>
+inline void benchKeep(const T& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    volatile auto* sink = &value;
+    (void)sink;
+#endif
+}
+
+/// What one repetition of a case measured.
+struct BenchSample {
+    double        ns = 0.0;     // time inside measure()
+    std::uint64_t ops = 0;      // operations inside measure()
+    double        p99_ns = -1;  // per-op p99 when the case records latencies
+    PerfSample    pmu{};
+};
+
+/// Passed to a case once per repetition. Setup runs outside measure(); only
+/// the body handed to measure() is timed and counted.
+class BenchState {
+public:
+    template <typename F>
+    void measure(std::uint64_t ops, F&& body) {
+        pmu_.start();
+        const std::uint64_t t0 = TscClock::start();
+        body();
+        const std::uint64_t t1 = TscClock::stop();
+        sample_.pmu = pmu_.stop();
+        sample_.ns += TscClock::toNs(t1 - t0);
+        sample_.ops += ops;
+    }
+
+    // Optional per-op latencies (ns); the runner reports their p99
+    LatencyHistogram& latencies() noexcept { return latencies_; }
+
+    BenchSample finish() {
+        if (!latencies_.empty()) sample_.p99_ns = static_cast<double>(latencies_.percentile(0.99));
+        return sample_;
+    }
+
+private:
+    PerfCounters& pmu_ = perfCounters();
+    BenchSample sample_;
+    LatencyHistogram latencies_;
+
+    static PerfCounters& perfCounters() {
+        static PerfCounters pmu; // opened once per process
+        return pmu;
+    }
+};
+
+using BenchFn = std::function<void(BenchState&)>;
+
+struct BenchCase {
+    std::string name;  // "group/case"
+    BenchFn fn;
+};
+
+/// Cases in registration order; each translation unit adds its own.
+class BenchRegistry {
+public:
+    void add(std::string name, BenchFn fn) { cases_.push_back(BenchCase{std::move(name), std::move(fn)}); }
+    const std::vector<BenchCase>& cases() const noexcept { return cases_; }
+
+private:
+    std::vector<BenchCase> cases_;
+};
+
+/// Per-case summary across repetitions (ns per op unless noted).
+struct BenchStats {
+    std::string name;
+    int reps = 0;
+    std::uint64_t ops = 0;   // per repetition
+    double median = 0.0;
+    double mad = 0.0;        // median absolute deviation
+    double ci_low = 0.0;     // ~95% distribution-free CI for the median
+    double ci_high = 0.0;
+    double min = 0.0;
+    double p99_ns = -1.0;    // median of per-rep p99, -1 if not recorded
+    double cycles_per_op = -1.0;
+    double instructions_per_op = -1.0;
+    double branch_misses_per_op = -1.0;
+};
+
+namespace bench_detail {
+
+inline double medianOf(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const std::size_t n = v.size();
+    return (n % 2) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// Order-statistic CI for the median: ranks n/2 -+ 0.98 sqrt(n) of the
+// sorted sample (binomial(n, 1/2) normal approximation, ~95%)
+inline void medianCi(std::vector<double> v, double& lo, double& hi) {
+    std::sort(v.begin(), v.end());
+    const double n = static_cast<double>(v.size());
+    const double half = 0.98 * std::sqrt(n);
+    const long j = static_cast<long>(std::floor(n / 2.0 - half));
+    const long k = static_cast<long>(std::ceil(n / 2.0 + half));
+    lo = v[static_cast<std::size_t>(std::max(0L, std::min(j, static_cast<long>(v.size()) - 1)))];
+    hi = v[static_cast<std::size_t>(std::max(0L, std::min(k, static_cast<long>(v.size()) - 1)))];
+}
+
+// Value of "key": <number> on a line of the runner's own JSON, or -1
+inline double jsonNumber(const std::string& line, const std::string& key) {
+    const std::string tag = "\"" + key + "\": ";
+    const auto pos = line.find(tag);
+    if (pos == std::string::npos) return -1.0;
+    return std::strtod(line.c_str() + pos + tag.size(), nullptr);
+}
+
+inline std::string jsonString(const std::string& line, const std::string& key) {
+    const std::string tag = "\"" + key + "\": \"";
+    const auto pos = line.find(tag);
+    if (pos == std::string::npos) return {};
+    const auto start = pos + tag.size();
+    return line.substr(start, line.find('"', start) - start);
+}
+
+} // namespace bench_detail
+
+inline BenchStats summarize(const std::string& name, const std::vector<BenchSample>& samples) {
+    BenchStats s;
+    s.name = name;
+    s.reps = static_cast<int>(samples.size());
+    if (samples.empty()) return s;
+
+    std::vector<double> per_op, p99s, cyc, ins, brm;
+    for (const BenchSample& r : samples) {
+        const double ops = static_cast<double>(r.ops ? r.ops : 1);
+        per_op.push_back(r.ns / ops);
+        if (r.p99_ns >= 0) p99s.push_back(r.p99_ns);
+        if (r.pmu.has(PerfEvent::Cycles))       cyc.push_back(r.pmu.perOp(PerfEvent::Cycles, ops));
+        if (r.pmu.has(PerfEvent::Instructions)) ins.push_back(r.pmu.perOp(PerfEvent::Instructions, ops));
+        if (r.pmu.has(PerfEvent::BranchMisses)) brm.push_back(r.pmu.perOp(PerfEvent::BranchMisses, ops));
+    }
+    s.ops = samples.front().ops;
+    s.median = bench_detail::medianOf(per_op);
+    std::vector<double> dev;
+    for (double x : per_op) dev.push_back(std::fabs(x - s.median));
+    s.mad = bench_detail::medianOf(dev);
+    bench_detail::medianCi(per_op, s.ci_low, s.ci_high);
+    s.min = *std::min_element(per_op.begin(), per_op.end());
+    if (!p99s.empty()) s.p99_ns = bench_detail::medianOf(p99s);
+    if (!cyc.empty()) s.cycles_per_op = bench_detail::medianOf(cyc);
+    if (!ins.empty()) s.instructions_per_op = bench_detail::medianOf(ins);
+    if (!brm.empty()) s.branch_misses_per_op = bench_detail::medianOf(brm);
+    return s;
+}
+
+// --- Results files -------------------------------------------------------------
+// JSON keeps one result object per line so baselines diff cleanly and the
+// runner can read its own files back without a JSON library.
+
+inline void writeBenchJson(const std::string& path, const std::vector<BenchStats>& results) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("bench: cannot write " + path);
+    char line[512];
+    out << "{\n  \"suite\": \"hft_bench\",\n  \"timer\": \"" << TscClock::source() << "\",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchStats& r = results[i];
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"reps\": %d, \"ops\": %llu, \"ns_per_op\": %.4f, "
+                      "\"mad\": %.4f, \"ci_low\": %.4f, \"ci_high\": %.4f, \"min\": %.4f, \"p99_ns\": %.1f, "
+                      "\"cycles_per_op\": %.4f, \"instructions_per_op\": %.4f, \"branch_misses_per_op\": %.6f}%s\n",
+                      r.name.c_str(), r.reps, static_cast<unsigned long long>(r.ops), r.median, r.mad,
+                      r.ci_low, r.ci_high, r.min, r.p99_ns, r.cycles_per_op, r.instructions_per_op,
+                      r.branch_misses_per_op, i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+}
+
+inline void writeBenchCsv(const std::string& path, const std::vector<BenchStats>& results) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("bench: cannot write " + path);
+    out << "name,reps,ops,ns_per_op,mad,ci_low,ci_high,min,p99_ns,cycles_per_op,instructions_per_op,branch_misses_per_op\n";
+    for (const BenchStats& r : results) {
+        out << r.name << ',' << r.reps << ',' << r.ops << ',' << r.median << ',' << r.mad << ','
+            << r.ci_low << ',' << r.ci_high << ',' << r.min << ',' << r.p99_ns << ','
+            << r.cycles_per_op << ',' << r.instructions_per_op << ',' << r.branch_misses_per_op << '\n';
+    }
+}
+
+// Reads a file written by writeBenchJson (ns_per_op, p99_ns, ci bounds)
+inline std::vector<BenchStats> readBenchJson(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("bench: cannot read baseline " + path);
+    std::vector<BenchStats> results;
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::string name = bench_detail::jsonString(line, "name");
+        if (name.empty()) continue;
+        BenchStats r;
+        r.name = name;
+        r.median = bench_detail::jsonNumber(line, "ns_per_op");
+        r.ci_low = bench_detail::jsonNumber(line, "ci_low");
+        r.ci_high = bench_detail::jsonNumber(line, "ci_high");
+        r.p99_ns = bench_detail::jsonNumber(line, "p99_ns");
+        results.push_back(r);
+    }
+    return results;
+}
+
+// --- Baseline comparison -------------------------------------------------------
+
+struct BenchRegression {
+    std::string name;
+    std::string metric;   // "ns_per_op" or "p99_ns"
+    double baseline = 0.0;
+    double current = 0.0;
+    double change() const { return baseline > 0 ? current / baseline - 1.0 : 0.0; }
+};
+
+/// A case regresses when its median ns/op or p99 exceeds the baseline by more
+/// than `threshold` (0.10 = 10%) and the ns/op CIs don't overlap, so plain
+/// run-to-run noise on a busy box doesn't fail the build.
+inline std::vector<BenchRegression> compareToBaseline(const std::vector<BenchStats>& current,
+                                                      const std::vector<BenchStats>& baseline,
+                                                      double threshold) {
+    std::vector<BenchRegression> out;
+    for (const BenchStats& c : current) {
+        auto it = std::find_if(baseline.begin(), baseline.end(),
+                               [&](const BenchStats& b) { return b.name == c.name; });
+        if (it == baseline.end()) continue; // new case: nothing to compare yet
+        const BenchStats& b = *it;
+        if (b.median > 0 && c.median > b.median * (1.0 + threshold) && c.ci_low > b.ci_high)
+            out.push_back(BenchRegression{c.name, "ns_per_op", b.median, c.median});
+        if (b.p99_ns > 0 && c.p99_ns > b.p99_ns * (1.0 + threshold))
+            out.push_back(BenchRegression{c.name, "p99_ns", b.p99_ns, c.p99_ns});
+    }
+    return out;
+}
+
+// --- Runner --------------------------------------------------------------------------
+
+struct BenchOptions {
+    int warmup = 2;              // unrecorded repetitions per case
+    int reps = 15;               // recorded repetitions per case
+    int cpu = -1;                // pin the runner thread (-1: no pinning)
+    std::string filter;          // run cases whose name contains this
+    std::string json_path;       // write results as JSON
+    std::string csv_path;        // write results as CSV
+    std::string baseline_path;   // compare against this JSON
+    double threshold = 0.10;     // allowed slowdown vs baseline
+    bool list = false;           // print case names and exit
+};
+
+inline void printBenchUsage(const char* argv0) {
+    std::cerr << "usage: " << argv0
+              << " [--warmup N] [--reps N] [--cpu N] [--filter STR] [--json FILE] [--csv FILE]\n"
+                 "       [--baseline FILE] [--threshold FRACTION] [--list]\n";
+}
+
+// Returns false (after printing usage) on a bad command line
+inline bool parseBenchArgs(int argc, char** argv, BenchOptions& opt) {
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        const bool has_value = a + 1 < argc;
+        if (arg == "--warmup" && has_value)         opt.warmup = std::atoi(argv[++a]);
+        else if (arg == "--reps" && has_value)      opt.reps = std::max(1, std::atoi(argv[++a]));
+        else if (arg == "--cpu" && has_value)       opt.cpu = std::atoi(argv[++a]);
+        else if (arg == "--filter" && has_value)    opt.filter = argv[++a];
+        else if (arg == "--json" && has_value)      opt.json_path = argv[++a];
+        else if (arg == "--csv" && has_value)       opt.csv_path = argv[++a];
+        else if (arg == "--baseline" && has_value)  opt.baseline_path = argv[++a];
+        else if (arg == "--threshold" && has_value) opt.threshold = std::atof(argv[++a]);
+        else if (arg == "--list")                   opt.list = true;
+        else {
+            printBenchUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Runs every selected case (warmup, then reps, each through a fresh
+/// BenchState), prints one summary line per case, writes the requested
+/// files and checks the baseline. Returns the process exit code: 0, or 1
+/// with a regression report.
+inline int runBenchSuite(const BenchRegistry& registry, const BenchOptions& opt) {
+    if (opt.list) {
+        for (const BenchCase& c : registry.cases()) std::cout << c.name << "\n";
+        return 0;
+    }
+
+    TscClock::calibrate();
+    if (opt.cpu >= 0 && !pin_current_thread(opt.cpu))
+        std::cerr << "bench: could not pin to cpu " << opt.cpu << ", running unpinned\n";
+    {
+        PerfCounters probe;
+        PerfCounters::printInfo(std::cout, probe);
+    }
+    std::printf("Timer: %s, warmup=%d reps=%d cpu=%d\n\n", TscClock::source(), opt.warmup, opt.reps, opt.cpu);
+    std::printf("%-34s %10s %8s %21s %10s %9s\n", "case", "ns/op", "MAD", "95% CI", "p99 ns", "cyc/op");
+
+    std::vector<BenchStats> results;
+    for (const BenchCase& c : registry.cases()) {
+        if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+        for (int w = 0; w < opt.warmup; ++w) {
+            BenchState st;
+            c.fn(st);
+        }
+        std::vector<BenchSample> samples;
+        samples.reserve(static_cast<std::size_t>(opt.reps));
+        for (int r = 0; r < opt.reps; ++r) {
+            BenchState st;
+            c.fn(st);
+            samples.push_back(st.finish());
+        }
+        const BenchStats s = summarize(c.name, samples);
+        char p99[16] = "-", cyc[16] = "n/a";
+        if (s.p99_ns >= 0) std::snprintf(p99, sizeof(p99), "%.0f", s.p99_ns);
+        if (s.cycles_per_op >= 0) std::snprintf(cyc, sizeof(cyc), "%.2f", s.cycles_per_op);
+        std::printf("%-34s %10.3f %8.3f [%9.3f,%9.3f] %10s %9s\n",
+                    s.name.c_str(), s.median, s.mad, s.ci_low, s.ci_high, p99, cyc);
+        std::fflush(stdout);
+        results.push_back(s);
+    }
+
+    if (!opt.json_path.empty()) writeBenchJson(opt.json_path, results);
+    if (!opt.csv_path.empty()) writeBenchCsv(opt.csv_path, results);
+    if (opt.baseline_path.empty()) return 0;
+
+    const auto regressions = compareToBaseline(results, readBenchJson(opt.baseline_path), opt.threshold);
+    if (regressions.empty()) {
+        std::printf("\nNo regressions vs %s (threshold %.0f%%)\n", opt.baseline_path.c_str(), opt.threshold * 100);
+        return 0;
+    }
+    std::printf("\nREGRESSIONS vs %s (threshold %.0f%%):\n", opt.baseline_path.c_str(), opt.threshold * 100);
+    for (const BenchRegression& r : regressions)
+        std::printf("  %-34s %-10s %12.3f -> %12.3f  (%+.1f%%)\n",
+                    r.name.c_str(), r.metric.c_str(), r.baseline, r.current, r.change() * 100);
+    return 1;
+}
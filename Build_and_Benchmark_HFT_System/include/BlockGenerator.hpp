@@ -0,0 +1,41 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "XorShift32.hpp"
+
+// -----------------------------------------------------------------------------
+// Parallel, deterministic block generation
+// -----------------------------------------------------------------------------
+// A generated sequence is cut into fixed-size blocks; block b draws only from
+// XorShift32::stream(seed, b) and writes only its own output range. Which
+// thread fills which block is then irrelevant: the same seed gives the same
+// bytes for 1 thread or 64, and no generator state is shared between workers.
+// -----------------------------------------------------------------------------
+
+/// 0 -> one worker per hardware thread; never less than 1.
+inline unsigned resolveGeneratorThreads(unsigned threads) noexcept {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    return threads ? threads : 1;
+}
+
+/// fn(block) for every block in [0, blocks), spread over `threads` workers
+/// (the calling thread is one of them). Blocks are claimed from a shared
+/// counter, so uneven blocks balance out. Returns once every block is done.
+template <typename Fn>
+void runBlocks(std::size_t blocks, unsigned threads, Fn&& fn) {
+    const unsigned workers = static_cast<unsigned>(
+        std::min<std::size_t>(resolveGeneratorThreads(threads), blocks ? blocks : 1));
+    std::atomic<std::size_t> next{0};
+    auto work = [&] {
+        for (std::size_t b; (b = next.fetch_add(1, std::memory_order_relaxed)) < blocks;) fn(b);
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; ++w) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+}
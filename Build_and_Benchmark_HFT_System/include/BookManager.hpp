@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MatchingEngine.hpp"
+#include "OrderBook.hpp"
+#include "PooledOrderManager.hpp"
+#include "SymbolTable.hpp"
+
+/// Book, OMS and engine for one instrument. Heap-allocated on its own and
+/// cache-line aligned, so two instruments never share a line.
+template <typename PriceType, typename OrderIdType>
+struct alignas(64) InstrumentBook {
+    using Book   = OrderBook<PriceType, OrderIdType>;
+    using OMS    = PooledOrderManager<PriceType, OrderIdType>;
+    using Engine = MatchingEngine<PriceType, OrderIdType>;
+
+    explicit InstrumentBook(std::string sym) : symbol(std::move(sym)), engine(book, oms) {}
+
+    InstrumentBook(const InstrumentBook&) = delete; // engine holds references to book/oms
+    InstrumentBook& operator=(const InstrumentBook&) = delete;
+
+    void reserve(std::size_t maxOrders, std::size_t maxLevels) {
+        oms.reserve(maxOrders);
+        book.reserveLevels(maxLevels);
+        engine.reserveLevels(maxLevels);
+    }
+
+    std::string symbol;
+    Book   book;
+    OMS    oms;
+    Engine engine;
+};
+
+/// One book/OMS/engine per instrument, addressed by a dense instrument id.
+/// - addInstrument() interns a symbol once at startup and returns its id; ids
+///   are dense and in registration order, so registering a feed's SymbolTable
+///   in id order makes MarketData::symbol_id the instrument id
+/// - The hot path indexes a vector by id; findInstrument(symbol) is a hash
+///   lookup meant for setup/decoding, not per order
+/// - Single-threaded: ShardedEngine gives each worker thread its own manager
+template <typename PriceType, typename OrderIdType>
+class BookManager {
+public:
+    using Instrument = InstrumentBook<PriceType, OrderIdType>;
+    using OrderT     = Order<PriceType, OrderIdType>;
+    using TradeT     = Trade<PriceType, OrderIdType>;
+
+    static constexpr std::uint32_t npos = SymbolTable::npos;
+
+    BookManager() = default;
+    BookManager(const BookManager&) = delete;
+    BookManager& operator=(const BookManager&) = delete;
+
+    // Register a symbol (idempotent); reserves its book for maxOrders live
+    // orders over maxLevels price levels per side (0: maxOrders, the most
+    // levels that many orders can open)
+    std::uint32_t addInstrument(const std::string& symbol, std::size_t maxOrders = 0,
+                                std::size_t maxLevels = 0) {
+        const std::uint32_t id = symbols_.intern(symbol);
+        if (id < instruments_.size()) return id;
+        instruments_.push_back(std::make_unique<Instrument>(symbol));
+        if (maxOrders) instruments_.back()->reserve(maxOrders, maxLevels ? maxLevels : maxOrders);
+        return id;
+    }
+
+    std::uint32_t findInstrument(const std::string& symbol) const { return symbols_.find(symbol); }
+    const SymbolTable& symbols() const noexcept { return symbols_; }
+
+    // --- Order entry, routed by instrument id --------------------------------
+    template <typename Sink>
+    std::size_t submit(std::uint32_t instrument, const OrderT& o, Sink&& sink) {
+        return instruments_[instrument]->engine.submit(o, sink);
+    }
+
+    bool cancel(std::uint32_t instrument, OrderIdType id) {
+        return instruments_[instrument]->engine.cancel(id);
+    }
+
+    template <typename Sink>
+    std::size_t replacePrice(std::uint32_t instrument, OrderIdType id, PriceType px, Sink&& sink) {
+        return instruments_[instrument]->engine.replacePrice(id, px, sink);
+    }
+
+    // --- Access ---------------------------------------------------------------
+    Instrument& instrument(std::uint32_t id) noexcept { return *instruments_[id]; }
+    const Instrument& instrument(std::uint32_t id) const noexcept { return *instruments_[id]; }
+    std::size_t size() const noexcept { return instruments_.size(); }
+
+private:
+    std::vector<std::unique_ptr<Instrument>> instruments_;
+    SymbolTable symbols_;
+};
@@ -0,0 +1,278 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "MappedFile.hpp"
+#include "MatchingEngine.hpp"
+#include "OrderJournal.hpp"
+#include "TradeJournal.hpp" // JournalPriceKind
+
+// --- On-disk format ---------------------------------------------------------
+// [SnapshotHeader][SnapshotLevel<P> x levels][SnapshotOrder<P> x orders]
+// Little-endian, host layout (sizes recorded in the header). Levels are
+// stored bids then asks, each side best first; the first `resting` orders
+// are the levels' FIFOs back to back in that same order, followed by the
+// OMS records that are no longer in the book (filled/canceled, unreleased).
+// checksum covers everything after the header.
+
+constexpr char          kSnapshotMagic[8] = {'H', 'F', 'T', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t kSnapshotVersion  = 1;
+
+struct SnapshotHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;    // offset of the first level
+    std::uint32_t level_size;     // sizeof(SnapshotLevel<P>)
+    std::uint32_t order_size;     // sizeof(SnapshotOrder<P>)
+    std::uint8_t  price_width;
+    std::uint8_t  price_kind;     // JournalPriceKind
+    std::uint8_t  reserved[6];
+    std::uint64_t journal_offset; // order-journal records already applied
+    std::uint64_t levels;
+    std::uint64_t orders;
+    std::uint64_t checksum;
+};
+static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader must stay 64 bytes");
+
+template <typename PriceType>
+struct SnapshotLevel {
+    PriceType     price;
+    std::int32_t  total_qty;
+    std::int32_t  order_count;   // its orders follow the previous level's
+    std::uint8_t  is_buy;
+    std::uint8_t  pad[3];
+};
+
+template <typename PriceType>
+struct SnapshotOrder {
+    std::int64_t  id;
+    PriceType     price;
+    std::int32_t  quantity;      // remaining
+    std::uint8_t  is_buy;
+    std::uint8_t  state;         // OrderState
+    std::uint8_t  pad[2];
+};
+
+// Word-at-a-time multiplicative hash: ~1 ns per 8 bytes, enough to catch a
+// truncated or torn image (not an integrity MAC)
+inline std::uint64_t snapshotChecksum(const void* data, std::size_t bytes) noexcept {
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    std::size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p + i, sizeof(w));
+        h = (h ^ w) * 0x100000001b3ull;
+        h ^= h >> 29;
+    }
+    for (; i < bytes; ++i) h = (h ^ p[i]) * 0x100000001b3ull;
+    return h;
+}
+
+/// Serialize an engine's full state: every resting order in price-time
+/// order, the level aggregates and all unreleased OMS records. Call it on
+/// the engine's thread between commands, with the order-journal offset of
+/// the last applied command. Records are written straight into a mapping of
+/// path + ".tmp" (no in-memory copy of the body), which is then renamed, so a
+/// crash mid-write never leaves a partial image under `path`.
+template <typename PriceType, typename OrderIdType, typename BookT, typename OmsT>
+void writeEngineSnapshot(const std::string& path, const MatchingEngine<PriceType, OrderIdType, BookT, OmsT>& engine,
+                         const OmsT& oms, std::uint64_t journal_offset) {
+    using LevelRec = SnapshotLevel<PriceType>;
+    using OrderRec = SnapshotOrder<PriceType>;
+    using RecordT  = typename OmsT::RecordT;
+
+    // Exact level count and an upper bound on orders (every record written
+    // is an unreleased OMS record), so the file is sized once up front
+    const std::size_t level_count = engine.levelCount();
+    const std::size_t order_bound = oms.size();
+    const std::size_t orders_at   = sizeof(SnapshotHeader) + level_count * sizeof(LevelRec);
+
+    const std::string tmp = path + ".tmp";
+    MappedFileWriter file(tmp, orders_at + order_bound * sizeof(OrderRec), "writeEngineSnapshot");
+    auto* const level_out = reinterpret_cast<LevelRec*>(file.data() + sizeof(SnapshotHeader));
+    auto* const order_out = reinterpret_cast<OrderRec*>(file.data() + orders_at);
+    std::size_t levels = 0, orders = 0;
+
+    auto add = [&](const RecordT& r) {
+        if (orders == order_bound)
+            throw std::runtime_error("writeEngineSnapshot: book holds orders the OMS doesn't");
+        OrderRec o{};
+        o.id       = static_cast<std::int64_t>(r.order.id);
+        o.price    = r.order.price;
+        o.quantity = r.order.quantity;
+        o.is_buy   = r.order.is_buy ? 1 : 0;
+        o.state    = static_cast<std::uint8_t>(r.state);
+        order_out[orders++] = o;
+    };
+    engine.forEachLevel([&](bool is_buy, PriceType px, const RecordT* head) {
+        LevelRec l{};
+        l.price  = px;
+        l.is_buy = is_buy ? 1 : 0;
+        for (const RecordT* r = head; r; r = r->next) {
+            l.total_qty += r->order.quantity;
+            ++l.order_count;
+            add(*r);
+        }
+        level_out[levels++] = l;
+    });
+    oms.store().forEach([&](const RecordT& r) {
+        if (!r.in_book) add(r);
+    });
+
+    SnapshotHeader h{};
+    std::memcpy(h.magic, kSnapshotMagic, sizeof(h.magic));
+    h.version        = kSnapshotVersion;
+    h.header_size    = sizeof(SnapshotHeader);
+    h.level_size     = sizeof(LevelRec);
+    h.order_size     = sizeof(OrderRec);
+    h.price_width    = sizeof(PriceType);
+    h.price_kind     = static_cast<std::uint8_t>(journalPriceKind<PriceType>());
+    h.journal_offset = journal_offset;
+    h.levels         = levels;
+    h.orders         = orders;
+    // The two sections are contiguous in the file: checksum them as one stream
+    const std::size_t used = orders_at + orders * sizeof(OrderRec);
+    h.checksum = snapshotChecksum(file.data() + sizeof(SnapshotHeader), used - sizeof(SnapshotHeader));
+    std::memcpy(file.data(), &h, sizeof(h));
+
+    if (!file.finish(used) || std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("writeEngineSnapshot: cannot write " + path);
+}
+
+/// Read-only mapping of a snapshot; validates header, sizes and checksum.
+template <typename PriceType>
+class MappedEngineSnapshot {
+public:
+    using LevelRec = SnapshotLevel<PriceType>;
+    using OrderRec = SnapshotOrder<PriceType>;
+
+    explicit MappedEngineSnapshot(const std::string& path)
+        : file_(path, sizeof(SnapshotHeader), "MappedEngineSnapshot", "snapshot", MapAccess::Preload) {
+        const SnapshotHeader& h = header();
+        // Each count is checked against the bytes left after the section
+        // before it, so no product of header fields can wrap
+        const bool ok = std::memcmp(h.magic, kSnapshotMagic, sizeof(h.magic)) == 0
+                     && h.version == kSnapshotVersion
+                     && h.header_size == sizeof(SnapshotHeader)
+                     && h.level_size == sizeof(LevelRec)
+                     && h.order_size == sizeof(OrderRec)
+                     && h.price_width == sizeof(PriceType)
+                     && h.price_kind == static_cast<std::uint8_t>(journalPriceKind<PriceType>())
+                     && file_.fits(h.header_size, h.levels, sizeof(LevelRec))
+                     && file_.fits(ordersAt(), h.orders, sizeof(OrderRec))
+                     && ordersAt() + h.orders * sizeof(OrderRec) == file_.size()
+                     && snapshotChecksum(file_.data() + h.header_size, file_.size() - h.header_size) == h.checksum;
+        if (!ok) throw std::runtime_error("MappedEngineSnapshot: bad header, size or checksum in " + path);
+    }
+
+    const SnapshotHeader& header() const noexcept {
+        return *reinterpret_cast<const SnapshotHeader*>(file_.data());
+    }
+    std::uint64_t journalOffset() const noexcept { return header().journal_offset; }
+
+    const LevelRec* levels() const noexcept {
+        return reinterpret_cast<const LevelRec*>(file_.data() + header().header_size);
+    }
+    std::size_t levelCount() const noexcept { return static_cast<std::size_t>(header().levels); }
+
+    const OrderRec* orders() const noexcept { return reinterpret_cast<const OrderRec*>(levels() + levelCount()); }
+    std::size_t orderCount() const noexcept { return static_cast<std::size_t>(header().orders); }
+
+private:
+    // Offset of the order section; only valid once the level count fits the file
+    std::uint64_t ordersAt() const noexcept {
+        return header().header_size + header().levels * sizeof(LevelRec);
+    }
+
+    MappedFileReader file_;
+};
+
+/// Rebuild empty book/OMS/engine from a snapshot in one linear pass: one book
+/// level per stored level (aggregates taken as stored), each order recreated
+/// in the OMS and appended to its engine level in FIFO order, no matching.
+/// Reserve book/OMS/engine for the expected live load first, as for live use.
+/// Returns the snapshot's journal offset.
+template <typename PriceType, typename OrderIdType, typename BookT, typename OmsT>
+std::uint64_t restoreEngineSnapshot(const MappedEngineSnapshot<PriceType>& snap, BookT& book, OmsT& oms,
+                                    MatchingEngine<PriceType, OrderIdType, BookT, OmsT>& engine) {
+    const auto* level = snap.levels();
+    const auto* order = snap.orders();
+    const auto* const orders_end = order + snap.orderCount();
+    auto restore = [&](const SnapshotOrder<PriceType>& o) -> typename OmsT::RecordT& {
+        return oms.restore(static_cast<OrderIdType>(o.id), o.price, o.quantity, o.is_buy != 0,
+                           static_cast<OrderState>(o.state));
+    };
+
+    for (std::size_t l = 0; l < snap.levelCount(); ++l, ++level) {
+        book.restoreLevel(level->is_buy != 0, level->price, level->total_qty, level->order_count);
+        for (std::int32_t k = 0; k < level->order_count && order != orders_end; ++k, ++order)
+            engine.restoreResting(restore(*order));
+    }
+    for (; order != orders_end; ++order) restore(*order);
+    return snap.journalOffset();
+}
+
+/// What warmRestart() did.
+struct WarmRestartStats {
+    std::size_t   levels = 0;
+    std::size_t   orders = 0;          // records restored from the snapshot
+    std::uint64_t journal_offset = 0;  // first replayed journal record
+    std::size_t   replayed = 0;        // journal tail commands applied
+    double        restore_ms = 0.0;    // map + validate + rebuild
+    double        replay_ms = 0.0;
+};
+
+/// Warm restart: map the snapshot, rebuild state from it, then apply only
+/// the order-journal records after its checkpointed offset. Trades produced
+/// by the tail replay go to sink (they were already emitted before the
+/// crash; most callers pass a no-op or dedupe downstream).
+template <typename PriceType, typename OrderIdType, typename BookT, typename OmsT, typename Sink>
+WarmRestartStats warmRestart(const std::string& snapshot_path, const std::string& journal_path,
+                             BookT& book, OmsT& oms,
+                             MatchingEngine<PriceType, OrderIdType, BookT, OmsT>& engine, Sink&& sink) {
+    using Clock = std::chrono::steady_clock;
+    using CommandKind = typename GatewayCommand<PriceType, OrderIdType>::Kind;
+    auto ms = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    WarmRestartStats st;
+    const auto t0 = Clock::now();
+    {
+        const MappedEngineSnapshot<PriceType> snap(snapshot_path);
+        oms.reserve(snap.orderCount());
+        st.levels = snap.levelCount();
+        st.orders = snap.orderCount();
+        st.journal_offset = restoreEngineSnapshot(snap, book, oms, engine);
+    }
+    const auto t1 = Clock::now();
+
+    const OrderJournalReader<PriceType> journal(journal_path);
+    if (st.journal_offset > journal.size())
+        throw std::runtime_error("warmRestart: snapshot is ahead of journal " + journal_path);
+    for (const auto* r = journal.begin() + st.journal_offset; r != journal.end(); ++r) {
+        const auto id = static_cast<OrderIdType>(r->id);
+        switch (static_cast<CommandKind>(r->kind)) {
+        case CommandKind::New:
+            engine.submit(Order<PriceType, OrderIdType>{id, r->price, r->quantity, r->is_buy != 0}, sink);
+            break;
+        case CommandKind::Cancel:
+            engine.cancel(id);
+            break;
+        case CommandKind::Replace:
+            engine.replacePrice(id, r->price, sink);
+            break;
+        }
+        ++st.replayed;
+    }
+    st.restore_ms = ms(t0, t1);
+    st.replay_ms = ms(t1, Clock::now());
+    return st;
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "ArenaMemory.hpp"
+
+/// Flat open-addressing map: integral order ID -> 32-bit slot index.
+/// - Linear probing over one contiguous array (no per-insert node allocation)
+/// - Backward-shift deletion, so no tombstones pile up under cancel-heavy flow
+/// - Fibonacci hashing on the ID; capacity is a power of two, load <= 50%
+/// - After reserve(n), up to n live keys never allocate
+/// - The table is an ArenaBuffer, so it can sit on huge pages (its probes are
+///   random, i.e. the TLB-heavy part of an order lookup)
+template <typename KeyType>
+class IdIndex {
+    static_assert(std::is_integral<KeyType>::value,
+                  "IdIndex keys must be integral");
+
+public:
+    static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+    IdIndex() = default;
+    IdIndex(const IdIndex&) = delete; // entries_ points into table_
+    IdIndex& operator=(const IdIndex&) = delete;
+
+    void reserve(std::size_t n) {
+        std::size_t cap = 16;
+        while (cap < 2 * n) cap *= 2;
+        if (cap > cap_) rehash(cap);
+    }
+
+    // Returns the slot for key, or npos
+    [[nodiscard]] std::uint32_t find(KeyType key) const noexcept {
+        if (cap_ == 0) return npos;
+        for (std::size_t i = bucket(key);; i = (i + 1) & mask_) {
+            const Entry& e = entries_[i];
+            if (e.value == npos) return npos;
+            if (e.key == key) return e.value;
+        }
+    }
+
+    // Pull key's home bucket into cache ahead of a find()/insert() (batch paths)
+    void prefetch(KeyType key) const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        if (cap_ != 0) __builtin_prefetch(&entries_[bucket(key)]);
+#else
+        (void)key;
+#endif
+    }
+
+    // Insert or overwrite
+    void insert(KeyType key, std::uint32_t value) {
+        if ((size_ + 1) * 2 > cap_)
+            rehash(cap_ == 0 ? 16 : cap_ * 2);
+        for (std::size_t i = bucket(key);; i = (i + 1) & mask_) {
+            Entry& e = entries_[i];
+            if (e.value == npos) {
+                e.key = key;
+                e.value = value;
+                ++size_;
+                return;
+            }
+            if (e.key == key) {
+                e.value = value;
+                return;
+            }
+        }
+    }
+
+    bool erase(KeyType key) noexcept {
+        if (cap_ == 0) return false;
+        std::size_t hole = bucket(key);
+        while (true) {
+            if (entries_[hole].value == npos) return false;
+            if (entries_[hole].key == key) break;
+            hole = (hole + 1) & mask_;
+        }
+        // Shift later members of the probe run back into the hole
+        for (std::size_t j = (hole + 1) & mask_; entries_[j].value != npos; j = (j + 1) & mask_) {
+            const std::size_t home = bucket(entries_[j].key);
+            if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+                entries_[hole] = entries_[j];
+                hole = j;
+            }
+        }
+        entries_[hole].value = npos;
+        --size_;
+        return true;
+    }
+
+    // fn(key, value) for every live entry, in bucket order (snapshots, not the hot path)
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (std::size_t i = 0; i < cap_; ++i)
+            if (entries_[i].value != npos) fn(entries_[i].key, entries_[i].value);
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i < cap_; ++i) entries_[i].value = npos;
+        size_ = 0;
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+private:
+    struct Entry {
+        KeyType       key{};
+        std::uint32_t value = npos; // npos marks an empty bucket
+    };
+
+    std::size_t bucket(KeyType key) const noexcept {
+        const auto x = static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(x >> shift_);
+    }
+
+    void rehash(std::size_t cap) {
+        static_assert(std::is_trivially_destructible<Entry>::value, "table entries are never destroyed");
+        ArenaBuffer old = std::move(table_);
+        const Entry* old_entries = entries_;
+        const std::size_t old_cap = cap_;
+
+        table_ = ArenaBuffer(cap * sizeof(Entry), alignof(Entry));
+        entries_ = static_cast<Entry*>(table_.data());
+        for (std::size_t i = 0; i < cap; ++i) new (entries_ + i) Entry{};
+        cap_ = cap;
+        mask_ = cap - 1;
+        shift_ = 64;
+        for (std::size_t c = cap; c > 1; c >>= 1) --shift_;
+        size_ = 0;
+        for (std::size_t i = 0; i < old_cap; ++i)
+            if (old_entries[i].value != npos) insert(old_entries[i].key, old_entries[i].value);
+    }
+
+    ArenaBuffer table_;
+    Entry*      entries_ = nullptr;
+    std::size_t cap_   = 0;
+    std::size_t size_  = 0;
+    std::size_t mask_  = 0;
+    unsigned    shift_ = 64;
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <ostream>
+#include <string>
+
+/// Fixed-memory log-linear latency histogram (HdrHistogram-style bucketing).
+/// - Values below 2^kSubBucketBits are counted exactly; above that each power of
+///   two is split into 2^(kSubBucketBits-1) linear sub-buckets, so any recorded
+///   value is reported within 1 / 2^(kSubBucketBits-1) (~0.8%) of its true value
+/// - record() is O(1): one bit scan, one shift and one counter increment
+/// - ~58 KB regardless of sample count; min/max/mean/stddev are exact
+/// - Not thread-safe: give each thread its own histogram and merge() them
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits  = 8;
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;        // exact range
+    static constexpr int kSubBucketHalf  = kSubBucketCount / 2;        // per octave above it
+    static constexpr int kBucketCount    = kSubBucketCount + (64 - kSubBucketBits) * kSubBucketHalf;
+
+    void record(long long value) noexcept { record(value, 1); }
+
+    void record(long long value, std::uint64_t n) noexcept {
+        const std::uint64_t v = value < 0 ? 0 : static_cast<std::uint64_t>(value);
+        counts_[indexOf(v)] += n;
+        count_ += n;
+        if (v < min_) min_ = v;
+        if (v > max_) max_ = v;
+        const double d = static_cast<double>(v);
+        sum_   += d * static_cast<double>(n);
+        sumSq_ += d * d * static_cast<double>(n);
+    }
+
+    // Fold another histogram (e.g. another thread's) into this one
+    void merge(const LatencyHistogram& other) noexcept {
+        if (other.count_ == 0) return;
+        for (int i = 0; i < kBucketCount; ++i) counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_   += other.sum_;
+        sumSq_ += other.sumSq_;
+        if (other.min_ < min_) min_ = other.min_;
+        if (other.max_ > max_) max_ = other.max_;
+    }
+
+    void reset() noexcept {
+        counts_.fill(0);
+        count_ = 0;
+        min_ = std::numeric_limits<std::uint64_t>::max();
+        max_ = 0;
+        sum_ = sumSq_ = 0.0;
+    }
+
+    std::uint64_t count() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+    long long min() const noexcept { return count_ ? static_cast<long long>(min_) : 0; }
+    long long max() const noexcept { return static_cast<long long>(max_); }
+    double mean() const noexcept { return count_ ? sum_ / static_cast<double>(count_) : 0.0; }
+
+    double stddev() const noexcept {
+        if (count_ == 0) return 0.0;
+        const double m = mean();
+        const double var = sumSq_ / static_cast<double>(count_) - m * m;
+        return var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+
+    // Value at quantile q in [0, 1]: the highest value equivalent to the bucket
+    // holding the ceil(q * count)-th sample, clamped to the exact min/max
+    long long percentile(double q) const noexcept {
+        if (count_ == 0) return 0;
+        if (q <= 0.0) return min();
+        if (q >= 1.0) return max();
+        std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count_)));
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                std::uint64_t v = highestEquivalent(i);
+                if (v > max_) v = max_;
+                if (v < min_) v = min_;
+                return static_cast<long long>(v);
+            }
+        }
+        return max();
+    }
+
+    // One-line summary: "n=... p50=... p90=... p99=... p99.9=... max=..."
+    void printSummary(std::ostream& os, const std::string& title) const {
+        char line[192];
+        std::snprintf(line, sizeof(line),
+                      "%s n=%llu p50=%lld p90=%lld p99=%lld p99.9=%lld max=%lld\n",
+                      title.c_str(), static_cast<unsigned long long>(count_),
+                      percentile(0.50), percentile(0.90), percentile(0.99),
+                      percentile(0.999), max());
+        os << line;
+    }
+
+private:
+    static int highestBit(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(x);
+#else
+        int i = 63;
+        while (!(x >> i)) --i;
+        return i;
+#endif
+    }
+
+    static int indexOf(std::uint64_t v) noexcept {
+        if (v < static_cast<std::uint64_t>(kSubBucketCount)) return static_cast<int>(v);
+        const int shift = highestBit(v) - (kSubBucketBits - 1);            // >= 1
+        const int sub   = static_cast<int>(v >> shift) - kSubBucketHalf;   // [0, half)
+        return kSubBucketCount + (shift - 1) * kSubBucketHalf + sub;
+    }
+
+    static std::uint64_t highestEquivalent(int idx) noexcept {
+        if (idx < kSubBucketCount) return static_cast<std::uint64_t>(idx);
+        const int rel   = idx - kSubBucketCount;
+        const int shift = rel / kSubBucketHalf + 1;
+        const std::uint64_t top = static_cast<std::uint64_t>(rel % kSubBucketHalf + kSubBucketHalf);
+        return ((top + 1) << shift) - 1;
+    }
+
+    std::array<std::uint64_t, kBucketCount> counts_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ = 0;
+    double sum_ = 0.0;
+    double sumSq_ = 0.0;
+};
+
+/// Cumulative histogram plus a rolling interval for periodic snapshots.
+/// record() only touches the interval; rollover() folds it into the total,
+/// prints it and starts a new interval (O(buckets), call it off the hot path).
+class IntervalLatencyHistogram {
+public:
+    void record(long long value) noexcept { interval_.record(value); }
+
+    void rollover(std::ostream& os, const std::string& title) {
+        interval_.printSummary(os, title);
+        total_.merge(interval_);
+        interval_.reset();
+    }
+
+    // Everything recorded so far, including the open interval
+    LatencyHistogram total() const {
+        LatencyHistogram all = total_;
+        all.merge(interval_);
+        return all;
+    }
+
+    const LatencyHistogram& interval() const noexcept { return interval_; }
+
+private:
+    LatencyHistogram total_;
+    LatencyHistogram interval_;
+};
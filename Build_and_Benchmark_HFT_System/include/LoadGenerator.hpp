@@ -0,0 +1,202 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BlockGenerator.hpp"
+#include "MarketData.hpp"
+#include "OrderGateway.hpp" // GatewayCommand
+#include "TickPrice.hpp"
+#include "XorShift32.hpp"
+
+/// Preset order-flow mixes for LoadGenerator::generateOrders().
+enum class OrderFlow : std::uint8_t {
+    Balanced,     // mostly passive near the touch, some cancels/replaces
+    CancelHeavy,  // quote-stuffing style: about one cancel per new order
+    Aggressive,   // half of the new orders cross the mid
+    DeepBook      // passive orders spread over 200 ticks, few cancels
+};
+
+/// Command mix in percent. A command is a Cancel with cancel_pct, a Replace
+/// with replace_pct, else a New; Cancel/Replace fall back to New while the
+/// block has no live order. aggressive_pct of the News cross the mid.
+struct OrderFlowProfile {
+    const char*  name = "balanced";
+    std::uint8_t cancel_pct = 25;
+    std::uint8_t replace_pct = 15;
+    std::uint8_t aggressive_pct = 10;
+    std::int32_t max_offset_ticks = 5; // passive: 1..max ticks behind the mid
+    std::int32_t min_qty = 1;
+    std::int32_t max_qty = 100;
+};
+
+inline OrderFlowProfile orderFlowProfile(OrderFlow flow) noexcept {
+    switch (flow) {
+    case OrderFlow::CancelHeavy: return {"cancel-heavy", 48, 4, 5, 3, 1, 100};
+    case OrderFlow::Aggressive:  return {"aggressive", 15, 5, 50, 5, 1, 100};
+    case OrderFlow::DeepBook:    return {"deep-book", 8, 4, 2, 200, 1, 100};
+    case OrderFlow::Balanced:    break;
+    }
+    return {};
+}
+
+struct LoadGenConfig {
+    std::uint32_t seed = MarketDataFeed::kDefaultSeed;
+    unsigned      threads = 0;             // workers; 0: one per hardware thread
+    std::size_t   block = std::size_t{1} << 16; // items per block: the unit of determinism
+    std::uint32_t num_symbols = 10;
+    std::int64_t  start_ns = -1;           // first exchange timestamp; -1: one wall-clock read
+    std::int64_t  mid_ticks = 15'000;      // orders: mid price in ticks (150.00 at 0.01)
+    double        tick_size = 0.01;
+};
+
+/// Parallel synthetic ticks and order flow.
+/// - Output depends on (seed, block size, count) only, never on the thread
+///   count: block b draws from XorShift32::stream(seed, b) (BlockGenerator.hpp)
+/// - Ticks match MarketDataFeed's layout and distributions (symbol i % N,
+///   prices uniform 100-200, ask +0.05, sizes 100-5000, exchange time +100 ns
+///   per tick) without a clock read or an mt19937 per tick; the values are a
+///   different random sequence from generateData()'s
+/// - Orders are GatewayCommands for one book: New ids are command index + 1;
+///   Cancel/Replace target an order opened earlier in the same block (it may
+///   have filled since, then the engine rejects it like a real late cancel)
+/// - Generate up front and time only the consumer; streamTicks() feeds
+///   scenarios larger than memory through per-worker block buffers
+class LoadGenerator {
+public:
+    explicit LoadGenerator(LoadGenConfig cfg = {}) : cfg_(cfg) {
+        if (cfg_.block == 0) cfg_.block = 1;
+        if (cfg_.num_symbols == 0) cfg_.num_symbols = 1;
+        if (cfg_.start_ns < 0)
+            cfg_.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+    const LoadGenConfig& config() const noexcept { return cfg_; }
+    unsigned threads() const noexcept { return resolveGeneratorThreads(cfg_.threads); }
+
+    // --- Ticks ------------------------------------------------------------
+
+    // Ticks 0..n-1 into out[0..n); each worker first-touches the blocks it fills
+    void fillTicks(MarketData* out, std::size_t n) const {
+        runBlocks(blocks(n), cfg_.threads, [&](std::size_t b) {
+            const std::size_t first = b * cfg_.block;
+            fillTickBlock(out + first, first, blockSize(b, n), b);
+        });
+    }
+
+    // Replaces out's contents with ticks 0..n-1
+    void generateTicks(std::vector<MarketData>& out, std::size_t n) const {
+        out.clear();
+        out.resize(n);
+        fillTicks(out.data(), n);
+    }
+
+    // fn(const MarketData* ticks, std::size_t count, std::size_t first) once per
+    // block, concurrently from the workers and in no particular order. Each
+    // worker reuses one block buffer, so memory stays O(threads * block).
+    template <typename Fn>
+    void streamTicks(std::size_t n, Fn&& fn) const {
+        runBlocks(blocks(n), cfg_.threads, [&](std::size_t b) {
+            thread_local std::vector<MarketData> buf;
+            if (buf.size() < cfg_.block) buf.resize(cfg_.block);
+            const std::size_t first = b * cfg_.block, count = blockSize(b, n);
+            fillTickBlock(buf.data(), first, count, b);
+            fn(static_cast<const MarketData*>(buf.data()), count, first);
+        });
+    }
+
+    // --- Order flow -------------------------------------------------------
+
+    // Replaces out's contents with commands 0..n-1 of the given mix
+    template <typename PriceType, typename OrderIdType>
+    void generateOrders(std::vector<GatewayCommand<PriceType, OrderIdType>>& out, std::size_t n,
+                        const OrderFlowProfile& profile) const {
+        out.clear();
+        out.resize(n);
+        fillOrders(out.data(), n, profile);
+    }
+
+    template <typename PriceType, typename OrderIdType>
+    void fillOrders(GatewayCommand<PriceType, OrderIdType>* out, std::size_t n,
+                    const OrderFlowProfile& profile) const {
+        const TickScale<PriceType> scale(cfg_.tick_size);
+        runBlocks(blocks(n), cfg_.threads, [&](std::size_t b) {
+            const std::size_t first = b * cfg_.block;
+            fillOrderBlock(out + first, first, blockSize(b, n), b, profile, scale);
+        });
+    }
+
+private:
+    // Order streams are salted so they never replay the tick streams
+    static constexpr std::uint32_t kOrderSalt = 0x5EEDF10Bu;
+
+    std::size_t blocks(std::size_t n) const noexcept { return (n + cfg_.block - 1) / cfg_.block; }
+    std::size_t blockSize(std::size_t b, std::size_t n) const noexcept {
+        const std::size_t first = b * cfg_.block;
+        return n - first < cfg_.block ? n - first : cfg_.block;
+    }
+
+    void fillTickBlock(MarketData* out, std::size_t first, std::size_t count, std::size_t b) const {
+        XorShift32 rng = XorShift32::stream(cfg_.seed, b);
+        for (std::size_t k = 0; k < count; ++k) {
+            const std::size_t i = first + k;
+            MarketData md{};
+            md.symbol_id = static_cast<std::uint32_t>(i % cfg_.num_symbols);
+            md.bid_price = rng.uniform(100.0, 200.0);
+            md.ask_price = rng.uniform(100.0, 200.0) + 0.05; // small spread
+            md.bid_size = rng.between(100, 5000);
+            md.ask_size = rng.between(100, 5000);
+            md.exchange_ts_ns = cfg_.start_ns + 100 * static_cast<std::int64_t>(i);
+            out[k] = md;
+        }
+    }
+
+    template <typename PriceType, typename OrderIdType>
+    void fillOrderBlock(GatewayCommand<PriceType, OrderIdType>* out, std::size_t first, std::size_t count,
+                        std::size_t b, const OrderFlowProfile& p, const TickScale<PriceType>& scale) const {
+        using Command = GatewayCommand<PriceType, OrderIdType>;
+        struct Live { OrderIdType id; bool is_buy; };
+        XorShift32 rng = XorShift32::stream(cfg_.seed ^ kOrderSalt, b);
+        thread_local std::vector<Live> live; // orders this block opened and hasn't canceled
+        live.clear();
+
+        auto passive = [&](bool buy) {
+            const std::int64_t off = rng.between(1, p.max_offset_ticks);
+            return scale.fromTicks(buy ? cfg_.mid_ticks - off : cfg_.mid_ticks + off);
+        };
+        for (std::size_t k = 0; k < count; ++k) {
+            Command& c = out[k];
+            c = Command{};
+            const std::uint32_t roll = rng.next_u32() % 100;
+            if (!live.empty() && roll < p.cancel_pct + p.replace_pct) {
+                const std::size_t j = rng.next_u32() % live.size();
+                c.id = live[j].id;
+                if (roll < p.cancel_pct) {
+                    c.kind = Command::Kind::Cancel;
+                    live[j] = live.back();
+                    live.pop_back();
+                } else {
+                    c.kind = Command::Kind::Replace;
+                    c.price = passive(live[j].is_buy);
+                }
+                continue;
+            }
+            c.kind = Command::Kind::New;
+            c.id = static_cast<OrderIdType>(first + k + 1);
+            c.is_buy = (rng.next_u32() & 1) != 0;
+            c.quantity = rng.between(p.min_qty, p.max_qty);
+            if (rng.next_u32() % 100 < p.aggressive_pct) {
+                // Through the mid into the opposite side's resting range
+                const std::int64_t through = rng.between(1, p.max_offset_ticks);
+                c.price = scale.fromTicks(c.is_buy ? cfg_.mid_ticks + through : cfg_.mid_ticks - through);
+            } else {
+                c.price = passive(c.is_buy);
+            }
+            live.push_back(Live{c.id, c.is_buy});
+        }
+    }
+
+    LoadGenConfig cfg_;
+};
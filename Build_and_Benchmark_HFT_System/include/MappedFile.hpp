@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------------------------
+// Memory-mapped files shared by the journals, snapshots and tick captures
+// -----------------------------------------------------------------------------
+// MappedFileWriter owns a read/write MAP_SHARED mapping of a file it creates,
+// pre-sized with ftruncate and remapped larger on demand; finish() truncates
+// it to the bytes actually used. MappedFileReader maps a whole file read-only.
+// Both throw std::runtime_error prefixed with the owner's name (`who`).
+// -----------------------------------------------------------------------------
+
+/// Writable mapping of a newly created (truncated) file.
+class MappedFileWriter {
+public:
+    MappedFileWriter(std::string path, std::size_t bytes, const char* who)
+        : path_(std::move(path)), who_(who) {
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) throw std::runtime_error(std::string(who_) + ": cannot open " + path_);
+        try {
+            map(bytes);
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    MappedFileWriter(const MappedFileWriter&) = delete;
+    MappedFileWriter& operator=(const MappedFileWriter&) = delete;
+
+    // Keeps the file at its mapped size; call finish() to trim it
+    ~MappedFileWriter() {
+        unmap();
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    // Remap at `bytes` (a syscall or three: keep it off the hot path).
+    // Pointers into the old mapping are invalidated.
+    void resize(std::size_t bytes) {
+        unmap();
+        map(bytes);
+    }
+
+    // Schedule write-back of dirty pages (the kernel writes them back regardless)
+    void flush() noexcept {
+        if (base_) ::msync(base_, bytes_, MS_ASYNC);
+    }
+
+    // Unmap, truncate to `used` bytes and close. Returns false if the
+    // truncate or close failed (the file then keeps its mapped size).
+    bool finish(std::size_t used) noexcept {
+        if (fd_ < 0) return true;
+        unmap();
+        const bool truncated = ::ftruncate(fd_, static_cast<off_t>(used)) == 0;
+        const bool closed = ::close(fd_) == 0;
+        fd_ = -1;
+        return truncated && closed;
+    }
+
+    char* data() const noexcept { return base_; }
+    std::size_t size() const noexcept { return bytes_; }
+    const std::string& path() const noexcept { return path_; }
+    explicit operator bool() const noexcept { return base_ != nullptr; }
+
+private:
+    void map(std::size_t bytes) {
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0)
+            throw std::runtime_error(std::string(who_) + ": cannot size " + path_);
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) throw std::runtime_error(std::string(who_) + ": cannot map " + path_);
+        base_  = static_cast<char*>(p);
+        bytes_ = bytes;
+    }
+
+    void unmap() noexcept {
+        if (base_) ::munmap(base_, bytes_);
+        base_ = nullptr;
+    }
+
+    std::string path_;
+    const char* who_;
+    int fd_ = -1;
+    char* base_ = nullptr;
+    std::size_t bytes_ = 0;
+};
+
+/// How a reader will walk its mapping.
+enum class MapAccess : std::uint8_t {
+    Random,     // no advice
+    Sequential, // MADV_SEQUENTIAL: read ahead, drop pages behind the cursor
+    Preload     // MAP_POPULATE up front, then sequential
+};
+
+/// Read-only mapping of a whole file.
+class MappedFileReader {
+public:
+    // Files shorter than min_bytes are rejected as "<path> is not a <kind>"
+    MappedFileReader(const std::string& path, std::size_t min_bytes, const char* who, const char* kind,
+                     MapAccess access = MapAccess::Sequential) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) throw std::runtime_error(std::string(who) + ": cannot open " + path);
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0 || static_cast<std::size_t>(st.st_size) < min_bytes || st.st_size == 0) {
+            ::close(fd_);
+            throw std::runtime_error(std::string(who) + ": " + path + " is not a " + kind);
+        }
+        bytes_ = static_cast<std::size_t>(st.st_size);
+        const int flags = MAP_SHARED | (access == MapAccess::Preload ? MAP_POPULATE : 0);
+        void* p = ::mmap(nullptr, bytes_, PROT_READ, flags, fd_, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error(std::string(who) + ": cannot map " + path);
+        }
+        base_ = static_cast<const char*>(p);
+        if (access != MapAccess::Random) ::madvise(p, bytes_, MADV_SEQUENTIAL);
+    }
+
+    MappedFileReader(const MappedFileReader&) = delete;
+    MappedFileReader& operator=(const MappedFileReader&) = delete;
+
+    ~MappedFileReader() {
+        ::munmap(const_cast<char*>(base_), bytes_);
+        ::close(fd_);
+    }
+
+    const char* data() const noexcept { return base_; }
+    std::size_t size() const noexcept { return bytes_; }
+
+    // True if `count` elements of elem_size bytes starting at `offset` lie
+    // inside the file. Divides rather than multiplies, so hostile header
+    // counts can't wrap the bound.
+    bool fits(std::uint64_t offset, std::uint64_t count, std::uint64_t elem_size) const noexcept {
+        if (offset > bytes_) return false;
+        return elem_size == 0 || count <= (bytes_ - offset) / elem_size;
+    }
+
+private:
+    int fd_ = -1;
+    const char* base_ = nullptr;
+    std::size_t bytes_ = 0;
+};
@@ -1,16 +1,37 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "SymbolTable.hpp"
 
 
-constexpr std::size_t kAlign = 64; // set to 1 for “off”
+constexpr std::size_t kAlign = 64; // tick slot and alignment: a power of two, at least 64
+
+// Trivially copyable tick: safe to memcpy, mmap and push through SPSC rings.
+// The symbol is a SymbolTable id; the name is only looked up for display.
+// All padding is named (reserved, pad) and zeroed by MarketData{}, so the
+// bytes TickRecorder writes are fully determined by the tick.
 struct alignas(kAlign) MarketData {
-    std::string symbol;
-    double bid_price;
-    double ask_price;
-    std::chrono::high_resolution_clock::time_point timestamp;
+    std::uint32_t symbol_id;
+    std::int32_t  bid_size;
+    std::int32_t  ask_size;
+    std::uint32_t reserved;
+    double        bid_price;
+    double        ask_price;
+    std::int64_t  exchange_ts_ns; // exchange timestamp, ns since epoch
+    std::uint8_t  pad[kAlign - 40];
 };
+static_assert(std::is_trivially_copyable<MarketData>::value, "MarketData must stay POD");
+static_assert(std::is_standard_layout<MarketData>::value, "MarketData must stay POD");
+// No unnamed padding: the fields tile the slot exactly
+static_assert(offsetof(MarketData, bid_price) == 16 && offsetof(MarketData, pad) == 40
+              && sizeof(MarketData) == kAlign, "MarketData must fill its slot with no unnamed padding");
 
 // struct MarketData {
 //     std::string symbol;
@@ -21,24 +42,43 @@ struct alignas(kAlign) MarketData {
 
 class MarketDataFeed {
 public:
-    MarketDataFeed(std::vector<MarketData>& ref) : data(ref) {}
+    static constexpr std::uint32_t kDefaultSeed = 20250920;
+
+    // Interns SYM0..SYM{num_symbols-1} once; ticks then carry ids 0..num_symbols-1.
+    // num_symbols must be at least 1 (ids are tick index % num_symbols).
+    MarketDataFeed(std::vector<MarketData>& ref, std::uint32_t num_symbols = 10)
+        : data(ref), num_symbols_(num_symbols) {
+        if (num_symbols_ == 0) throw std::invalid_argument("MarketDataFeed: num_symbols must be > 0");
+        for (std::uint32_t i = 0; i < num_symbols_; ++i) symbols_.intern("SYM" + std::to_string(i));
+    }
 
-    void generateData(int num_ticks) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
+    // Same seed -> same ticks, so runs (and captures) are reproducible
+    void generateData(int num_ticks, std::uint32_t seed = kDefaultSeed) {
+        std::mt19937 gen(seed);
         std::uniform_real_distribution<> price_dist(100.0, 200.0);
+        std::uniform_int_distribution<std::int32_t> size_dist(100, 5000);
 
-        data.reserve(num_ticks); // preallocate memory contiguously
+        // Exchange time advances 100 ns per tick from one wall-clock read
+        const std::int64_t t0 = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+
+        data.reserve(data.size() + num_ticks); // preallocate memory contiguously
         for (int i = 0; i < num_ticks; ++i) {
-            MarketData md;
-            md.symbol = "SYM" + std::to_string(i % 10);
+            MarketData md{}; // no indeterminate bytes: ticks are memcpy'd to rings and disk
+            md.symbol_id = static_cast<std::uint32_t>(i) % num_symbols_;
             md.bid_price = price_dist(gen);
             md.ask_price = price_dist(gen) + 0.05; // small spread
-            md.timestamp = std::chrono::high_resolution_clock::now();
+            md.bid_size = size_dist(gen);
+            md.ask_size = size_dist(gen);
+            md.exchange_ts_ns = t0 + 100 * static_cast<std::int64_t>(i);
             data.push_back(md);
         }
     }
 
+    const SymbolTable& symbols() const noexcept { return symbols_; }
+
 private:
     std::vector<MarketData>& data;
-};
\ No newline at end of file
+    std::uint32_t num_symbols_;
+    SymbolTable symbols_;
+};
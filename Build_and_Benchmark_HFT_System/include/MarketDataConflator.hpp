@@ -0,0 +1,210 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MarketData.hpp"
+#include "SpscRing.hpp"
+#include "TscClock.hpp"
+
+/// How a MarketDataConflator hands ticks to its consumer.
+enum class ConflationMode : std::uint8_t {
+    EveryTick,   // FIFO of every tick (bounded ring; nothing is dropped, producer sees full)
+    LatestOnly,  // each poll delivers the latest tick of every instrument that changed
+    Window       // as LatestOnly, but at most one drain per window_ns
+};
+
+struct ConflationConfig {
+    ConflationMode mode = ConflationMode::LatestOnly;
+    std::int64_t   window_ns = 0;          // Window mode: minimum gap between drains
+    std::size_t    ring_capacity = 1 << 16; // EveryTick mode
+};
+
+/// Counters since construction. Producer and consumer fields are each written
+/// by one side only; reading them from the other side gives a recent value.
+struct ConflationStats {
+    std::uint64_t published = 0;  // publish() calls accepted
+    std::uint64_t conflated = 0;  // ticks that overwrote a still-dirty slot
+    std::uint64_t rejected  = 0;  // EveryTick: ring full
+    std::uint64_t delivered = 0;  // ticks handed to the consumer
+    std::uint64_t drains    = 0;  // polls that delivered at least one tick
+    std::uint64_t max_batch = 0;  // most ticks delivered by one poll
+};
+
+/// Conflation stage between a feed and a slower consumer.
+/// - One seqlock slot per instrument (dense symbol ids < instruments) holds
+///   the latest tick; a bitmap of dirty instruments says which slots changed
+/// - publish() is O(1) and never blocks: a slot overwrite plus one fetch_or.
+///   A tick that lands on a still-dirty slot replaces the one there and
+///   counts as conflated
+/// - poll() visits only the dirty words of the bitmap and delivers each
+///   changed instrument once, lowest id first, so its work per drain is
+///   bounded by the instrument count however fast the producer runs
+/// - Single producer / single consumer; both sides may run on one thread
+/// TickT must be trivially copyable and carry a `symbol_id`.
+template <typename TickT = MarketData>
+class MarketDataConflator {
+    static_assert(std::is_trivially_copyable<TickT>::value,
+                  "Conflated ticks must be trivially copyable");
+
+public:
+    explicit MarketDataConflator(std::size_t instruments, ConflationConfig cfg = {})
+        : cfg_(cfg),
+          instruments_(instruments),
+          slots_(new Slot[instruments ? instruments : 1]),
+          dirty_((instruments + kWordBits - 1) / kWordBits),
+          lastSeq_(instruments, 0) {
+        if (cfg_.mode == ConflationMode::EveryTick)
+            ring_ = std::make_unique<SpscRing<TickT>>(cfg_.ring_capacity);
+        for (auto& w : dirty_) w.store(0, std::memory_order_relaxed);
+    }
+
+    MarketDataConflator(const MarketDataConflator&) = delete;
+    MarketDataConflator& operator=(const MarketDataConflator&) = delete;
+
+    // --- Producer side ----------------------------------------------------
+
+    // False only in EveryTick mode when the ring is full (the tick is not queued)
+    bool publish(const TickT& t) noexcept {
+        if (ring_) {
+            if (!ring_->try_push(t)) {
+                bump(rejected_);
+                return false;
+            }
+            bump(published_);
+            return true;
+        }
+        const std::size_t id = t.symbol_id;
+        Slot& s = slots_[id];
+        const std::uint64_t seq = s.seq.load(std::memory_order_relaxed);
+        s.seq.store(seq + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&s.tick, &t, sizeof(TickT));
+        s.seq.store(seq + 2, std::memory_order_release);
+
+        const std::uint64_t bit = std::uint64_t{1} << (id % kWordBits);
+        if (dirty_[id / kWordBits].fetch_or(bit, std::memory_order_release) & bit) bump(conflated_);
+        bump(published_);
+        return true;
+    }
+
+    // --- Consumer side ----------------------------------------------------
+
+    // fn(const TickT&) per delivered tick; returns how many were delivered
+    template <typename F>
+    std::size_t poll(F&& fn) {
+        return poll(std::forward<F>(fn), static_cast<std::int64_t>(TscClock::toNs(TscClock::stop())));
+    }
+
+    // Same, with the caller's clock (ns) for Window mode (replays, simulations)
+    template <typename F>
+    std::size_t poll(F&& fn, std::int64_t now_ns) {
+        std::size_t n = 0;
+        if (ring_) {
+            n = ring_->consume(fn, ring_->capacity());
+        } else {
+            if (cfg_.mode == ConflationMode::Window) {
+                if (drained_once_ && now_ns - lastDrainNs_ < cfg_.window_ns) return 0;
+            }
+            for (std::size_t w = 0; w < dirty_.size(); ++w) {
+                if (dirty_[w].load(std::memory_order_relaxed) == 0) continue;
+                std::uint64_t bits = dirty_[w].exchange(0, std::memory_order_acquire);
+                while (bits) {
+                    const std::size_t id = w * kWordBits + static_cast<std::size_t>(__builtin_ctzll(bits));
+                    bits &= bits - 1;
+                    n += deliver(id, fn);
+                }
+            }
+            if (n) {
+                lastDrainNs_ = now_ns;
+                drained_once_ = true;
+            }
+        }
+        if (n) {
+            bump(delivered_, n);
+            bump(drains_);
+            if (n > max_batch_.load(std::memory_order_relaxed)) max_batch_.store(n, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // Ticks or instruments waiting for the consumer (approximate while the producer runs)
+    std::size_t pending() const noexcept {
+        if (ring_) return ring_->size();
+        std::size_t n = 0;
+        for (const auto& w : dirty_) n += static_cast<std::size_t>(__builtin_popcountll(w.load(std::memory_order_relaxed)));
+        return n;
+    }
+
+    ConflationStats stats() const noexcept {
+        ConflationStats s;
+        s.published = published_.load(std::memory_order_relaxed);
+        s.conflated = conflated_.load(std::memory_order_relaxed);
+        s.rejected  = rejected_.load(std::memory_order_relaxed);
+        s.delivered = delivered_.load(std::memory_order_relaxed);
+        s.drains    = drains_.load(std::memory_order_relaxed);
+        s.max_batch = max_batch_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    ConflationMode mode() const noexcept { return cfg_.mode; }
+    std::size_t instruments() const noexcept { return instruments_; }
+
+private:
+    static constexpr std::size_t kWordBits = 64;
+    static constexpr std::size_t kLine = 64;
+
+    struct alignas(kLine) Slot {
+        std::atomic<std::uint64_t> seq{0}; // even: stable, odd: being written
+        TickT tick;
+    };
+
+    // Copy a stable version of the slot out; skip it if the consumer already
+    // delivered this version (the producer rewrote it mid-drain and re-marked
+    // it, and a previous read picked the newer tick up)
+    template <typename F>
+    std::size_t deliver(std::size_t id, F& fn) {
+        Slot& s = slots_[id];
+        TickT copy;
+        std::uint64_t before;
+        while (true) {
+            before = s.seq.load(std::memory_order_acquire);
+            if (before & 1) { cpu_relax(); continue; }
+            std::memcpy(&copy, &s.tick, sizeof(TickT));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == before) break;
+        }
+        if (before == lastSeq_[id]) return 0;
+        lastSeq_[id] = before;
+        fn(static_cast<const TickT&>(copy));
+        return 1;
+    }
+
+    // Single-writer counters: a plain load/store pair, no locked RMW
+    static void bump(std::atomic<std::uint64_t>& c, std::uint64_t by = 1) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    ConflationConfig cfg_;
+    std::size_t instruments_;
+    std::unique_ptr<Slot[]> slots_;
+    std::vector<std::atomic<std::uint64_t>> dirty_;
+    std::unique_ptr<SpscRing<TickT>> ring_;
+
+    // Producer counters
+    alignas(kLine) std::atomic<std::uint64_t> published_{0};
+    std::atomic<std::uint64_t> conflated_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+    // Consumer state and counters
+    alignas(kLine) std::atomic<std::uint64_t> delivered_{0};
+    std::atomic<std::uint64_t> drains_{0};
+    std::atomic<std::uint64_t> max_batch_{0};
+    std::vector<std::uint64_t> lastSeq_;
+    std::int64_t lastDrainNs_ = 0;
+    bool drained_once_ = false;
+};
@@ -1,13 +1,16 @@
 #pragma once
 #include <map>
-#include <deque>
+#include <optional>
+#include <functional>
 #include <vector>
 #include <chrono>
 #include <type_traits>
 #include <cstdint>
 #include "Order.hpp"
 #include "OrderBook.hpp"
-#include "OrderManager.hpp"
+#include "OrderStore.hpp"
+#include "PooledOrderManager.hpp"
+#include "PoolAllocator.hpp"
 
 /// Simple trade record emitted by the engine.
 /// You can feed these to your TradeLogger in batches.
@@ -20,11 +23,48 @@ struct Trade {
     std::chrono::high_resolution_clock::time_point ts{};
 };
 
+/// One entry of a batched price replace (MatchingEngine::replaceBatch).
+template <typename PriceType, typename OrderIdType>
+struct ReplaceRequest {
+    OrderIdType id{};
+    PriceType   new_price{};
+};
+
+/// Intrusive doubly-linked FIFO of order records at one price (time priority).
+/// Links live in the record itself, so unlinking is O(1) from anywhere in the queue.
+template <typename RecordT>
+struct LevelQueue {
+    RecordT* head = nullptr;
+    RecordT* tail = nullptr;
+
+    bool empty() const noexcept { return head == nullptr; }
+
+    void push_back(RecordT* n) noexcept {
+        n->prev = tail;
+        n->next = nullptr;
+        if (tail) tail->next = n; else head = n;
+        tail = n;
+    }
+
+    void erase(RecordT* n) noexcept {
+        if (n->prev) n->prev->next = n->next; else head = n->next;
+        if (n->next) n->next->prev = n->prev; else tail = n->prev;
+        n->prev = n->next = nullptr;
+    }
+};
+
 /// MatchingEngine
-/// - Price/time priority using per-price FIFO queues
+/// - Price/time priority using per-price intrusive FIFO queues
 /// - Header-only template to match your templated Order/OMS/OrderBook setup
-/// - No hard dependency on a logger; returns trades to the caller
-template <typename PriceType, typename OrderIdType>
+/// - No hard dependency on a logger: trades go to a caller-supplied sink
+///   (any callable taking const TradeT&), or into a returned vector
+/// - BookT defaults to OrderBook<>, i.e. the flat ladder for integral tick prices
+/// - OmsT must expose the shared OrderStore records (PooledOrderManager):
+///   the engine's queues, the book's level totals and the OMS state are all
+///   driven from that one record, so a fill touches one record and no ID map
+template <typename PriceType, typename OrderIdType,
+          typename BookT = OrderBook<PriceType, OrderIdType>,
+          typename OmsT  = PooledOrderManager<PriceType, OrderIdType>>
 class MatchingEngine {
     static_assert(std::is_integral<OrderIdType>::value,
                   "OrderIdType must be integral");
@@ -32,36 +72,105 @@ class MatchingEngine {
 public:
     using OrderT  = Order<PriceType, OrderIdType>;
     using TradeT  = Trade<PriceType, OrderIdType>;
+    using RecordT = OrderRecord<PriceType, OrderIdType>;
     using Clock   = std::chrono::high_resolution_clock;
 
-    MatchingEngine(OrderBook<PriceType, OrderIdType>& book,
-                   OrderManager<PriceType, OrderIdType>& oms)
+    MatchingEngine(BookT& book, OmsT& oms)
         : book_(book), oms_(oms) {}
 
+    MatchingEngine(const MatchingEngine&) = delete; // side maps share levelPool_
+    MatchingEngine& operator=(const MatchingEngine&) = delete;
+
+    // Preallocate nodes for up to maxLevels price levels per side, so opening
+    // a level doesn't touch the heap. Takes a level count, not an order count.
+    void reserveLevels(std::size_t maxLevels) {
+        levelPool_.reserve(2 * maxLevels);
+        prewarmNodePool<BidMap>(levelPool_);
+    }
+
     // Submit a NEW order (id must not already exist in OMS).
     // Creates in OMS, inserts into book & internal queues, then tries to match.
-    // Returns all trades generated by this submission.
+    // Every trade is handed to sink(const TradeT&); returns the number of trades.
+    // No allocation once OMS and engine are reserved.
+    template <typename Sink>
+    std::size_t submit(const OrderT& incoming, Sink&& sink) {
+        // Create in OMS, then place into book & side queue (price-time priority)
+        RecordT& r = *oms_.record(oms_.create(incoming.id, incoming.price,
+                                              incoming.quantity, incoming.is_buy));
+        rest(r);
+
+        // Try to match aggressively
+        return match(incoming.is_buy, sink);
+    }
+
+    // Convenience: same as above, collecting trades into a fresh vector
     std::vector<TradeT> submit(const OrderT& incoming) {
         std::vector<TradeT> trades;
         trades.reserve(8); // heuristic; reduces early reallocs
+        submit(incoming, [&](const TradeT& t) { trades.push_back(t); });
+        return trades;
+    }
 
-        // Create in OMS and book
-        auto h = oms_.create(incoming.id, incoming.price, incoming.quantity, incoming.is_buy);
-        book_.newOrder(incoming);
-        id2side_[incoming.id] = incoming.is_buy;
+    // --- Batched entry --------------------------------------------------------
+    // Same result as calling submit/cancel/replacePrice per element, in order
+    // (each order rests and matches before the next is looked at, so price-time
+    // priority is unchanged). Per batch rather than per order:
+    // - one Clock::now(): every trade of the batch carries the same timestamp
+    // - while order i is matched, order i+1's ID-index bucket and the arena
+    //   record it will occupy are already being fetched
+    // Returns the total number of trades (cancelBatch: orders canceled).
+
+    template <typename Sink>
+    std::size_t submitBatch(const OrderT* orders, std::size_t n, Sink&& sink) {
+        const auto now = Clock::now();
+        std::size_t trades = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i + 1 < n) oms_.prefetchId(orders[i + 1].id);
+            const OrderT& o = orders[i];
+            RecordT& r = *oms_.record(oms_.create(o.id, o.price, o.quantity, o.is_buy));
+            oms_.prefetchCreate(); // the record the next create() takes
+            rest(r);
+            trades += match(o.is_buy, sink, now);
+        }
+        return trades;
+    }
 
-        // Place into appropriate side queue (price-time priority)
-        auto& sideBook = incoming.is_buy ? bids_ : asks_;
-        auto& q = sideBook[incoming.price];  // map creates level if missing
-        q.push_back(incoming.id);
-        id2price_[incoming.id] = incoming.price;
+    template <typename Sink>
+    std::size_t submitBatch(const std::vector<OrderT>& orders, Sink&& sink) {
+        return submitBatch(orders.data(), orders.size(), sink);
+    }
 
-        // Try to match aggressively
-        auto now = Clock::now();
-        if (incoming.is_buy) {
-            matchBuySide(trades, now);
-        } else {
-            matchSellSide(trades, now);
+    // Two-stage prefetch: index bucket two ahead, the record itself one ahead
+    std::size_t cancelBatch(const OrderIdType* ids, std::size_t n) {
+        std::size_t canceled = 0;
+        if (n > 1) oms_.prefetchId(ids[1]);
+        RecordT* next = n > 0 ? oms_.record(ids[0]) : nullptr;
+        for (std::size_t i = 0; i < n; ++i) {
+            RecordT* r = next;
+            if (i + 2 < n) oms_.prefetchId(ids[i + 2]);
+            next = (i + 1 < n) ? prefetchRecord(ids[i + 1]) : nullptr;
+            if (!r || !r->in_book) continue;
+            unlink(*r);
+            canceled += oms_.cancel(*r) ? 1 : 0;
+        }
+        return canceled;
+    }
+
+    template <typename Sink>
+    std::size_t replaceBatch(const ReplaceRequest<PriceType, OrderIdType>* reqs, std::size_t n, Sink&& sink) {
+        const auto now = Clock::now();
+        std::size_t trades = 0;
+        if (n > 1) oms_.prefetchId(reqs[1].id);
+        RecordT* next = n > 0 ? oms_.record(reqs[0].id) : nullptr;
+        for (std::size_t i = 0; i < n; ++i) {
+            RecordT* r = next;
+            if (i + 2 < n) oms_.prefetchId(reqs[i + 2].id);
+            next = (i + 1 < n) ? prefetchRecord(reqs[i + 1].id) : nullptr;
+            if (!r || !r->in_book) continue;
+            unlink(*r);
+            oms_.replacePrice(*r, reqs[i].new_price);
+            rest(*r);
+            trades += match(r->order.is_buy, sink, now);
         }
         return trades;
     }
@@ -69,289 +178,230 @@ public:
     // Cancel an existing order by ID. Removes from queues/book/OMS.
     // Returns true if something was canceled.
     bool cancel(OrderIdType id) {
-        auto itp = id2price_.find(id);
-        auto its = id2side_.find(id);
-        if (itp == id2price_.end() || its == id2side_.end()) return false;
-
-        const bool is_buy = its->second;
-        const PriceType px = itp->second;
-
-        auto& sideBook = is_buy ? bids_ : asks_;
-        auto lvlIt = sideBook.find(px);
-        if (lvlIt == sideBook.end()) return false;
-
-        // Remove id from the FIFO queue (linear within level, but queues are short in practice)
-        auto& dq = lvlIt->second;
-        for (auto it = dq.begin(); it != dq.end(); ++it) {
-            if (*it == id) {
-                dq.erase(it);
-                if (dq.empty()) sideBook.erase(lvlIt);
-                break;
-            }
-        }
-
-        // Update aggregates + OMS
-        const int rem = oms_.getRemainingQty(id);
-        if (rem > 0) {
-            // tell book we removed a live order
-            // emulate delete semantics on the aggregate book
-            OrderT dummy{id, PriceType{}, 0, is_buy};
-            dummy.price = px;
-            // reduce counts in book (using its public API)
-            book_.deleteOrder(id);
-        }
+        RecordT* r = oms_.record(id);
+        if (!r || !r->in_book) return false;
 
-        bool ok = oms_.cancel(id);
-        id2price_.erase(itp);
-        id2side_.erase(its);
-        return ok;
+        unlink(*r);
+        return oms_.cancel(*r);
     }
 
     // Replace price on an existing order: remove from old price queue, update OMS/Book, reinsert, re-match.
-    std::vector<TradeT> replacePrice(OrderIdType id, PriceType new_price) {
-        std::vector<TradeT> trades;
-        auto itp = id2price_.find(id);
-        auto its = id2side_.find(id);
-        if (itp == id2price_.end() || its == id2side_.end()) return trades;
-
-        const bool is_buy = its->second;
-        const PriceType old_px = itp->second;
-
-        // Remove from old level queue
-        auto& oldSide = is_buy ? bids_ : asks_;
-        auto lvlIt = oldSide.find(old_px);
-        if (lvlIt != oldSide.end()) {
-            auto& dq = lvlIt->second;
-            for (auto it = dq.begin(); it != dq.end(); ++it) {
-                if (*it == id) {
-                    dq.erase(it);
-                    if (dq.empty()) oldSide.erase(lvlIt);
-                    break;
-                }
-            }
-        }
+    template <typename Sink>
+    std::size_t replacePrice(OrderIdType id, PriceType new_price, Sink&& sink) {
+        RecordT* r = oms_.record(id);
+        if (!r || !r->in_book) return 0;
 
-        // Update OMS and Book aggregates
-        // Book: treat as delete from old price and add at new price keeping remaining qty
-        const int rem = oms_.getRemainingQty(id);
-        if (rem > 0) {
-            book_.deleteOrder(id);
-        }
-        oms_.replacePrice(id, new_price);
-
-        // Insert into new level queue and book
-        OrderT shadow{id, new_price, rem, is_buy};
-        book_.newOrder(shadow);
-
-        auto& newSide = is_buy ? bids_ : asks_;
-        newSide[new_price].push_back(id);
-        id2price_[id] = new_price;
+        // Remove from old level (loses time priority), reprice, rest at the new level
+        unlink(*r);
+        oms_.replacePrice(*r, new_price);
+        rest(*r);
 
         // Attempt to match after reprice
-        auto now = Clock::now();
-        if (is_buy) matchBuySide(trades, now);
-        else        matchSellSide(trades, now);
+        return match(r->order.is_buy, sink);
+    }
 
+    std::vector<TradeT> replacePrice(OrderIdType id, PriceType new_price) {
+        std::vector<TradeT> trades;
+        replacePrice(id, new_price, [&](const TradeT& t) { trades.push_back(t); });
         return trades;
     }
 
     // Convenience: submit using an existing OMS order handle (already created)
     // Useful if you want to separate creation from book placement.
+    template <typename Sink>
+    std::size_t addToBook(OrderIdType id, Sink&& sink) {
+        RecordT* r = oms_.record(id);
+        if (!r || r->in_book || !r->live() || r->order.quantity <= 0) return 0;
+
+        rest(*r);
+        return match(r->order.is_buy, sink);
+    }
+
     std::vector<TradeT> addToBook(OrderIdType id) {
         std::vector<TradeT> trades;
-        if (!oms_.exists(id)) return trades;
-        const bool is_buy = oms_.isBuy(id);
-        const PriceType px = oms_.getPrice(id);
-        const int rem = oms_.getRemainingQty(id);
-        if (rem <= 0) return trades;
-
-        OrderT shadow{id, px, rem, is_buy};
-        book_.newOrder(shadow);
-
-        auto& sideBook = is_buy ? bids_ : asks_;
-        sideBook[px].push_back(id);
-        id2price_[id] = px;
-        id2side_[id]  = is_buy;
-
-        auto now = Clock::now();
-        if (is_buy) matchBuySide(trades, now);
-        else        matchSellSide(trades, now);
+        addToBook(id, [&](const TradeT& t) { trades.push_back(t); });
         return trades;
     }
 
-    // For tests/metrics
-    PriceType bestBid() const { return const_cast<OrderBook<PriceType, OrderIdType>&>(book_).bestBid(); }
-    PriceType bestAsk() const { return const_cast<OrderBook<PriceType, OrderIdType>&>(book_).bestAsk(); }
+    // --- Snapshot / warm restart -------------------------------------------------
+    // fn(is_buy, price, const RecordT* head) per level, bids then asks, each
+    // side best first; follow head->next for the level's FIFO
+    template <typename Fn>
+    void forEachLevel(Fn&& fn) const {
+        for (const auto& lvl : bids_) fn(true, lvl.first, lvl.second.head);
+        for (const auto& lvl : asks_) fn(false, lvl.first, lvl.second.head);
+    }
+
+    // Append a restored record to the back of its level without matching and
+    // without touching the book (restore its level totals there directly).
+    // Records must arrive in forEachLevel() order, so every new level is
+    // placed with an O(1) end hint.
+    void restoreResting(RecordT& r) {
+        Level* lvl = hintLevel_;
+        if (!lvl || hintBuy_ != r.order.is_buy || !(hintPrice_ == r.order.price)) {
+            lvl = r.order.is_buy ? &bids_.emplace_hint(bids_.end(), r.order.price, Level{})->second
+                                 : &asks_.emplace_hint(asks_.end(), r.order.price, Level{})->second;
+            hintLevel_ = lvl;
+            hintPrice_ = r.order.price;
+            hintBuy_   = r.order.is_buy;
+        }
+        lvl->push_back(&r);
+        r.in_book = true;
+    }
+
+    std::size_t levelCount() const noexcept { return bids_.size() + asks_.size(); }
+
+    // For tests/metrics (O(1): read straight off the side maps)
+    // PriceType{} on an empty side, which is a real price for tick engines:
+    // test hasBid()/hasAsk() or use the optional forms
+    bool hasBid() const noexcept { return !bids_.empty(); }
+    bool hasAsk() const noexcept { return !asks_.empty(); }
+    PriceType bestBid() const { return bids_.empty() ? PriceType{} : bids_.begin()->first; }
+    PriceType bestAsk() const { return asks_.empty() ? PriceType{} : asks_.begin()->first; }
+    std::optional<PriceType> bestBidOpt() const {
+        return bids_.empty() ? std::nullopt : std::optional<PriceType>(bids_.begin()->first);
+    }
+    std::optional<PriceType> bestAskOpt() const {
+        return asks_.empty() ? std::nullopt : std::optional<PriceType>(asks_.begin()->first);
+    }
 
 private:
+    using Level   = LevelQueue<RecordT>;
+    using LevelAlloc = PoolAllocator<std::pair<const PriceType, Level>>;
+    using BidMap  = std::map<PriceType, Level, std::greater<PriceType>, LevelAlloc>; // begin() = highest bid
+    using AskMap  = std::map<PriceType, Level, std::less<PriceType>, LevelAlloc>;    // begin() = lowest ask
+
+    template <typename Sink>
+    std::size_t match(bool is_buy, Sink& sink) {
+        return match(is_buy, sink, Clock::now());
+    }
+
+    template <typename Sink>
+    std::size_t match(bool is_buy, Sink& sink, const typename Clock::time_point& now) {
+        return is_buy ? matchBuySide(sink, now) : matchSellSide(sink, now);
+    }
+
+    RecordT* prefetchRecord(OrderIdType id) noexcept {
+        RecordT* r = oms_.record(id);
+#if defined(__GNUC__) || defined(__clang__)
+        if (r) __builtin_prefetch(r, 1);
+#endif
+        return r;
+    }
+
     // BUY takes from lowest ask upward while ask <= aggressive buy price.
-    void matchBuySide(std::vector<TradeT>& out, const typename Clock::time_point& now) {
-        while (true) {
-            // Check top of book cross
-            PriceType best_ask = book_.bestAsk();
-            if (best_ask == PriceType{}) break; // no asks
-            // Best bid implied by the incoming/top-of-queue buy (we'll check price condition below)
-
-            // Find the earliest buy that can cross this ask
-            auto b_it = bestExecutableBuy(best_ask);
-            if (b_it == bids_.end()) break; // no buy that crosses
-
-            auto& buy_q  = b_it->second;
-            auto& sell_q = asks_[best_ask];
-            if (sell_q.empty() || buy_q.empty()) {
-                // Lazy clean-up if a level got stale
-                if (sell_q.empty()) asks_.erase(best_ask);
-                if (buy_q.empty())  bids_.erase(b_it);
-                break;
-            }
-
-            OrderIdType buy_id  = buy_q.front();
-            OrderIdType sell_id = sell_q.front();
-
-            int buy_rem  = oms_.getRemainingQty(buy_id);
-            int sell_rem = oms_.getRemainingQty(sell_id);
-            // if (buy_rem <= 0) { popFrontAndPrune(bids_, b_it); continue; }
-            if (buy_rem <= 0) {
-                buy_q.pop_front();
-                pruneLevelIfEmpty(bids_, b_it->first);
-                continue;
-            }
-
-            if (sell_rem <= 0) { sell_q.pop_front(); pruneLevelIfEmpty(asks_, best_ask); continue; }
-
-            const int exec = (buy_rem < sell_rem) ? buy_rem : sell_rem;
-
-            // Execute at passive price (best_ask) – typical limit order book rule
-            out.push_back({buy_id, sell_id, best_ask, exec, now});
-
-            // Apply fills in OMS; it updates remaining qty + state
-            oms_.fill(buy_id, exec);
-            oms_.fill(sell_id, exec);
-
-            // Update aggregate book levels
-            // We know exact orders and prices:
-            book_.amendOrder(buy_id,  oms_.getRemainingQty(buy_id));
-            book_.amendOrder(sell_id, oms_.getRemainingQty(sell_id));
-
-            // Remove fully filled orders from queues and book aggregates
-            if (oms_.getRemainingQty(buy_id) == 0) {
-                buy_q.pop_front();
-                pruneLevelIfEmpty(bids_, b_it->first);
-                book_.deleteOrder(buy_id);
-                id2price_.erase(buy_id);
-                id2side_.erase(buy_id);
-            }
-            if (oms_.getRemainingQty(sell_id) == 0) {
-                sell_q.pop_front();
-                pruneLevelIfEmpty(asks_, best_ask);
-                book_.deleteOrder(sell_id);
-                id2price_.erase(sell_id);
-                id2side_.erase(sell_id);
-            }
+    template <typename Sink>
+    std::size_t matchBuySide(Sink& sink, const typename Clock::time_point& now) {
+        std::size_t n = 0;
+        // bids_.begin() / asks_.begin() are always the top of each side: the cross check is O(1)
+        while (!bids_.empty() && !asks_.empty()) {
+            auto b_it = bids_.begin();
+            auto a_it = asks_.begin();
+            if (b_it->first < a_it->first) break; // no buy that crosses
+
+            RecordT* buy  = b_it->second.head;
+            RecordT* sell = a_it->second.head;
+            const int exec = (buy->order.quantity < sell->order.quantity) ? buy->order.quantity
+                                                                          : sell->order.quantity;
+
+            // Execute at passive price (best ask) – typical limit order book rule
+            sink(TradeT{buy->order.id, sell->order.id, a_it->first, exec, now});
+            ++n;
+            applyFill(bids_, b_it, *buy, exec);
+            applyFill(asks_, a_it, *sell, exec);
         }
+        return n;
     }
 
     // SELL takes from highest bid downward while bid >= aggressive sell price.
-    void matchSellSide(std::vector<TradeT>& out, const typename Clock::time_point& now) {
-        while (true) {
-            PriceType best_bid = book_.bestBid();
-            if (best_bid == PriceType{}) break; // no bids
-
-            // Find earliest sell that can cross this bid
-            auto s_it = bestExecutableSell(best_bid);
-            if (s_it == asks_.end()) break;
-
-            auto& sell_q = s_it->second;
-            auto& buy_q  = bids_[best_bid];
-            if (sell_q.empty() || buy_q.empty()) {
-                if (sell_q.empty()) asks_.erase(s_it);
-                if (buy_q.empty())  bids_.erase(best_bid);
-                break;
-            }
-
-            OrderIdType sell_id = sell_q.front();
-            OrderIdType buy_id  = buy_q.front();
-
-            int sell_rem = oms_.getRemainingQty(sell_id);
-            int buy_rem  = oms_.getRemainingQty(buy_id);
-            if (sell_rem <= 0) { sell_q.pop_front(); pruneLevelIfEmpty(asks_, s_it->first); continue; }
-            if (buy_rem  <= 0) { buy_q.pop_front();  pruneLevelIfEmpty(bids_, best_bid);    continue; }
-
-            const int exec = (sell_rem < buy_rem) ? sell_rem : buy_rem;
-
-            // Execute at passive price (best_bid)
-            out.push_back({buy_id, sell_id, best_bid, exec, now});
-
-            oms_.fill(sell_id, exec);
-            oms_.fill(buy_id,  exec);
-
-            book_.amendOrder(sell_id, oms_.getRemainingQty(sell_id));
-            book_.amendOrder(buy_id,  oms_.getRemainingQty(buy_id));
-
-            if (oms_.getRemainingQty(sell_id) == 0) {
-                sell_q.pop_front();
-                pruneLevelIfEmpty(asks_, s_it->first);
-                book_.deleteOrder(sell_id);
-                id2price_.erase(sell_id);
-                id2side_.erase(sell_id);
-            }
-            if (oms_.getRemainingQty(buy_id) == 0) {
-                buy_q.pop_front();
-                pruneLevelIfEmpty(bids_, best_bid);
-                book_.deleteOrder(buy_id);
-                id2price_.erase(buy_id);
-                id2side_.erase(buy_id);
-            }
+    template <typename Sink>
+    std::size_t matchSellSide(Sink& sink, const typename Clock::time_point& now) {
+        std::size_t n = 0;
+        while (!bids_.empty() && !asks_.empty()) {
+            auto s_it = asks_.begin();
+            auto b_it = bids_.begin();
+            if (b_it->first < s_it->first) break; // no sell that crosses
+
+            RecordT* sell = s_it->second.head;
+            RecordT* buy  = b_it->second.head;
+            const int exec = (sell->order.quantity < buy->order.quantity) ? sell->order.quantity
+                                                                          : buy->order.quantity;
+
+            // Execute at passive price (best bid)
+            sink(TradeT{buy->order.id, sell->order.id, b_it->first, exec, now});
+            ++n;
+            applyFill(asks_, s_it, *sell, exec);
+            applyFill(bids_, b_it, *buy, exec);
         }
+        return n;
     }
 
-    // Find the best buy level that crosses the given ask (buy price >= ask)
-    typename std::map<PriceType, std::deque<OrderIdType>>::iterator
-    bestExecutableBuy(PriceType ask_px) {
-        // Highest buy price that is >= ask_px -> last element with key >= ask_px
-        auto it = bids_.lower_bound(ask_px); // first key >= ask_px
-        if (it == bids_.end()) return bids_.end();
-        // We prefer highest price among those >= ask_px -> go to last element
-        // Since map is ascending, we need the last element from [it, end).
-        // But simpler: if there are higher prices, take the highest.
-        auto best = bids_.end();
-        for (auto jt = it; jt != bids_.end(); ++jt) best = jt;
-        return best;
+    // Fill the record at the front of a level: book total and OMS state from the
+    // same record, then drop it from the level once it is done.
+    template <typename SideMap>
+    void applyFill(SideMap& side, typename SideMap::iterator lvlIt, RecordT& r, int exec) {
+        book_.fillOrder(r.order, exec);
+        oms_.fill(r, exec);
+        if (r.order.quantity > 0) return;
+
+        lvlIt->second.erase(&r);
+        if (lvlIt->second.empty()) eraseLevel(side, lvlIt);
+        book_.deleteOrder(r.order);
+        r.in_book = false;
     }
 
-    // Find the best sell level that crosses the given bid (sell price <= bid)
-    typename std::map<PriceType, std::deque<OrderIdType>>::iterator
-    bestExecutableSell(PriceType bid_px) {
-        // Highest sell price that is <= bid_px -> last element strictly <= bid_px
-        auto it = asks_.upper_bound(bid_px); // first key > bid_px
-        if (it == asks_.begin()) return asks_.end();
-        --it; // now it->first <= bid_px
-        return it;
+    // Append a record to its level's FIFO and the book aggregates
+    // Bursts often rest at one price: the level of the last rest() is reused
+    // without a map lookup until any level is erased.
+    void rest(RecordT& r) {
+        Level* lvl = hintLevel_;
+        if (!lvl || hintBuy_ != r.order.is_buy || !(hintPrice_ == r.order.price)) {
+            lvl = r.order.is_buy ? &bids_[r.order.price] : &asks_[r.order.price]; // map creates level if missing
+            hintLevel_ = lvl;
+            hintPrice_ = r.order.price;
+            hintBuy_   = r.order.is_buy;
+        }
+        lvl->push_back(&r);
+        book_.newOrder(r.order);
+        r.in_book = true;
     }
 
-    // Helpers to prune empty levels
-    static void pruneLevelIfEmpty(std::map<PriceType, std::deque<OrderIdType>>& side, PriceType px) {
-        auto it = side.find(px);
-        if (it != side.end() && it->second.empty()) side.erase(it);
+    // Remove a record from its level (O(1)) and the book; prunes the level if it empties
+    void unlink(RecordT& r) {
+        if (r.order.is_buy) unlinkFrom(bids_, r);
+        else                unlinkFrom(asks_, r);
+        book_.deleteOrder(r.order);
+        r.in_book = false;
     }
 
-    static void popFrontAndPrune(std::map<PriceType, std::deque<OrderIdType>>& side, PriceType px) {
-        auto it = side.find(px);
-        if (it == side.end()) return;
-        if (!it->second.empty()) it->second.pop_front();
-        if (it->second.empty()) side.erase(it);
+    template <typename SideMap>
+    void unlinkFrom(SideMap& side, RecordT& r) {
+        auto lvlIt = side.find(r.order.price);
+        if (lvlIt == side.end()) return;
+        lvlIt->second.erase(&r);
+        if (lvlIt->second.empty()) eraseLevel(side, lvlIt);
     }
 
-private:
-    // Side books: price -> FIFO of order ids (price-time priority)
-    std::map<PriceType, std::deque<OrderIdType>> bids_; // highest price wins
-    std::map<PriceType, std::deque<OrderIdType>> asks_; // lowest price wins
+    template <typename SideMap>
+    void eraseLevel(SideMap& side, typename SideMap::iterator lvlIt) {
+        if (&lvlIt->second == hintLevel_) hintLevel_ = nullptr;
+        side.erase(lvlIt);
+    }
 
-    // Light lookups
-    std::unordered_map<OrderIdType, PriceType> id2price_;
-    std::unordered_map<OrderIdType, bool>      id2side_;
+private:
+    // Side books: price -> FIFO of resting records (price-time priority),
+    // each ordered so that begin() is the top of book. Map nodes for both
+    // sides come from levelPool_ (declared first, so it outlives the maps)
+    FixedPool levelPool_;
+    BidMap bids_{std::greater<PriceType>{}, LevelAlloc{levelPool_}}; // highest price wins
+    AskMap asks_{std::less<PriceType>{}, LevelAlloc{levelPool_}};    // lowest price wins
+
+    // Level of the last rest() (nullptr once that level is erased)
+    Level*    hintLevel_ = nullptr;
+    PriceType hintPrice_{};
+    bool      hintBuy_ = false;
 
     // External subsystems
-    OrderBook<PriceType, OrderIdType>& book_;
-    OrderManager<PriceType, OrderIdType>& oms_;
+    BookT& book_;
+    OmsT&  oms_;
 };
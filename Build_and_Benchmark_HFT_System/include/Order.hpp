@@ -5,7 +5,8 @@
 // Generic Order structure
 // -----------------------------------------------------------------------------
 // Template parameters:
-//   PriceType   -> usually double, but can be int (ticks) for performance tests
+//   PriceType   -> double, or an integral tick count (Ticks32/Ticks64, see
+//                  TickPrice.hpp) for exact level keys and the ladder book
 //   OrderIdType -> integer type (int, long, etc.)
 // -----------------------------------------------------------------------------
 
@@ -27,4 +28,10 @@ struct Order {
     Order() = default;
 };
 
-
+// Order lifecycle as tracked by the OMS
+enum class OrderState : unsigned char {
+    New,
+    PartiallyFilled,
+    Filled,
+    Canceled
+};
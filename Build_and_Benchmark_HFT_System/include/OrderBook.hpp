@@ -2,14 +2,15 @@
 
 #pragma once
 #include <map>
-#include <unordered_map>
-#include <queue>
+#include <optional>
 #include <vector>
 #include <cstdint>
-#include <memory>
+#include <functional>
 #include <type_traits>
 #include <algorithm>
+#include <cstddef>
 #include "Order.hpp"
+#include "PoolAllocator.hpp"
 
 /// Simple struct for each price level.
 /// Keeps total quantity and count of active orders at this price.
@@ -18,126 +19,642 @@ struct alignas(64) PriceLevel {
     int orderCount = 0;
 };
 
-/// Generic limit order book.
-/// - Template on price and order ID type.
-/// - Stores active price levels in std::map for ordering.
-/// - Keeps ID → price lookup in unordered_map for O(1) amend/delete.
-/// - Maintains lazy heaps for fast best bid/ask queries.
-/// - Uses pre-reserved containers for performance.
+/// One row of an L2 snapshot (topN) or delta stream.
+template <typename PriceType>
+struct DepthLevel {
+    PriceType price{};
+    int totalQty = 0;
+    int orderCount = 0;
+};
+
+/// Level change published by a book event: the level's new totals.
+/// orderCount == 0 means the level was removed.
+template <typename PriceType>
+struct DepthDelta {
+    PriceType price{};
+    int totalQty = 0;
+    int orderCount = 0;
+    bool is_buy = false;
+};
+
+/// Rows written by topN() per side.
+struct DepthCounts {
+    std::size_t bids = 0;
+    std::size_t asks = 0;
+};
+
+/// Fixed-capacity buffer of level deltas, filled by the book as levels change
+/// and drained by the consumer after each event (or batch of events).
+/// - Disabled (capacity 0) by default: publishing is one predictable branch
+/// - Consecutive changes to the same level collapse into one delta, so a
+///   fill that empties a level reports only its final state
+/// - Never allocates after enable(); when full it sets overflowed() and drops
+///   further deltas, and the consumer should resync from topN()
+template <typename PriceType>
+class DepthDeltaBuffer {
+public:
+    using DeltaT = DepthDelta<PriceType>;
+
+    void enable(std::size_t capacity) {
+        buf_.assign(capacity, DeltaT{});
+        clear();
+    }
+
+    bool enabled() const noexcept { return !buf_.empty(); }
+
+    void publish(bool is_buy, PriceType px, const PriceLevel& lvl) noexcept {
+        if (buf_.empty()) return;
+        if (size_ > 0) {
+            DeltaT& last = buf_[size_ - 1];
+            if (last.is_buy == is_buy && last.price == px) {
+                last.totalQty = lvl.totalQty;
+                last.orderCount = lvl.orderCount;
+                return;
+            }
+        }
+        if (size_ == buf_.size()) {
+            overflowed_ = true;
+            return;
+        }
+        buf_[size_++] = DeltaT{px, lvl.totalQty, lvl.orderCount, is_buy};
+    }
+
+    const DeltaT* begin() const noexcept { return buf_.data(); }
+    const DeltaT* end() const noexcept { return buf_.data() + size_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool overflowed() const noexcept { return overflowed_; }
+
+    void clear() noexcept {
+        size_ = 0;
+        overflowed_ = false;
+    }
+
+private:
+    std::vector<DeltaT> buf_;
+    std::size_t size_ = 0;
+    bool overflowed_ = false;
+};
+
+/// Generic limit order book (map backend).
+/// - Template on price and order ID type; works for any ordered PriceType.
+/// - Stores active price levels per side in std::map, ordered so begin() is top of book.
+/// - Holds no per-order state: callers pass the order record (price, side,
+///   remaining qty) from the shared OrderStore, and level totals are updated
+///   incrementally from it.
+/// - Level nodes come from a FixedPool, so after reserveLevels() opening and closing
+///   levels never touches the heap.
+/// - L2 output: topN() copies the top n levels per side (an in-order walk of n
+///   nodes from begin()), and with enableDepthDeltas() every level change is
+///   published to depthDeltas() as it happens.
 template <typename PriceType, typename OrderIdType>
-class OrderBook {
+class MapOrderBook {
     static_assert(std::is_integral<OrderIdType>::value,
                   "OrderIdType must be integral");
 
 public:
     using OrderT = Order<PriceType, OrderIdType>; // type alias for convenience
+    using LevelT = DepthLevel<PriceType>;
+    using DeltaBuffer = DepthDeltaBuffer<PriceType>;
+
+    MapOrderBook() = default;
+    MapOrderBook(const MapOrderBook&) = delete; // level maps share levelPool_
+    MapOrderBook& operator=(const MapOrderBook&) = delete;
 
     // --- Core API -----------------------------------------------------------
 
     void newOrder(const OrderT& o) {
-        auto& lvl = levels_[o.price]; //If the price doesn’t exist yet, the std::map automatically creates a new entry.
+        auto& lvl = levelFor(o); //If the price doesn’t exist yet, the std::map automatically creates a new entry.
         lvl.totalQty   += o.quantity;
         lvl.orderCount += 1;
-        id2price_[o.id] = o.price;
+        deltas_.publish(o.is_buy, o.price, lvl);
+    }
+
+    // o traded execQty: take it off o's level
+    void fillOrder(const OrderT& o, int execQty) {
+        auto& lvl = levelFor(o);
+        lvl.totalQty -= execQty;
+        deltas_.publish(o.is_buy, o.price, lvl);
+    }
+
+    // o.quantity is still the old quantity
+    void amendOrder(const OrderT& o, int newQty) {
+        auto& lvl = levelFor(o);
+        lvl.totalQty += newQty - o.quantity;
+        deltas_.publish(o.is_buy, o.price, lvl);
+    }
+
+    // Removes o (and whatever quantity it still has) from its level
+    void deleteOrder(const OrderT& o) {
+        if (o.is_buy) eraseFrom(bidLevels_, o);
+        else          eraseFrom(askLevels_, o);
+    }
+
+    // --- L2 depth -------------------------------------------------------------
+
+    /// Top n levels per side, best first, into caller arrays of >= n rows.
+    /// Touches only the first n nodes of each side; never allocates.
+    DepthCounts topN(std::size_t n, LevelT* bids, LevelT* asks) const noexcept {
+        return DepthCounts{copyTop(bidLevels_, n, bids), copyTop(askLevels_, n, asks)};
+    }
+
+    // Start publishing level deltas (capacity: deltas held between clears)
+    void enableDepthDeltas(std::size_t capacity = 256) { deltas_.enable(capacity); }
+
+    // Deltas since the last clearDepthDeltas(), in event order
+    const DeltaBuffer& depthDeltas() const noexcept { return deltas_; }
+    void clearDepthDeltas() noexcept { deltas_.clear(); }
 
-        if (o.is_buy) bidHeap_.push(o.price);
-        else          askHeap_.push(o.price);
+    // --- Queries ------------------------------------------------------------
+
+    // Explicit empty-side checks: PriceType{} is a real price for tick books
+    bool hasBid() const noexcept { return !bidLevels_.empty(); }
+    bool hasAsk() const noexcept { return !askLevels_.empty(); }
+
+    /// Return best bid (max price with active orders); PriceType{} if !hasBid()
+    PriceType bestBid() const noexcept {
+        return bidLevels_.empty() ? PriceType{} : bidLevels_.begin()->first;
+    }
+
+    /// Return best ask (min price with active orders); PriceType{} if !hasAsk()
+    PriceType bestAsk() const noexcept {
+        return askLevels_.empty() ? PriceType{} : askLevels_.begin()->first;
+    }
+
+    // Best prices with the empty side as nullopt
+    std::optional<PriceType> bestBidOpt() const noexcept {
+        return hasBid() ? std::optional<PriceType>(bestBid()) : std::nullopt;
+    }
+    std::optional<PriceType> bestAskOpt() const noexcept {
+        return hasAsk() ? std::optional<PriceType>(bestAsk()) : std::nullopt;
+    }
+
+    size_t orderCount(PriceType px) const {
+        return static_cast<size_t>(levelAt(bidLevels_, px).orderCount + levelAt(askLevels_, px).orderCount);
+    }
+
+    int totalVolume(PriceType px) const {
+        return levelAt(bidLevels_, px).totalQty + levelAt(askLevels_, px).totalQty;
+    }
+
+    size_t levelCount() const noexcept { return bidLevels_.size() + askLevels_.size(); } // getter function, const to not change anytghing and noexcept no exceptions thrown
+
+    // Recreate a level from snapshot totals (warm restart). Levels of a side
+    // arrive best first, so each is placed with an O(1) end hint.
+    void restoreLevel(bool is_buy, PriceType px, int totalQty, int orderCount) {
+        const PriceLevel lvl{totalQty, orderCount};
+        if (is_buy) bidLevels_.emplace_hint(bidLevels_.end(), px, lvl);
+        else        askLevels_.emplace_hint(askLevels_.end(), px, lvl);
     }
 
-    void amendOrder(OrderIdType id, int newQty) {
-        auto it = id2price_.find(id);
-        if (it == id2price_.end()) return; // unknown order
+    // --- Preallocation / tuning --------------------------------------------
+    // Nodes for up to maxLevels price levels per side (a level count, not orders)
+    void reserveLevels(size_t maxLevels) {
+        levelPool_.reserve(2 * maxLevels);
+        prewarmNodePool<decltype(bidLevels_)>(levelPool_);
+    }
 
-        PriceType px = it->second; // how to get price from order ID form an unordered_map
-        auto lvlIt = levels_.find(px);
-        if (lvlIt == levels_.end()) return;
+private:
+    using LevelAlloc = PoolAllocator<std::pair<const PriceType, PriceLevel>>;
 
+    PriceLevel& levelFor(const OrderT& o) {
+        return o.is_buy ? bidLevels_[o.price] : askLevels_[o.price];
+    }
+
+    template <typename LevelMap>
+    void eraseFrom(LevelMap& side, const OrderT& o) {
+        auto lvlIt = side.find(o.price);
+        if (lvlIt == side.end()) return;
         auto& lvl = lvlIt->second; // get the price level
-        int diff = newQty - getOrderQty(id); // naive placeholder
-        lvl.totalQty += diff;
-        // you'd also update stored order quantity if you kept per-order detail
-        id2qty_[id] = newQty;
-    }
-
-    void deleteOrder(OrderIdType id) {
-        auto it = id2price_.find(id);
-        if (it == id2price_.end()) return;
-
-        PriceType px = it->second;
-        auto lvlIt = levels_.find(px);
-        if (lvlIt != levels_.end()) {
-            auto& lvl = lvlIt->second; // get the price level
-            int q = getOrderQty(id);
-            lvl.totalQty   -= q;
-            lvl.orderCount -= 1;
-            if (lvl.orderCount <= 0) {
-                levels_.erase(lvlIt);
-            }
+        lvl.totalQty   -= o.quantity;
+        lvl.orderCount -= 1;
+        if (lvl.orderCount <= 0) {
+            deltas_.publish(o.is_buy, o.price, PriceLevel{});
+            side.erase(lvlIt);
+            return;
         }
-        id2price_.erase(it);
-        id2qty_.erase(id);
+        deltas_.publish(o.is_buy, o.price, lvl);
     }
 
-    // --- Queries ------------------------------------------------------------
+    template <typename LevelMap>
+    static std::size_t copyTop(const LevelMap& side, std::size_t n, LevelT* out) noexcept {
+        std::size_t k = 0;
+        for (auto it = side.begin(); k < n && it != side.end(); ++it, ++k)
+            out[k] = LevelT{it->first, it->second.totalQty, it->second.orderCount};
+        return k;
+    }
+
+    template <typename LevelMap>
+    static PriceLevel levelAt(const LevelMap& side, PriceType px) {
+        auto it = side.find(px);
+        return it != side.end() ? it->second : PriceLevel{};
+    }
+
+    // --- Data members -------------------------------------------------------
+    FixedPool levelPool_; // declared first: outlives both maps
+    std::map<PriceType, PriceLevel, std::greater<PriceType>, LevelAlloc> bidLevels_{
+        std::greater<PriceType>{}, LevelAlloc{levelPool_}}; // begin() = best bid
+    std::map<PriceType, PriceLevel, std::less<PriceType>, LevelAlloc> askLevels_{
+        std::less<PriceType>{}, LevelAlloc{levelPool_}};    // begin() = best ask
+    DeltaBuffer deltas_;
+};
+
+/// Flat price-ladder limit order book (integer tick prices only).
+/// - One contiguous array of PriceLevel per side, indexed by tick offset from base_.
+/// - The window is recentered (and grown, up to maxTicks) when a price falls
+///   outside it. A price the capped window can't cover along with the resting
+///   levels (a stray order millions of ticks away) gets a level in a sparse
+///   per-side overflow map, so one far price never allocates gigabytes.
+/// - Best bid/ask are tracked incrementally; a per-side bitmap of non-empty
+///   levels lets us jump over empty ticks when the top level empties.
+/// - Same public API as MapOrderBook (no per-order state; callers pass the
+///   order record), so MatchingEngine uses it unchanged.
+/// - topN() walks set bits of the occupancy bitmap from the best level, so a
+///   snapshot costs ~n levels plus the empty words skipped, not the ladder.
+template <typename PriceType, typename OrderIdType>
+class LadderOrderBook {
+    static_assert(std::is_integral<PriceType>::value,
+                  "LadderOrderBook requires integral (tick) prices");
+    static_assert(std::is_integral<OrderIdType>::value,
+                  "OrderIdType must be integral");
+
+public:
+    using OrderT = Order<PriceType, OrderIdType>;
+    using LevelT = DepthLevel<PriceType>;
+    using DeltaBuffer = DepthDeltaBuffer<PriceType>;
+
+    /// Default window cap: 256K ticks (16MB of levels per side). A price the
+    /// window can't reach together with the occupied ladder levels rests in
+    /// a sparse per-side overflow map instead of growing the arrays.
+    static constexpr std::size_t kDefaultMaxTicks = std::size_t{1} << 18;
+
+    explicit LadderOrderBook(std::size_t initialTicks = 4096, std::size_t maxTicks = kDefaultMaxTicks)
+        : maxTicks_(roundUpToWord(maxTicks)),
+          ticks_(std::min(roundUpToWord(initialTicks), roundUpToWord(maxTicks))) {}
+
+    // --- Core API -----------------------------------------------------------
 
-    /// Return best bid (max price with active orders)
-    PriceType bestBid() {
-        while (!bidHeap_.empty()) {
-            auto p = bidHeap_.top();
-            auto it = levels_.find(p); // gives you quantity and order count
-            if (it != levels_.end() && it->second.orderCount > 0)
-                return p;
-            bidHeap_.pop(); // lazy eviction
+    void newOrder(const OrderT& o) {
+        ensureCovers(o.price);
+        Side& side = sideFor(o.is_buy);
+        if (!inWindow(o.price)) {
+            PriceLevel& far = side.far[o.price];
+            if (far.orderCount == 0) ++levelCount_;
+            far.totalQty   += o.quantity;
+            far.orderCount += 1;
+            deltas_.publish(o.is_buy, o.price, far);
+            return;
         }
-        return PriceType{}; // no bids
+        const std::size_t idx = indexOf(o.price);
+
+        auto& lvl = side.levels[idx];
+        if (lvl.orderCount == 0) markOccupied(side, idx, o.is_buy);
+        lvl.totalQty   += o.quantity;
+        lvl.orderCount += 1;
+        deltas_.publish(o.is_buy, o.price, lvl);
     }
 
-    /// Return best ask (min price with active orders)
-    PriceType bestAsk() {
-        while (!askHeap_.empty()) {
-            auto p = askHeap_.top();
-            auto it = levels_.find(p);
-            if (it != levels_.end() && it->second.orderCount > 0)
-                return p;
-            askHeap_.pop(); // lazy eviction
+    // o traded execQty: take it off o's level
+    void fillOrder(const OrderT& o, int execQty) {
+        PriceLevel* lvl = find(o.is_buy, o.price);
+        if (!lvl) return;
+        lvl->totalQty -= execQty;
+        deltas_.publish(o.is_buy, o.price, *lvl);
+    }
+
+    // o.quantity is still the old quantity
+    void amendOrder(const OrderT& o, int newQty) {
+        PriceLevel* lvl = find(o.is_buy, o.price);
+        if (!lvl) return;
+        lvl->totalQty += newQty - o.quantity;
+        deltas_.publish(o.is_buy, o.price, *lvl);
+    }
+
+    // Removes o (and whatever quantity it still has) from its level
+    void deleteOrder(const OrderT& o) {
+        Side& side = sideFor(o.is_buy);
+        if (!inWindow(o.price)) {
+            auto it = side.far.find(o.price);
+            if (it == side.far.end() || it->second.orderCount <= 0) return;
+            it->second.totalQty   -= o.quantity;
+            it->second.orderCount -= 1;
+            if (it->second.orderCount > 0) {
+                deltas_.publish(o.is_buy, o.price, it->second);
+                return;
+            }
+            side.far.erase(it);
+            --levelCount_;
+            deltas_.publish(o.is_buy, o.price, PriceLevel{});
+            return;
+        }
+        const std::size_t idx = indexOf(o.price);
+
+        auto& lvl = side.levels[idx];
+        if (lvl.orderCount <= 0) return;
+        lvl.totalQty   -= o.quantity;
+        lvl.orderCount -= 1;
+        if (lvl.orderCount <= 0) {
+            lvl = PriceLevel{};
+            markEmpty(side, idx, o.is_buy);
         }
-        return PriceType{}; // no asks
+        deltas_.publish(o.is_buy, o.price, lvl);
+    }
+
+    // --- L2 depth -------------------------------------------------------------
+
+    /// Top n levels per side, best first, into caller arrays of >= n rows.
+    /// Never allocates.
+    DepthCounts topN(std::size_t n, LevelT* bids, LevelT* asks) const noexcept {
+        DepthCounts c;
+        auto put = [](LevelT* out, std::size_t& k, PriceType px, const PriceLevel& lvl) {
+            out[k++] = LevelT{px, lvl.totalQty, lvl.orderCount};
+        };
+        // Overflow levels lie wholly above or below the window
+        auto fb = bids_.far.rbegin();
+        for (; fb != bids_.far.rend() && fb->first > windowTop() && c.bids < n; ++fb)
+            put(bids, c.bids, fb->first, fb->second);
+        for (std::ptrdiff_t i = bids_.best; i >= 0 && c.bids < n; i = prevSet(bids_.occupied, i - 1))
+            put(bids, c.bids, priceOf(static_cast<std::size_t>(i)), bids_.levels[static_cast<std::size_t>(i)]);
+        for (; fb != bids_.far.rend() && c.bids < n; ++fb) put(bids, c.bids, fb->first, fb->second);
+
+        auto fa = asks_.far.begin();
+        for (; fa != asks_.far.end() && fa->first < base_ && c.asks < n; ++fa)
+            put(asks, c.asks, fa->first, fa->second);
+        for (std::ptrdiff_t i = asks_.best; i >= 0 && c.asks < n;
+             i = nextSet(asks_.occupied, static_cast<std::size_t>(i) + 1))
+            put(asks, c.asks, priceOf(static_cast<std::size_t>(i)), asks_.levels[static_cast<std::size_t>(i)]);
+        for (; fa != asks_.far.end() && c.asks < n; ++fa) put(asks, c.asks, fa->first, fa->second);
+        return c;
+    }
+
+    // Start publishing level deltas (capacity: deltas held between clears)
+    void enableDepthDeltas(std::size_t capacity = 256) { deltas_.enable(capacity); }
+
+    // Deltas since the last clearDepthDeltas(), in event order
+    const DeltaBuffer& depthDeltas() const noexcept { return deltas_; }
+    void clearDepthDeltas() noexcept { deltas_.clear(); }
+
+    // --- Queries ------------------------------------------------------------
+
+    // Explicit empty-side checks: tick 0 is a valid ladder price
+    bool hasBid() const noexcept { return bids_.best >= 0 || !bids_.far.empty(); }
+    bool hasAsk() const noexcept { return asks_.best >= 0 || !asks_.far.empty(); }
+
+    /// Return best bid (max price with active orders), O(1); PriceType{} if !hasBid()
+    PriceType bestBid() const noexcept {
+        if (!bids_.far.empty() && (bids_.best < 0 || bids_.far.rbegin()->first > windowTop()))
+            return bids_.far.rbegin()->first;
+        return bids_.best < 0 ? PriceType{} : priceOf(static_cast<std::size_t>(bids_.best));
+    }
+
+    /// Return best ask (min price with active orders), O(1); PriceType{} if !hasAsk()
+    PriceType bestAsk() const noexcept {
+        if (!asks_.far.empty() && (asks_.best < 0 || asks_.far.begin()->first < base_))
+            return asks_.far.begin()->first;
+        return asks_.best < 0 ? PriceType{} : priceOf(static_cast<std::size_t>(asks_.best));
+    }
+
+    // Best prices with the empty side as nullopt
+    std::optional<PriceType> bestBidOpt() const noexcept {
+        return hasBid() ? std::optional<PriceType>(bestBid()) : std::nullopt;
+    }
+    std::optional<PriceType> bestAskOpt() const noexcept {
+        return hasAsk() ? std::optional<PriceType>(bestAsk()) : std::nullopt;
     }
 
     size_t orderCount(PriceType px) const {
-        auto it = levels_.find(px);
-        return (it != levels_.end()) ? it->second.orderCount : 0;
+        const PriceLevel *b = find(true, px), *a = find(false, px);
+        return static_cast<size_t>((b ? b->orderCount : 0) + (a ? a->orderCount : 0));
     }
 
     int totalVolume(PriceType px) const {
-        auto it = levels_.find(px);
-        return (it != levels_.end()) ? it->second.totalQty : 0;
+        const PriceLevel *b = find(true, px), *a = find(false, px);
+        return (b ? b->totalQty : 0) + (a ? a->totalQty : 0);
     }
 
-    size_t levelCount() const noexcept { return levels_.size(); } // getter function, const to not change anytghing and noexcept no exceptions thrown
+    // Levels held in the sparse overflow maps (outside the ladder window)
+    size_t overflowLevelCount() const noexcept { return bids_.far.size() + asks_.far.size(); }
+
+    size_t levelCount() const noexcept { return levelCount_; } // non-empty levels across both sides
+
+    // Recreate a level from snapshot totals (warm restart)
+    void restoreLevel(bool is_buy, PriceType px, int totalQty, int orderCount) {
+        ensureCovers(px);
+        Side& side = sideFor(is_buy);
+        if (!inWindow(px)) {
+            PriceLevel& far = side.far[px];
+            if (far.orderCount == 0) ++levelCount_;
+            far = PriceLevel{totalQty, orderCount};
+            return;
+        }
+        const std::size_t idx = indexOf(px);
+        if (side.levels[idx].orderCount == 0) markOccupied(side, idx, is_buy);
+        side.levels[idx] = PriceLevel{totalQty, orderCount};
+    }
 
     // --- Preallocation / tuning --------------------------------------------
-    void reserve(size_t maxOrders) {
-        id2price_.reserve(maxOrders);
-        id2qty_.reserve(maxOrders);
+    // Widen the ladder to at least maxLevels ticks, up to the window cap
+    // (arrays are built on the first order)
+    void reserveLevels(size_t maxLevels) {
+        if (bids_.levels.empty()) ticks_ = std::min(maxTicks_, std::max(ticks_, roundUpToWord(maxLevels)));
     }
 
+    // Pre-size the ladder so [lo, hi] never triggers a recenter.
+    void reserveTicks(PriceType lo, PriceType hi) {
+        ensureCovers(lo);
+        ensureCovers(hi);
+    }
+
+    size_t tickCapacity() const noexcept { return ticks_; }
+    size_t maxTickCapacity() const noexcept { return maxTicks_; }
+
 private:
-    // Helper: naive stub — could link to actual Order objects in OMS
-    int getOrderQty(OrderIdType id) const {
-        auto it = id2qty_.find(id);
-        return (it != id2qty_.end()) ? it->second : 0;
+    struct Side {
+        std::vector<PriceLevel> levels;     // index = price - base_
+        std::vector<std::uint64_t> occupied; // bit i set <=> levels[i].orderCount > 0
+        std::ptrdiff_t best = -1;           // index of top level, -1 if no ladder level
+        std::map<PriceType, PriceLevel> far; // levels outside the window (cold, sparse)
+    };
+
+    static constexpr std::size_t kWordBits = 64;
+
+    static std::size_t roundUpToWord(std::size_t n) {
+        if (n < kWordBits) n = kWordBits;
+        return (n + kWordBits - 1) / kWordBits * kWordBits;
+    }
+
+    Side& sideFor(bool is_buy) noexcept { return is_buy ? bids_ : asks_; }
+
+    bool inWindow(PriceType px) const noexcept {
+        if (bids_.levels.empty()) return false;
+        const long long off = static_cast<long long>(px) - static_cast<long long>(base_);
+        return off >= 0 && static_cast<std::size_t>(off) < ticks_;
+    }
+
+    // Highest price inside the window
+    PriceType windowTop() const noexcept {
+        return static_cast<PriceType>(static_cast<long long>(base_) + static_cast<long long>(ticks_) - 1);
+    }
+
+    // The level for px on one side, in the window or the overflow map; nullptr if none
+    const PriceLevel* find(bool is_buy, PriceType px) const {
+        const Side& side = is_buy ? bids_ : asks_;
+        if (inWindow(px)) return &side.levels[indexOf(px)];
+        auto it = side.far.find(px);
+        return it == side.far.end() ? nullptr : &it->second;
+    }
+    PriceLevel* find(bool is_buy, PriceType px) {
+        return const_cast<PriceLevel*>(static_cast<const LadderOrderBook*>(this)->find(is_buy, px));
+    }
+
+    std::size_t indexOf(PriceType px) const noexcept {
+        return static_cast<std::size_t>(static_cast<long long>(px) - static_cast<long long>(base_));
+    }
+
+    PriceType priceOf(std::size_t idx) const noexcept {
+        return static_cast<PriceType>(static_cast<long long>(base_) + static_cast<long long>(idx));
+    }
+
+    void markOccupied(Side& side, std::size_t idx, bool is_buy) {
+        side.occupied[idx / kWordBits] |= (std::uint64_t{1} << (idx % kWordBits));
+        const auto i = static_cast<std::ptrdiff_t>(idx);
+        if (side.best < 0 || (is_buy ? i > side.best : i < side.best)) side.best = i;
+        ++levelCount_;
+    }
+
+    void markEmpty(Side& side, std::size_t idx, bool is_buy) {
+        side.occupied[idx / kWordBits] &= ~(std::uint64_t{1} << (idx % kWordBits));
+        --levelCount_;
+        if (static_cast<std::ptrdiff_t>(idx) != side.best) return;
+        // Top level emptied: skip straight to the next occupied tick.
+        side.best = is_buy ? prevSet(side.occupied, static_cast<std::ptrdiff_t>(idx) - 1)
+                           : nextSet(side.occupied, idx + 1);
+    }
+
+    // Highest set bit at index <= from, or -1.
+    static std::ptrdiff_t prevSet(const std::vector<std::uint64_t>& bits, std::ptrdiff_t from) {
+        if (from < 0) return -1;
+        std::ptrdiff_t w = from / static_cast<std::ptrdiff_t>(kWordBits);
+        const unsigned shift = static_cast<unsigned>(kWordBits - 1 - from % kWordBits);
+        std::uint64_t word = (bits[static_cast<std::size_t>(w)] << shift) >> shift; // drop bits above 'from'
+        while (true) {
+            if (word) return w * static_cast<std::ptrdiff_t>(kWordBits) + highestBit(word);
+            if (--w < 0) return -1;
+            word = bits[static_cast<std::size_t>(w)];
+        }
+    }
+
+    // Lowest set bit at index >= from, or -1.
+    static std::ptrdiff_t nextSet(const std::vector<std::uint64_t>& bits, std::size_t from) {
+        std::size_t w = from / kWordBits;
+        if (w >= bits.size()) return -1;
+        std::uint64_t word = bits[w] & (~std::uint64_t{0} << (from % kWordBits)); // drop bits below 'from'
+        while (true) {
+            if (word) return static_cast<std::ptrdiff_t>(w * kWordBits) + lowestBit(word);
+            if (++w >= bits.size()) return -1;
+            word = bits[w];
+        }
+    }
+
+    static int highestBit(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(x);
+#else
+        int i = 63;
+        while (!(x >> i)) --i;
+        return i;
+#endif
+    }
+
+    static int lowestBit(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#else
+        int i = 0;
+        while (!((x >> i) & 1u)) ++i;
+        return i;
+#endif
+    }
+
+    // Make sure px maps into the window if the capped window can hold it
+    // together with every occupied ladder level; recenters (and grows up to
+    // maxTicks_) then. Otherwise px stays outside and its level goes to the
+    // overflow map. Cold path: only runs when the market walks outside the band.
+    void ensureCovers(PriceType px) {
+        if (inWindow(px)) return;
+
+        const long long p = static_cast<long long>(px);
+        long long lo = p, hi = p;
+        // Keep every occupied ladder level inside the new window
+        auto widen = [&](const Side& s) {
+            if (s.best < 0) return;
+            const std::ptrdiff_t first = nextSet(s.occupied, 0);
+            const std::ptrdiff_t last  = prevSet(s.occupied, static_cast<std::ptrdiff_t>(ticks_) - 1);
+            lo = std::min(lo, static_cast<long long>(base_) + first);
+            hi = std::max(hi, static_cast<long long>(base_) + last);
+        };
+        widen(bids_);
+        widen(asks_);
+
+        const auto span = static_cast<unsigned long long>(hi - lo) + 1;
+        if (span > maxTicks_) return; // too far from the resting band: overflow map
+
+        std::size_t newTicks = ticks_;
+        while (newTicks < 2 * span && newTicks < maxTicks_) newTicks *= 2; // headroom on both sides
+        newTicks = std::min(newTicks, maxTicks_);
+        const long long newBase = lo - static_cast<long long>((newTicks - span) / 2);
+
+        rebuild(bids_, newTicks, newBase);
+        rebuild(asks_, newTicks, newBase);
+        base_  = static_cast<PriceType>(newBase);
+        ticks_ = newTicks;
+        adoptOverflow(bids_, true);
+        adoptOverflow(asks_, false);
+    }
+
+    // Move overflow levels the (new) window now covers into the ladder
+    void adoptOverflow(Side& side, bool is_buy) {
+        for (auto it = side.far.lower_bound(base_); it != side.far.end() && it->first <= windowTop();) {
+            const std::size_t idx = indexOf(it->first);
+            side.levels[idx] = it->second;
+            markOccupied(side, idx, is_buy);
+            --levelCount_; // already counted while in the overflow map
+            it = side.far.erase(it);
+        }
+    }
+
+    void rebuild(Side& side, std::size_t newTicks, long long newBase) {
+        Side fresh;
+        fresh.far = std::move(side.far);
+        fresh.levels.assign(newTicks, PriceLevel{});
+        fresh.occupied.assign(newTicks / kWordBits, 0);
+
+        if (!side.levels.empty()) {
+            const long long shift = static_cast<long long>(base_) - newBase;
+            for (std::ptrdiff_t i = nextSet(side.occupied, 0); i >= 0;
+                 i = nextSet(side.occupied, static_cast<std::size_t>(i) + 1)) {
+                const auto j = static_cast<std::size_t>(i + shift);
+                fresh.levels[j] = side.levels[static_cast<std::size_t>(i)];
+                fresh.occupied[j / kWordBits] |= (std::uint64_t{1} << (j % kWordBits));
+            }
+            if (side.best >= 0) fresh.best = side.best + static_cast<std::ptrdiff_t>(shift);
+        }
+        side = std::move(fresh);
     }
 
     // --- Data members -------------------------------------------------------
-    std::map<PriceType, PriceLevel> levels_;             // active price levels
-    std::unordered_map<OrderIdType, PriceType> id2price_; // order → price
-    std::unordered_map<OrderIdType, int> id2qty_;         // order → quantity
-
-    // Heaps for top-of-book
-    std::priority_queue<PriceType> bidHeap_; // max-heap
-    std::priority_queue<PriceType,
-                        std::vector<PriceType>,
-                        std::greater<PriceType>> askHeap_; // min-heap
+    PriceType   base_{};          // price of index 0
+    std::size_t maxTicks_;        // window cap (multiple of 64)
+    std::size_t ticks_;           // window width in ticks (multiple of 64)
+    std::size_t levelCount_ = 0;  // non-empty levels across both sides
+    Side bids_;
+    Side asks_;
+    DeltaBuffer deltas_;
 };
 
+/// OrderBook<PriceType, OrderIdType> picks the backend from the price type:
+/// integral tick prices get the flat ladder, everything else the std::map book.
+template <typename PriceType, typename OrderIdType>
+using OrderBook = std::conditional_t<std::is_integral<PriceType>::value,
+                                     LadderOrderBook<PriceType, OrderIdType>,
+                                     MapOrderBook<PriceType, OrderIdType>>;
@@ -0,0 +1,304 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "IdIndex.hpp"
+#include "MatchingEngine.hpp"
+#include "OrderBook.hpp"
+#include "PooledOrderManager.hpp"
+#include "SpscRing.hpp"
+#include "ThreadAffinity.hpp"
+#include "TscClock.hpp"
+
+/// Command sent from a strategy thread to the matcher.
+template <typename PriceType, typename OrderIdType>
+struct GatewayCommand {
+    enum class Kind : std::uint8_t { New, Cancel, Replace };
+
+    Kind          kind = Kind::New;
+    bool          is_buy = false;     // New
+    int           quantity = 0;       // New
+    OrderIdType   id{};
+    PriceType     price{};            // New / Replace
+    std::uint64_t enqueue_tsc = 0;    // TscClock::start() at enqueue, echoed in responses
+};
+
+/// Message sent back from the matcher to the producer that owns an order.
+template <typename PriceType, typename OrderIdType>
+struct GatewayResponse {
+    // Reject: a New whose id is still live, or a Replace of an order this
+    // producer doesn't own; the command had no effect
+    enum class Kind : std::uint8_t { Fill, CancelAck, CancelReject, Reject };
+
+    Kind          kind = Kind::Fill;
+    bool          aggressor = false;  // Fill: this producer's command caused the trade
+    bool          first_fill = false; // Fill: first trade produced by that command
+    OrderIdType   id{};               // this producer's order the response is about
+    std::uint64_t enqueue_tsc = 0;    // enqueue stamp of the command being answered
+    Trade<PriceType, OrderIdType> trade{};
+};
+
+/// Counters owned by the matcher thread; read them after stop().
+struct GatewayStats {
+    std::uint64_t commands = 0;
+    std::uint64_t trades = 0;
+    std::uint64_t batches = 0;          // non-empty drain passes over the request rings
+    std::uint64_t response_stalls = 0;  // responses that waited on a full response ring
+    std::uint64_t throttled = 0;        // lane skips: too little response room to read commands
+    std::uint64_t rejects = 0;          // commands refused: duplicate New id or not the owner
+};
+
+/// Multi-producer order gateway in front of a single-threaded MatchingEngine.
+/// - One SPSC request ring and one SPSC response ring per producer: producers
+///   never contend with each other, only with the matcher
+/// - A dedicated matcher thread (optionally pinned) owns book, OMS and engine,
+///   drains the request rings round-robin in batches, and routes each fill to
+///   the producers owning the buy and sell orders
+/// - The matcher reserves book/OMS/engine itself after pinning, so their
+///   arenas are first-touched on its NUMA node; start() returns once it has
+/// - Producer p may only call submit/try_submit/poll with its own index, and
+///   may only cancel/replace its own orders; anything else is rejected
+/// - A New whose id is still live is rejected; ids may be reused once the
+///   order has filled or been canceled
+/// - Responses are never dropped; a producer that falls behind gets
+///   backpressure instead. The matcher stops reading a producer's commands
+///   while its response ring has less than kResponseHeadroom free slots, and
+///   a response that still finds the ring full waits for the producer.
+///   Producers must keep polling (submit() does while it waits)
+template <typename PriceType, typename OrderIdType>
+class OrderGateway {
+public:
+    using CommandT  = GatewayCommand<PriceType, OrderIdType>;
+    using ResponseT = GatewayResponse<PriceType, OrderIdType>;
+    using OrderT    = Order<PriceType, OrderIdType>;
+    using TradeT    = Trade<PriceType, OrderIdType>;
+    using Book      = OrderBook<PriceType, OrderIdType>;
+    using OMS       = PooledOrderManager<PriceType, OrderIdType>;
+    using Engine    = MatchingEngine<PriceType, OrderIdType>;
+
+    static constexpr std::size_t kDrainBatch = 64; // commands taken per ring per pass
+    static constexpr std::size_t kResponseHeadroom = 2 * kDrainBatch; // free response slots to read a lane
+
+    OrderGateway(std::size_t producers, std::size_t ring_capacity = 4096,
+                 std::size_t max_orders = 1 << 20, int matcher_cpu = -1,
+                 std::size_t max_levels = 4096)
+        : matcherCpu_(matcher_cpu), maxOrders_(max_orders), maxLevels_(max_levels),
+          engine_(book_, oms_) {
+        // Room for a full batch's responses on top of the read headroom
+        if (ring_capacity < 2 * kResponseHeadroom) ring_capacity = 2 * kResponseHeadroom;
+        trades_.reserve(256);
+        lanes_.reserve(producers);
+        for (std::size_t p = 0; p < producers; ++p)
+            lanes_.push_back(std::make_unique<Lane>(ring_capacity));
+    }
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    ~OrderGateway() { stop(); }
+
+    void start() {
+        if (matcher_.joinable()) return;
+        stop_.store(false, std::memory_order_relaxed);
+        done_.store(false, std::memory_order_relaxed);
+        ready_.store(false, std::memory_order_relaxed);
+        matcher_ = std::thread([this] { run(); });
+        while (!ready_.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
+    // Drain every queued command, then join the matcher. Producers must keep
+    // polling until stopped() so the matcher can hand off the last fills.
+    void stop() {
+        if (!matcher_.joinable()) return;
+        stop_.store(true, std::memory_order_release);
+        matcher_.join();
+    }
+
+    // True once the matcher has exited; no more responses will arrive
+    bool stopped() const noexcept { return done_.load(std::memory_order_acquire); }
+
+    // --- Producer side (producer p only) ------------------------------------
+    bool try_submit(std::size_t p, const CommandT& c) noexcept { return lanes_[p]->requests.try_push(c); }
+
+    // Blocking submit. While the request ring is full the producer keeps
+    // draining its own responses into on_response(const ResponseT&): the
+    // matcher may be waiting on exactly that ring.
+    template <typename F>
+    void submit(std::size_t p, const CommandT& c, F&& on_response) {
+        Backoff wait;
+        while (!try_submit(p, c)) {
+            if (poll(p, on_response) == 0) wait.pause();
+        }
+    }
+
+    // Hand up to max responses to f(const ResponseT&); returns how many
+    template <typename F>
+    std::size_t poll(std::size_t p, F&& f, std::size_t max = 256) {
+        return lanes_[p]->responses.consume(f, max);
+    }
+
+    std::size_t producers() const noexcept { return lanes_.size(); }
+
+    // --- After stop() -------------------------------------------------------
+    const GatewayStats& stats() const noexcept { return stats_; }
+    const Book& book() const noexcept { return book_; }
+    const Engine& engine() const noexcept { return engine_; }
+
+private:
+    static constexpr std::uint32_t kNoOwner = IdIndex<OrderIdType>::npos;
+
+    struct Lane {
+        explicit Lane(std::size_t cap) : requests(cap), responses(cap) {}
+        SpscRing<CommandT>  requests;  // producer -> matcher
+        SpscRing<ResponseT> responses; // matcher -> producer
+    };
+
+    void run() {
+        if (matcherCpu_ >= 0) pin_current_thread(matcherCpu_);
+        if (!reserved_) {
+            oms_.reserve(maxOrders_);
+            book_.reserveLevels(maxLevels_);
+            engine_.reserveLevels(maxLevels_);
+            owners_.reserve(maxOrders_);
+            reserved_ = true;
+        }
+        ready_.store(true, std::memory_order_release);
+        Backoff idle;
+        while (true) {
+            // Read the flag before draining: anything enqueued before stop() is
+            // then guaranteed to be visible to this pass
+            const bool stopping = stop_.load(std::memory_order_acquire);
+            std::size_t n = 0;
+            bool held = false; // a throttled lane still has commands
+            for (std::size_t p = 0; p < lanes_.size(); ++p) {
+                Lane& lane = *lanes_[p];
+                if (!hasResponseRoom(lane)) {
+                    ++stats_.throttled;
+                    held = held || !lane.requests.empty();
+                    continue;
+                }
+                n += lane.requests.consume(
+                    [&](const CommandT& c) { execute(static_cast<std::uint32_t>(p), c); }, kDrainBatch);
+            }
+            if (n > 0) {
+                stats_.commands += n;
+                ++stats_.batches;
+                idle.reset();
+                continue;
+            }
+            if (stopping && !held) break; // all rings were empty
+            idle.pause();
+        }
+        done_.store(true, std::memory_order_release);
+    }
+
+    void execute(std::uint32_t p, const CommandT& c) {
+        trades_.clear();
+        auto collect = [this](const TradeT& t) { trades_.push_back(t); };
+
+        switch (c.kind) {
+        case CommandT::Kind::New:
+            // A live id would re-link its resting record and corrupt the level FIFO
+            if (owners_.find(c.id) != kNoOwner) { reject(p, c, ResponseT::Kind::Reject); return; }
+            owners_.insert(c.id, p);
+            engine_.submit(OrderT{c.id, c.price, c.quantity, c.is_buy}, collect);
+            break;
+        case CommandT::Kind::Replace:
+            if (owners_.find(c.id) != p) { reject(p, c, ResponseT::Kind::Reject); return; }
+            engine_.replacePrice(c.id, c.price, collect);
+            break;
+        case CommandT::Kind::Cancel: {
+            if (owners_.find(c.id) != p) { reject(p, c, ResponseT::Kind::CancelReject); return; }
+            ResponseT r;
+            r.kind = engine_.cancel(c.id) ? ResponseT::Kind::CancelAck : ResponseT::Kind::CancelReject;
+            r.enqueue_tsc = c.enqueue_tsc;
+            r.id = c.id;
+            if (r.kind == ResponseT::Kind::CancelAck) owners_.erase(c.id);
+            respond(p, r);
+            return;
+        }
+        }
+
+        // Fills were collected first, so an order's OMS state is already final
+        // while its earlier trades are routed: forget filled orders only once
+        // every trade of the command has been sent
+        bool first = true;
+        for (const TradeT& t : trades_) {
+            route(t, t.buy_id,  c, p, first);
+            route(t, t.sell_id, c, p, first);
+            first = false;
+        }
+        for (const TradeT& t : trades_) {
+            if (oms_.state(t.buy_id)  == OrderState::Filled) owners_.erase(t.buy_id);
+            if (oms_.state(t.sell_id) == OrderState::Filled) owners_.erase(t.sell_id);
+        }
+        stats_.trades += trades_.size();
+    }
+
+    // Send one side of a trade to the producer owning `id`
+    void route(const TradeT& t, OrderIdType id, const CommandT& c, std::uint32_t p, bool first) {
+        const std::uint32_t owner = owners_.find(id);
+        if (owner == kNoOwner) return;
+
+        ResponseT r;
+        r.kind = ResponseT::Kind::Fill;
+        r.aggressor = (id == c.id && owner == p);
+        r.first_fill = first && r.aggressor;
+        r.id = id;
+        r.enqueue_tsc = r.aggressor ? c.enqueue_tsc : 0;
+        r.trade = t;
+        respond(owner, r);
+    }
+
+    void reject(std::uint32_t p, const CommandT& c, typename ResponseT::Kind kind) {
+        ResponseT r;
+        r.kind = kind;
+        r.id = c.id;
+        r.enqueue_tsc = c.enqueue_tsc;
+        ++stats_.rejects;
+        respond(p, r);
+    }
+
+    // Cached occupancy first; the shared index is re-read only when short
+    static bool hasResponseRoom(Lane& lane) noexcept {
+        SpscRing<ResponseT>& ring = lane.responses;
+        if (ring.capacity() - ring.producer_size() >= kResponseHeadroom) return true;
+        return ring.capacity() - ring.producer_refresh() >= kResponseHeadroom;
+    }
+
+    // A fill or ack is never dropped: the order is already matched, so wait
+    // for the owner to poll (Backpressure::Block, as in AsyncTradeLogger).
+    // The read headroom makes this rare; it waits only when one command
+    // produces more responses than the headroom, or fills rest with an owner
+    // that isn't polling.
+    void respond(std::uint32_t p, const ResponseT& r) {
+        SpscRing<ResponseT>& ring = lanes_[p]->responses;
+        if (ring.try_push(r)) return;
+        ++stats_.response_stalls;
+        Backoff wait;
+        while (!ring.try_push(r)) wait.pause();
+    }
+
+    int matcherCpu_;
+    std::size_t maxOrders_;
+    std::size_t maxLevels_; // price levels per side
+    bool reserved_ = false; // matcher-owned: first start() reserves
+    std::vector<std::unique_ptr<Lane>> lanes_; // one heap block per lane: no false sharing between lanes
+
+    // Matcher-thread state
+    Book   book_;
+    OMS    oms_;
+    Engine engine_;
+    IdIndex<OrderIdType> owners_;   // live order id -> producer index
+    std::vector<TradeT>  trades_;   // per-command scratch, reserved up front
+    GatewayStats stats_;
+
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> done_{false};
+    std::atomic<bool> ready_{false};
+    std::thread matcher_;
+};
@@ -0,0 +1,168 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "MappedFile.hpp"
+#include "OrderGateway.hpp" // GatewayCommand
+#include "TradeJournal.hpp" // JournalHeader, journalPriceKind
+
+// --- On-disk format ---------------------------------------------------------
+// Same layout rules as the trade journal: [JournalHeader][OrderJournalRecord<P>
+// x count][pre-sized tail], little-endian, `count` advanced after each record
+// is complete. The record index is the journal offset a snapshot checkpoints.
+
+constexpr char          kOrderJournalMagic[8] = {'H', 'F', 'T', 'O', 'J', 'R', 'N', '\0'};
+constexpr std::uint32_t kOrderJournalVersion  = 1;
+
+/// One order-entry command. Ids are widened to 64 bits so the schema does not
+/// depend on OrderIdType.
+template <typename PriceType>
+struct OrderJournalRecord {
+    std::int64_t  id;
+    PriceType     price;      // New / Replace
+    std::int32_t  quantity;   // New
+    std::uint8_t  kind;       // GatewayCommand::Kind
+    std::uint8_t  is_buy;     // New
+    std::uint8_t  pad[2];
+};
+
+/// Append-only log of the commands applied to an engine, on a pre-sized
+/// memory-mapped file (MappedFileWriter, as the TradeJournal uses).
+/// Log each command before applying it; a warm restart replays the records
+/// after a snapshot's journal offset.
+template <typename PriceType, typename OrderIdType>
+class OrderJournal {
+public:
+    using CommandT   = GatewayCommand<PriceType, OrderIdType>;
+    using RecordType = OrderJournalRecord<PriceType>;
+
+    explicit OrderJournal(std::string path, std::size_t capacity_records = 1 << 20)
+        : file_(std::move(path), bytesFor(capacity_records ? capacity_records : 1), "OrderJournal") {
+        attach(capacity_records ? capacity_records : 1);
+
+        JournalHeader& h = header();
+        std::memcpy(h.magic, kOrderJournalMagic, sizeof(h.magic));
+        h.version     = kOrderJournalVersion;
+        h.header_size = sizeof(JournalHeader);
+        h.record_size = sizeof(RecordType);
+        h.price_width = sizeof(PriceType);
+        h.price_kind  = static_cast<std::uint8_t>(journalPriceKind<PriceType>());
+        h.capacity    = capacity_;
+        h.count       = 0;
+        h.tick_size   = 0; // prices are stored as PriceType
+        h.id_base     = 0;
+    }
+
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+
+    ~OrderJournal() {
+        if (!file_) return;
+        header().capacity = count_;
+        file_.finish(bytesFor(count_)); // on failure the pre-sized file stays; count is still exact
+    }
+
+    void push(const CommandT& c) {
+        if (count_ == capacity_) grow();
+        RecordType& r = records_[count_];
+        r.id       = static_cast<std::int64_t>(c.id);
+        r.price    = c.price;
+        r.quantity = c.quantity;
+        r.kind     = static_cast<std::uint8_t>(c.kind);
+        r.is_buy   = c.is_buy ? 1 : 0;
+        r.pad[0] = r.pad[1] = 0;
+        header().count = ++count_;
+    }
+
+    void logNew(const Order<PriceType, OrderIdType>& o) {
+        CommandT c;
+        c.kind = CommandT::Kind::New;
+        c.id = o.id;
+        c.price = o.price;
+        c.quantity = o.quantity;
+        c.is_buy = o.is_buy;
+        push(c);
+    }
+
+    void logCancel(OrderIdType id) {
+        CommandT c;
+        c.kind = CommandT::Kind::Cancel;
+        c.id = id;
+        push(c);
+    }
+
+    void logReplace(OrderIdType id, PriceType new_price) {
+        CommandT c;
+        c.kind = CommandT::Kind::Replace;
+        c.id = id;
+        c.price = new_price;
+        push(c);
+    }
+
+    void flush() { file_.flush(); }
+
+    // Records written so far: the offset to checkpoint in a snapshot
+    std::uint64_t offset() const noexcept { return count_; }
+    std::size_t size() const noexcept { return count_; }
+    const std::string& path() const noexcept { return file_.path(); }
+
+private:
+    JournalHeader& header() noexcept { return *reinterpret_cast<JournalHeader*>(file_.data()); }
+
+    static std::size_t bytesFor(std::size_t records) noexcept {
+        return sizeof(JournalHeader) + records * sizeof(RecordType);
+    }
+
+    void attach(std::size_t capacity_records) noexcept {
+        capacity_ = capacity_records;
+        records_  = reinterpret_cast<RecordType*>(file_.data() + sizeof(JournalHeader));
+    }
+
+    void grow() {
+        file_.resize(bytesFor(capacity_ * 2));
+        attach(capacity_ * 2);
+        header().capacity = capacity_;
+    }
+
+    MappedFileWriter file_;
+    RecordType* records_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t count_ = 0;
+};
+
+/// Read-only mapping of an order journal written with PriceType prices.
+template <typename PriceType>
+class OrderJournalReader {
+public:
+    using RecordType = OrderJournalRecord<PriceType>;
+
+    explicit OrderJournalReader(const std::string& path)
+        : file_(path, sizeof(JournalHeader), "OrderJournalReader", "order journal") {
+        const JournalHeader& h = header();
+        const bool ok = std::memcmp(h.magic, kOrderJournalMagic, sizeof(h.magic)) == 0
+                     && h.version == kOrderJournalVersion
+                     && h.header_size >= sizeof(JournalHeader)
+                     && h.record_size == sizeof(RecordType)
+                     && h.price_width == sizeof(PriceType)
+                     && h.price_kind == static_cast<std::uint8_t>(journalPriceKind<PriceType>())
+                     && file_.fits(h.header_size, h.count, h.record_size);
+        if (!ok) throw std::runtime_error("OrderJournalReader: bad header or price type in " + path);
+    }
+
+    const JournalHeader& header() const noexcept {
+        return *reinterpret_cast<const JournalHeader*>(file_.data());
+    }
+    std::size_t size() const noexcept { return static_cast<std::size_t>(header().count); }
+
+    const RecordType* begin() const noexcept {
+        return reinterpret_cast<const RecordType*>(file_.data() + header().header_size);
+    }
+    const RecordType* end() const noexcept { return begin() + size(); }
+
+private:
+    MappedFileReader file_;
+};
@@ -4,13 +4,6 @@
 #include <type_traits>
 #include "Order.hpp"
 
-enum class OrderState : unsigned char {
-    New,
-    PartiallyFilled,
-    Filled,
-    Canceled
-};
-
 template <typename PriceType, typename OrderIdType>
 class OrderManager {
     static_assert(std::is_integral<OrderIdType>::value,
@@ -0,0 +1,161 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "ArenaMemory.hpp"
+#include "Order.hpp"
+#include "IdIndex.hpp"
+
+/// Generation-checked handle into the order store.
+/// A handle goes stale (resolve() returns nullptr) once its slot is released and reused.
+struct PoolHandle {
+    std::uint32_t slot = 0xFFFFFFFFu;
+    std::uint32_t gen  = 0;
+
+    explicit operator bool() const noexcept { return slot != 0xFFFFFFFFu; }
+};
+
+/// The one record per order that the OMS, the book and the engine all view.
+/// - order: id/price/side and *remaining* quantity
+/// - state: OMS lifecycle
+/// - prev/next: the engine's per-level FIFO links (next doubles as free-list link)
+/// Padded to a single cache line, so a fill touches exactly one line.
+template <typename PriceType, typename OrderIdType>
+struct alignas(64) OrderRecord {
+    Order<PriceType, OrderIdType> order;
+    OrderState    state = OrderState::Canceled;
+    bool          in_book = false;          // linked into a price level
+    std::uint32_t gen  = 0;                 // bumped every time the slot is released
+    std::uint32_t slot = 0;                 // own index in the store
+    OrderRecord*  prev = nullptr;
+    OrderRecord*  next = nullptr;
+
+    bool live() const noexcept {
+        return state == OrderState::New || state == OrderState::PartiallyFilled;
+    }
+};
+
+/// Slab/free-list arena of OrderRecords plus a flat ID index.
+/// - Slabs never move, so record addresses and handles stay valid until release()
+/// - After reserve(n), insert/find/release for up to n live orders do zero allocations
+template <typename PriceType, typename OrderIdType>
+class OrderStore {
+    static_assert(std::is_integral<OrderIdType>::value,
+                  "OrderIdType must be integral");
+
+public:
+    using RecordT = OrderRecord<PriceType, OrderIdType>;
+
+    static constexpr std::size_t kSlabSize = 4096; // records per slab (power of two)
+
+    OrderStore() = default;
+    OrderStore(const OrderStore&) = delete;            // records are referenced by address
+    OrderStore& operator=(const OrderStore&) = delete;
+
+    // Slabs for n records come from one arena buffer, so with huge pages on
+    // (ArenaMemory.hpp) the whole reservation sits on 2MB pages
+    void reserve(std::size_t n) {
+        index_.reserve(n);
+        slabs_.reserve((n + kSlabSize - 1) / kSlabSize + 1);
+        if (capacity() < n) addSlabs((n - capacity() + kSlabSize - 1) / kSlabSize);
+    }
+
+    // Record for id, creating it if missing
+    RecordT& insert(OrderIdType id) {
+        const std::uint32_t slot = index_.find(id);
+        if (slot != IdIndex<OrderIdType>::npos) return at(slot);
+
+        if (freeHead_ == nullptr) addSlabs(1); // cold path: arena exhausted
+        RecordT* r = freeHead_;
+        freeHead_ = r->next;
+        r->next = nullptr;
+        index_.insert(id, r->slot);
+        return *r;
+    }
+
+    // Batch-path hints: warm id's index bucket, or the record the next insert() takes
+    void prefetchId(OrderIdType id) const noexcept { index_.prefetch(id); }
+    void prefetchFree() const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        if (freeHead_) __builtin_prefetch(freeHead_, 1);
+#endif
+    }
+
+    [[nodiscard]] RecordT* find(OrderIdType id) noexcept {
+        const std::uint32_t slot = index_.find(id);
+        return slot == IdIndex<OrderIdType>::npos ? nullptr : &at(slot);
+    }
+    [[nodiscard]] const RecordT* find(OrderIdType id) const noexcept {
+        const std::uint32_t slot = index_.find(id);
+        return slot == IdIndex<OrderIdType>::npos ? nullptr : &at(slot);
+    }
+
+    [[nodiscard]] RecordT* resolve(PoolHandle h) noexcept {
+        if (h.slot >= capacity()) return nullptr;
+        RecordT& r = at(h.slot);
+        return r.gen == h.gen ? &r : nullptr;
+    }
+    [[nodiscard]] const RecordT* resolve(PoolHandle h) const noexcept {
+        if (h.slot >= capacity()) return nullptr;
+        const RecordT& r = at(h.slot);
+        return r.gen == h.gen ? &r : nullptr;
+    }
+
+    static PoolHandle handleOf(const RecordT& r) noexcept { return PoolHandle{r.slot, r.gen}; }
+
+    // Return the record's slot to the free list; outstanding handles go stale
+    void release(RecordT& r) noexcept {
+        index_.erase(r.order.id);
+        r.state = OrderState::Canceled;
+        r.in_book = false;
+        ++r.gen;
+        r.prev = nullptr;
+        r.next = freeHead_;
+        freeHead_ = &r;
+    }
+
+    RecordT& at(std::uint32_t slot) noexcept {
+        return slabs_[slot / kSlabSize][slot % kSlabSize];
+    }
+    const RecordT& at(std::uint32_t slot) const noexcept {
+        return slabs_[slot / kSlabSize][slot % kSlabSize];
+    }
+
+    // fn(const RecordT&) for every unreleased record
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        index_.forEach([&](OrderIdType, std::uint32_t slot) { fn(at(slot)); });
+    }
+
+    std::size_t size() const noexcept { return index_.size(); }                  // unreleased orders
+    std::size_t capacity() const noexcept { return slabs_.size() * kSlabSize; }  // records allocated
+
+private:
+    void addSlabs(std::size_t count) {
+        static_assert(std::is_trivially_destructible<RecordT>::value,
+                      "arena records are never destroyed");
+        blocks_.reserve(blocks_.size() + 1);
+        ArenaBuffer block(count * kSlabSize * sizeof(RecordT), alignof(RecordT));
+        auto* records = static_cast<RecordT*>(block.data());
+        blocks_.push_back(std::move(block));
+        // Thread the new slabs onto the free list in ascending slot order
+        const auto first = static_cast<std::uint32_t>(capacity());
+        const std::size_t total = count * kSlabSize;
+        for (std::size_t i = 0; i < total; ++i) {
+            RecordT* r = new (records + i) RecordT{};
+            r->slot = first + static_cast<std::uint32_t>(i);
+            r->next = (i + 1 < total) ? records + i + 1 : freeHead_;
+        }
+        for (std::size_t k = 0; k < count; ++k) slabs_.push_back(records + k * kSlabSize);
+        freeHead_ = records;
+    }
+
+    std::vector<ArenaBuffer> blocks_;  // owns the slab memory
+    std::vector<RecordT*> slabs_;      // kSlabSize records each
+    IdIndex<OrderIdType> index_;
+    RecordT* freeHead_ = nullptr;
+};
@@ -0,0 +1,219 @@
+#pragma once
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware events counted by PerfCounters, in group/CSV column order
+enum class PerfEvent : std::uint8_t {
+    Cycles, Instructions, BranchMisses, L1dMisses, LlcMisses, DtlbMisses, Count
+};
+
+constexpr std::size_t kPerfEvents = static_cast<std::size_t>(PerfEvent::Count);
+
+/// Counter values for one measured region. valid[e] is false when the event
+/// could not be opened or was never scheduled on the PMU.
+struct PerfSample {
+    std::array<std::uint64_t, kPerfEvents> value{};
+    std::array<bool, kPerfEvents> valid{};
+
+    bool has(PerfEvent e) const noexcept { return valid[static_cast<std::size_t>(e)]; }
+    std::uint64_t get(PerfEvent e) const noexcept { return value[static_cast<std::size_t>(e)]; }
+
+    // Events per operation, or -1 when the event is unavailable
+    double perOp(PerfEvent e, double ops) const noexcept {
+        return has(e) && ops > 0 ? static_cast<double>(get(e)) / ops : -1.0;
+    }
+
+    bool any() const noexcept {
+        for (bool v : valid) if (v) return true;
+        return false;
+    }
+};
+
+/// In-process PMU counters over perf_event_open(2), opened as one group so
+/// every event covers exactly the same instructions.
+/// - User-space only, this thread, any CPU
+/// - Events the kernel/VM doesn't expose are skipped; if none open (no PMU,
+///   perf_event_paranoid, non-Linux) start()/stop() are no-ops returning an
+///   all-invalid sample, so harnesses run unchanged and print "n/a"
+/// - Multiplexed groups are scaled by time_enabled / time_running
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        for (std::size_t e = 0; e < kPerfEvents; ++e) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            configure(static_cast<PerfEvent>(e), attr);
+            attr.disabled = (leader_ < 0) ? 1 : 0; // the leader gates the group
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                             | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if (fd < 0) {
+                if (error_.empty()) error_ = std::strerror(errno);
+                continue;
+            }
+            if (leader_ < 0) leader_ = fd;
+            fds_[e] = fd;
+            slot_[e] = opened_++;
+        }
+#else
+        error_ = "perf_event_open is Linux-only";
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_)
+            if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    bool available() const noexcept { return leader_ >= 0; }
+
+    // Why events failed to open (first error), empty if all opened
+    const std::string& error() const noexcept { return error_; }
+
+    void start() noexcept {
+#if defined(__linux__)
+        if (leader_ < 0) return;
+        ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    PerfSample stop() noexcept {
+        PerfSample s;
+#if defined(__linux__)
+        if (leader_ < 0) return s;
+        ::ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // { nr, time_enabled, time_running, value[nr] }
+        std::uint64_t buf[3 + kPerfEvents] = {};
+        if (::read(leader_, buf, sizeof(buf)) < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) return s;
+        const std::uint64_t enabled = buf[1], running = buf[2];
+        if (running == 0) return s; // group never got the PMU
+        const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+        for (std::size_t e = 0; e < kPerfEvents; ++e) {
+            if (fds_[e] < 0 || slot_[e] >= buf[0]) continue;
+            s.value[e] = static_cast<std::uint64_t>(static_cast<double>(buf[3 + slot_[e]]) * scale + 0.5);
+            s.valid[e] = true;
+        }
+#endif
+        return s;
+    }
+
+    static const char* name(PerfEvent e) noexcept {
+        switch (e) {
+        case PerfEvent::Cycles:       return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::BranchMisses: return "branch_misses";
+        case PerfEvent::L1dMisses:    return "l1d_misses";
+        case PerfEvent::LlcMisses:    return "llc_misses";
+        case PerfEvent::DtlbMisses:   return "dtlb_misses";
+        default:                      return "?";
+        }
+    }
+
+    // ",cycles_per_op,instructions_per_op,..." (append to a CSV header)
+    static void csvHeader(std::ostream& os) {
+        for (std::size_t e = 0; e < kPerfEvents; ++e)
+            os << ',' << name(static_cast<PerfEvent>(e)) << "_per_op";
+    }
+
+    // Matching per-op fields; unavailable events are left empty
+    static void csvFields(std::ostream& os, const PerfSample& s, double ops) {
+        char field[32];
+        for (std::size_t e = 0; e < kPerfEvents; ++e) {
+            os << ',';
+            const double v = s.perOp(static_cast<PerfEvent>(e), ops);
+            if (v < 0) continue;
+            std::snprintf(field, sizeof(field), "%.4f", v);
+            os << field;
+        }
+    }
+
+    // One-line summary: "cycles/op 3.51 IPC 2.80 branch_misses/op 0.001 ..."
+    static void printPerOp(std::ostream& os, const PerfSample& s, double ops, const char* unit = "op") {
+        if (!s.any()) {
+            os << "PMU: n/a";
+            return;
+        }
+        char line[64];
+        os << "PMU per " << unit << ":";
+        for (std::size_t e = 0; e < kPerfEvents; ++e) {
+            const auto ev = static_cast<PerfEvent>(e);
+            if (!s.has(ev)) continue;
+            std::snprintf(line, sizeof(line), " %s %.3f", name(ev), s.perOp(ev, ops));
+            os << line;
+        }
+        if (s.has(PerfEvent::Cycles) && s.has(PerfEvent::Instructions) && s.get(PerfEvent::Cycles) > 0) {
+            std::snprintf(line, sizeof(line), " IPC %.2f",
+                          static_cast<double>(s.get(PerfEvent::Instructions)) / s.get(PerfEvent::Cycles));
+            os << line;
+        }
+    }
+
+    // Header line for benchmark output: which events this box can count
+    static void printInfo(std::ostream& os, const PerfCounters& pc) {
+        if (!pc.available()) {
+            os << "PMU: unavailable (" << pc.error() << "), counters reported as n/a\n";
+            return;
+        }
+        os << "PMU:";
+        for (std::size_t e = 0; e < kPerfEvents; ++e)
+            if (pc.fds_[e] >= 0) os << ' ' << name(static_cast<PerfEvent>(e));
+        os << '\n';
+    }
+
+private:
+#if defined(__linux__)
+    static void configure(PerfEvent e, perf_event_attr& attr) noexcept {
+        auto cache = [](std::uint64_t id, std::uint64_t op, std::uint64_t result) {
+            return id | (op << 8) | (result << 16);
+        };
+        switch (e) {
+        case PerfEvent::Cycles:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case PerfEvent::Instructions:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case PerfEvent::BranchMisses:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case PerfEvent::L1dMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        case PerfEvent::LlcMisses:
+            attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case PerfEvent::DtlbMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        default: break;
+        }
+    }
+#endif
+
+    std::array<int, kPerfEvents> fds_ = [] { std::array<int, kPerfEvents> a; a.fill(-1); return a; }();
+    std::array<std::uint64_t, kPerfEvents> slot_{}; // position in the group read
+    std::uint64_t opened_ = 0;
+    int leader_ = -1;
+    std::string error_;
+};
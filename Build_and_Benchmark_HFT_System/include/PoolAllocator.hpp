@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+#include <new>
+#include <cstddef>
+#include "ArenaMemory.hpp"
+
+/// Free-list pool of fixed-size blocks carved from large chunks.
+/// - The block size is fixed by the first allocation (std::map only ever
+///   allocates its node type), so the pool works for node types we can't name
+/// - reserve(n) guarantees n blocks; carving happens on the first allocation
+///   if the block size isn't known yet
+/// - Blocks are recycled, never returned to the system until the pool dies
+/// - Chunks are ArenaBuffers (huge pages when the arena policy asks for them)
+class FixedPool {
+public:
+    FixedPool() = default;
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    ~FixedPool() = default;
+
+    void reserve(std::size_t blocks) {
+        if (blocks > reserved_) reserved_ = blocks;
+        if (blockSize_ != 0 && carved_ < reserved_) carve(reserved_ - carved_);
+    }
+
+    // True if a request of this size/alignment is served from the pool
+    bool fits(std::size_t bytes, std::size_t align) const noexcept {
+        return blockSize_ == 0 || (bytes <= blockSize_ && align <= align_);
+    }
+
+    void* allocate(std::size_t bytes, std::size_t align) {
+        if (blockSize_ == 0) {
+            align_ = align < alignof(FreeBlock) ? alignof(FreeBlock) : align;
+            const std::size_t b = bytes < sizeof(FreeBlock) ? sizeof(FreeBlock) : bytes;
+            blockSize_ = (b + align_ - 1) / align_ * align_;
+        }
+        if (free_ == nullptr) {
+            const std::size_t want = reserved_ > carved_ ? reserved_ - carved_ : carved_;
+            carve(want < kMinChunk ? kMinChunk : want); // cold path: pool exhausted
+        }
+        FreeBlock* b = free_;
+        free_ = b->next;
+        return b;
+    }
+
+    void deallocate(void* p) noexcept {
+        auto* b = static_cast<FreeBlock*>(p);
+        b->next = free_;
+        free_ = b;
+    }
+
+    std::size_t capacity() const noexcept { return carved_; }
+    std::size_t blockSize() const noexcept { return blockSize_; } // 0 until the first allocation
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    static constexpr std::size_t kMinChunk = 256;
+
+    void carve(std::size_t blocks) {
+        chunks_.emplace_back(blocks * blockSize_, align_);
+        auto* chunk = static_cast<unsigned char*>(chunks_.back().data());
+        for (std::size_t i = blocks; i-- > 0;) deallocate(chunk + i * blockSize_);
+        carved_ += blocks;
+    }
+
+    std::vector<ArenaBuffer> chunks_;
+    FreeBlock*  free_ = nullptr;
+    std::size_t blockSize_ = 0;
+    std::size_t align_ = alignof(std::max_align_t);
+    std::size_t reserved_ = 0;
+    std::size_t carved_ = 0;
+};
+
+/// Stateful allocator handing out single objects from a FixedPool.
+/// Use it for node-based containers (std::map, std::list) so inserting and
+/// erasing levels on the hot path recycles nodes instead of calling new/delete.
+/// Array requests (n != 1) or types that don't fit the pool's block fall back
+/// to the global heap.
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    explicit PoolAllocator(FixedPool& pool) noexcept : pool_(&pool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.pool()) {}
+
+    T* allocate(std::size_t n) {
+        if (n == 1 && pool_->fits(sizeof(T), alignof(T)))
+            return static_cast<T*>(pool_->allocate(sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (n == 1 && pool_->fits(sizeof(T), alignof(T))) pool_->deallocate(p);
+        else ::operator delete(p, std::align_val_t{alignof(T)});
+    }
+
+    FixedPool* pool() const noexcept { return pool_; }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return pool_ == other.pool(); }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept { return pool_ != other.pool(); }
+
+private:
+    FixedPool* pool_;
+};
+
+/// Fix `pool`'s block size to Map's node type and carve its reservation now,
+/// so the first hot-path insert doesn't. std::map never names its node type,
+/// so a throwaway Map on the same pool allocates and frees one node; the
+/// caller's own maps are left untouched.
+template <typename Map>
+void prewarmNodePool(FixedPool& pool) {
+    if (pool.blockSize() != 0) return; // already sized; reserve() carved eagerly
+    Map scratch(typename Map::key_compare{}, typename Map::allocator_type{pool});
+    scratch.emplace(typename Map::key_type{}, typename Map::mapped_type{});
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include "Order.hpp"
+#include "OrderStore.hpp"
+
+/// OMS over the shared OrderStore (slab/free-list arena).
+/// - Same query API as OrderManager, but no shared_ptr and no per-order heap allocation
+/// - ID lookup is a single flat IdIndex probe; state sits next to the order
+/// - Record overloads let MatchingEngine apply lifecycle changes with no lookup
+///   at all; they are private to it, since it unlinks and relinks the record
+///   around each change
+/// - A record resting in a book (in_book) is shared with the book and engine:
+///   cancel/fill/amendQuantity/replacePrice/release by id refuse it and return
+///   false. Go through MatchingEngine::cancel / replacePrice instead, or the
+///   level totals and FIFOs go stale
+/// - Once reserve(n) has run, create/fill/cancel/release for up to n live
+///   orders do zero allocations
+/// - Filled/canceled orders stay queryable until release(id) recycles the slot
+template <typename PriceType, typename OrderIdType>
+class PooledOrderManager {
+    static_assert(std::is_integral<OrderIdType>::value,
+                  "OrderIdType must be integral");
+
+public:
+    using OrderT      = Order<PriceType, OrderIdType>;
+    using StoreT      = OrderStore<PriceType, OrderIdType>;
+    using RecordT     = typename StoreT::RecordT;
+    using OrderHandle = PoolHandle;
+
+    // Preallocate arena slabs and the ID index for n live orders
+    void reserve(std::size_t n) { store_.reserve(n); }
+
+    // --- Create / Cancel / Fill -------------------------------------------
+
+    [[nodiscard]] OrderHandle create(OrderIdType id, PriceType price, int qty, bool is_buy) {
+        RecordT& r = store_.insert(id);
+        r.order = OrderT{id, price, qty, is_buy};
+        r.state = OrderState::New;
+        return StoreT::handleOf(r);
+    }
+
+    // Recreate an order in a given lifecycle state (snapshot restore); the
+    // record comes back with in_book = false
+    RecordT& restore(OrderIdType id, PriceType price, int qty, bool is_buy, OrderState state) {
+        RecordT& r = store_.insert(id);
+        r.order = OrderT{id, price, qty, is_buy};
+        r.state = state;
+        r.in_book = false;
+        return r;
+    }
+
+    bool cancel(OrderIdType id) {
+        RecordT* r = store_.find(id);
+        return r && !r->in_book && cancel(*r);
+    }
+
+    // Apply a trade fill to this order
+    bool fill(OrderIdType id, int exec_qty) {
+        RecordT* r = store_.find(id);
+        return r && !r->in_book && fill(*r, exec_qty);
+    }
+
+    // Same, skipping the ID lookup entirely
+    bool fill(OrderHandle h, int exec_qty) {
+        RecordT* r = store_.resolve(h);
+        return r && !r->in_book && fill(*r, exec_qty);
+    }
+
+    // Return the slot to the arena; outstanding handles to it go stale.
+    // A resting order is refused: its slot is still linked into a level.
+    bool release(OrderIdType id) {
+        RecordT* r = store_.find(id);
+        if (!r || r->in_book) return false;
+        store_.release(*r);
+        return true;
+    }
+
+    // --- Amend / Replace ---------------------------------------------------
+    // Change remaining quantity (not side/price)
+    bool amendQuantity(OrderIdType id, int new_qty) {
+        if (new_qty < 0) return false;
+        RecordT* r = store_.find(id);
+        if (!r || !r->live() || r->in_book) return false;
+
+        r->order.quantity = new_qty;
+        if (new_qty == 0) r->state = OrderState::Filled;
+        return true;
+    }
+
+    // Change price (a "replace"); many venues treat as cancel+new in the book.
+    bool replacePrice(OrderIdType id, PriceType new_price) {
+        RecordT* r = store_.find(id);
+        return r && !r->in_book && replacePrice(*r, new_price);
+    }
+
+    // --- Queries -----------------------------------------------------------
+    [[nodiscard]] OrderState state(OrderIdType id) const {
+        const RecordT* r = store_.find(id);
+        return r ? r->state : OrderState::Canceled;
+    }
+
+    [[nodiscard]] OrderState state(OrderHandle h) const {
+        const RecordT* r = store_.resolve(h);
+        return r ? r->state : OrderState::Canceled;
+    }
+
+    // Non-owning view; valid until the order is released
+    [[nodiscard]] const OrderT* get(OrderIdType id) const {
+        const RecordT* r = store_.find(id);
+        return r ? &r->order : nullptr;
+    }
+
+    [[nodiscard]] const OrderT* get(OrderHandle h) const {
+        const RecordT* r = store_.resolve(h);
+        return r ? &r->order : nullptr;
+    }
+
+    [[nodiscard]] bool exists(OrderIdType id) const {
+        return store_.find(id) != nullptr;
+    }
+
+    [[nodiscard]] int getRemainingQty(OrderIdType id) const {
+        const RecordT* r = store_.find(id);
+        return r ? r->order.quantity : 0;
+    }
+
+    [[nodiscard]] PriceType getPrice(OrderIdType id) const {
+        const RecordT* r = store_.find(id);
+        return r ? r->order.price : PriceType{};
+    }
+
+    [[nodiscard]] bool isBuy(OrderIdType id) const {
+        const RecordT* r = store_.find(id);
+        return r && r->order.is_buy;
+    }
+
+    // --- Shared store ------------------------------------------------------
+    // The book and engine operate on these records directly.
+    [[nodiscard]] RecordT* record(OrderIdType id) noexcept { return store_.find(id); }
+    [[nodiscard]] RecordT* record(OrderHandle h) noexcept { return store_.resolve(h); }
+
+    // Prefetch hints for batched entry: the ID index bucket for id, and the
+    // arena record the next create() will hand out
+    void prefetchId(OrderIdType id) const noexcept { store_.prefetchId(id); }
+    void prefetchCreate() const noexcept { store_.prefetchFree(); }
+
+    StoreT&       store() noexcept { return store_; }
+    const StoreT& store() const noexcept { return store_; }
+
+    std::size_t size() const noexcept { return store_.size(); }         // unreleased orders
+    std::size_t capacity() const noexcept { return store_.capacity(); } // records allocated
+
+private:
+    template <typename, typename, typename, typename> friend class MatchingEngine;
+
+    // --- Record overloads (MatchingEngine only) -----------------------------
+    bool cancel(RecordT& r) {
+        if (!r.live()) return false;
+        r.state = OrderState::Canceled;
+        return true;
+    }
+
+    bool fill(RecordT& r, int exec_qty) {
+        if (exec_qty <= 0 || !r.live()) return false;
+
+        auto& o = r.order;
+        if (exec_qty >= o.quantity) {
+            o.quantity = 0;
+            r.state = OrderState::Filled;
+        } else {
+            o.quantity -= exec_qty;
+            r.state = OrderState::PartiallyFilled;
+        }
+        return true;
+    }
+
+    bool replacePrice(RecordT& r, PriceType new_price) {
+        if (!r.live()) return false;
+        r.order.price = new_price;
+        return true;
+    }
+
+    StoreT store_;
+};
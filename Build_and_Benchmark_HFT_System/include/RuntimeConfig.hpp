@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+#include "ArenaMemory.hpp"
+#include "ThreadAffinity.hpp"
+
+/// Thread placement and arena backing for the engine executables.
+/// - One CPU per thread role (-1: leave it to the scheduler). Each owner pins
+///   its thread before reserving, so reserve() first-touches that thread's
+///   arenas on its NUMA node:
+///     matcher -> OrderGateway matcher / hft_app's tick-to-trade loop
+///     logger  -> AsyncTradeLogger writer
+///     feed    -> feed reader / order router (drives ShardedEngine)
+///     shards  -> ShardedEngine worker s on shard_first_cpu + s
+/// - huge_pages backs book/OMS arenas with 2MB pages (see ArenaMemory.hpp)
+/// - Each executable names the roles it has threads for; the other roles'
+///   flags are rejected and their placement prints as n/a
+struct RuntimeConfig {
+    int  matcher_cpu     = -1;
+    int  logger_cpu      = -1;
+    int  feed_cpu        = -1;
+    int  shard_first_cpu = -1;
+    bool huge_pages      = false;
+};
+
+/// Thread roles an executable has (bitmask for the functions below)
+enum RuntimeRole : unsigned {
+    kRoleMatcher = 1u << 0,
+    kRoleLogger  = 1u << 1,
+    kRoleFeed    = 1u << 2,
+    kRoleShards  = 1u << 3,
+    kAllRoles    = kRoleMatcher | kRoleLogger | kRoleFeed | kRoleShards
+};
+
+inline void printRuntimeUsage(std::ostream& os, unsigned roles = kAllRoles) {
+    os << " ";
+    if (roles & kRoleMatcher) os << " --cpu-matcher N";
+    if (roles & kRoleLogger)  os << " --cpu-logger N";
+    if (roles & kRoleFeed)    os << " --cpu-feed N";
+    if (roles & kRoleShards)  os << " --cpu-shards FIRST";
+    os << "   pin thread roles\n"
+          "  --huge-pages   2MB pages for book/OMS arenas\n";
+}
+
+/// Consume argv[a] (and its value) if it is a runtime flag for one of
+/// `roles`; a is left on the last consumed argument. False if argv[a] isn't
+/// one, names a role this executable doesn't have, or its value is missing.
+inline bool parseRuntimeFlag(int& a, int argc, char** argv, RuntimeConfig& cfg,
+                             unsigned roles = kAllRoles) {
+    const std::string arg = argv[a];
+    if (arg == "--huge-pages") {
+        cfg.huge_pages = true;
+        return true;
+    }
+    int* target = arg == "--cpu-matcher" && (roles & kRoleMatcher) ? &cfg.matcher_cpu
+                : arg == "--cpu-logger"  && (roles & kRoleLogger)  ? &cfg.logger_cpu
+                : arg == "--cpu-feed"    && (roles & kRoleFeed)    ? &cfg.feed_cpu
+                : arg == "--cpu-shards"  && (roles & kRoleShards)  ? &cfg.shard_first_cpu
+                : nullptr;
+    if (!target || a + 1 >= argc) return false;
+    *target = std::atoi(argv[++a]);
+    return true;
+}
+
+/// Install the arena policy; call once before any book/OMS is reserved.
+inline void applyRuntimeConfig(const RuntimeConfig& cfg) noexcept {
+    arenaMemoryPolicy().huge_pages = cfg.huge_pages;
+}
+
+// "madvise" etc.: the bracketed mode in transparent_hugepage/enabled
+inline std::string transparentHugePageMode() {
+    std::ifstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string line;
+    if (!std::getline(in, line)) return "n/a";
+    const auto l = line.find('['), r = line.find(']');
+    return l != std::string::npos && r > l ? line.substr(l + 1, r - l - 1) : line;
+}
+
+// One /proc/meminfo field ("HugePages_Free:", "AnonHugePages:" in kB), or 0
+inline long meminfoValue(const std::string& field) {
+    std::ifstream in("/proc/meminfo");
+    std::string key;
+    long value = 0;
+    while (in >> key >> value) {
+        if (key == field) return value;
+        in.ignore(256, '\n');
+    }
+    return 0;
+}
+
+// Free 2MB hugetlb pages reserved by the kernel (vm.nr_hugepages)
+inline long freeHugeTlbPages() { return meminfoValue("HugePages_Free:"); }
+
+inline void printRuntimeConfig(std::ostream& os, const RuntimeConfig& cfg, unsigned roles = kAllRoles) {
+    auto role = [&](const char* name, int cpu, RuntimeRole r) {
+        os << "  " << name << ": ";
+        if (!(roles & r)) os << "n/a";
+        else if (cpu < 0) os << "unpinned";
+        else         os << "cpu " << cpu << " (node " << numa_node_of_cpu(cpu) << ")";
+        os << "\n";
+    };
+    os << "Runtime: " << online_cpus() << " cpus online\n";
+    role("matcher", cfg.matcher_cpu, kRoleMatcher);
+    role("logger ", cfg.logger_cpu, kRoleLogger);
+    role("feed   ", cfg.feed_cpu, kRoleFeed);
+    role("shards ", cfg.shard_first_cpu, kRoleShards);
+    os << "  arenas : " << (cfg.huge_pages ? "2MB pages" : "default pages")
+       << " (hugetlb free=" << freeHugeTlbPages() << ", THP " << transparentHugePageMode() << ")\n";
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BookManager.hpp"
+#include "OrderGateway.hpp" // GatewayCommand
+#include "SpscRing.hpp"
+#include "SymbolTable.hpp"
+#include "ThreadAffinity.hpp"
+
+/// Command routed to the shard owning `instrument`.
+template <typename PriceType, typename OrderIdType>
+struct ShardCommand {
+    std::uint32_t instrument = 0;
+    GatewayCommand<PriceType, OrderIdType> cmd{};
+};
+
+/// Default per-shard trade sink: counts trades and traded quantity.
+struct ShardTradeCounter {
+    std::uint64_t trades = 0;
+    std::uint64_t quantity = 0;
+
+    template <typename TradeT>
+    void operator()(std::uint32_t /*instrument*/, const TradeT& t) noexcept {
+        ++trades;
+        quantity += static_cast<std::uint64_t>(t.quantity);
+    }
+};
+
+/// Symbol-sharded matching: instruments are split across worker threads, each
+/// owning the books of its instruments outright.
+/// - Instrument i lives on shard i % shards; a worker's BookManager, sink and
+///   counters are built on that worker's thread (first-touch memory) and each
+///   Shard is a separate cache-line aligned allocation, so shards share nothing
+///   but their input ring
+/// - Worker s is pinned to cpu first_cpu + s (no pinning when first_cpu < 0)
+/// - One router thread calls submit/try_submit; each shard's ring is SPSC
+/// - Instruments must be registered with addInstrument() before start()
+template <typename PriceType, typename OrderIdType, typename SinkT = ShardTradeCounter>
+class ShardedEngine {
+public:
+    using CommandT = GatewayCommand<PriceType, OrderIdType>;
+    using RoutedT  = ShardCommand<PriceType, OrderIdType>;
+    using OrderT   = Order<PriceType, OrderIdType>;
+    using TradeT   = Trade<PriceType, OrderIdType>;
+    using Manager  = BookManager<PriceType, OrderIdType>;
+
+    static constexpr std::size_t kDrainBatch = 256;
+
+    ShardedEngine(std::size_t shards, std::size_t orders_per_instrument = 1 << 16,
+                  int first_cpu = -1, std::size_t ring_capacity = 1 << 14)
+        : ordersPerInstrument_(orders_per_instrument), firstCpu_(first_cpu) {
+        shards_.reserve(shards);
+        for (std::size_t s = 0; s < shards; ++s)
+            shards_.push_back(std::make_unique<Shard>(ring_capacity));
+    }
+
+    ShardedEngine(const ShardedEngine&) = delete;
+    ShardedEngine& operator=(const ShardedEngine&) = delete;
+
+    ~ShardedEngine() { stop(); }
+
+    // Register a symbol; returns its global instrument id (dense, in call order)
+    std::uint32_t addInstrument(const std::string& symbol) {
+        return symbols_.intern(symbol);
+    }
+
+    std::size_t shardOf(std::uint32_t instrument) const noexcept { return instrument % shards_.size(); }
+    std::size_t shards() const noexcept { return shards_.size(); }
+    std::size_t instruments() const noexcept { return symbols_.size(); }
+
+    // Spawn one worker per shard; returns once every worker has built its books
+    void start() {
+        if (running_) return;
+        running_ = true;
+        ready_.store(0, std::memory_order_relaxed);
+        for (std::size_t s = 0; s < shards_.size(); ++s) {
+            shards_[s]->stop.store(false, std::memory_order_relaxed);
+            shards_[s]->worker = std::thread([this, s] { run(s); });
+        }
+        while (ready_.load(std::memory_order_acquire) < shards_.size()) std::this_thread::yield();
+    }
+
+    // Drain every routed command, then join all workers
+    void stop() {
+        if (!running_) return;
+        for (auto& sh : shards_) sh->stop.store(true, std::memory_order_release);
+        for (auto& sh : shards_) sh->worker.join();
+        running_ = false;
+    }
+
+    // --- Router thread ---------------------------------------------------------
+    bool try_submit(std::uint32_t instrument, const CommandT& c) noexcept {
+        return shards_[shardOf(instrument)]->ring.try_push(RoutedT{instrument, c});
+    }
+
+    void submit(std::uint32_t instrument, const CommandT& c) noexcept {
+        Backoff wait;
+        while (!try_submit(instrument, c)) wait.pause();
+    }
+
+    // --- After stop() ------------------------------------------------------------
+    const SinkT& sink(std::size_t shard) const noexcept { return shards_[shard]->sink; }
+    std::uint64_t commands(std::size_t shard) const noexcept { return shards_[shard]->commands; }
+    const Manager& books(std::size_t shard) const noexcept { return *shards_[shard]->books; }
+
+    // Local index of a global instrument inside its shard's BookManager
+    std::uint32_t localIndex(std::uint32_t instrument) const noexcept {
+        return static_cast<std::uint32_t>(instrument / shards_.size());
+    }
+
+private:
+    struct alignas(64) Shard {
+        explicit Shard(std::size_t cap) : ring(cap) {}
+
+        SpscRing<RoutedT> ring;          // router -> worker
+        std::atomic<bool> stop{false};
+        std::thread worker;
+
+        // Worker-owned
+        alignas(64) std::unique_ptr<Manager> books;
+        SinkT sink{};
+        std::uint64_t commands = 0;
+    };
+
+    void run(std::size_t s) {
+        Shard& sh = *shards_[s];
+        if (firstCpu_ >= 0) pin_current_thread(firstCpu_ + static_cast<int>(s));
+
+        // Build this shard's books here so their pages land near this core
+        sh.books = std::make_unique<Manager>();
+        for (std::uint32_t id = static_cast<std::uint32_t>(s); id < symbols_.size();
+             id += static_cast<std::uint32_t>(shards_.size()))
+            sh.books->addInstrument(symbols_.name(id), ordersPerInstrument_);
+        ready_.fetch_add(1, std::memory_order_release);
+
+        Manager& books = *sh.books;
+        Backoff idle;
+        while (true) {
+            const bool stopping = sh.stop.load(std::memory_order_acquire);
+            const std::size_t n = sh.ring.consume(
+                [&](const RoutedT& r) { execute(books, sh.sink, r); }, kDrainBatch);
+            if (n > 0) {
+                sh.commands += n;
+                idle.reset();
+                continue;
+            }
+            if (stopping) break;
+            idle.pause();
+        }
+    }
+
+    void execute(Manager& books, SinkT& sink, const RoutedT& r) {
+        const std::uint32_t local = localIndex(r.instrument);
+        const CommandT& c = r.cmd;
+        auto emit = [&](const TradeT& t) { sink(r.instrument, t); };
+        switch (c.kind) {
+        case CommandT::Kind::New:
+            books.submit(local, OrderT{c.id, c.price, c.quantity, c.is_buy}, emit);
+            break;
+        case CommandT::Kind::Cancel:
+            books.cancel(local, c.id);
+            break;
+        case CommandT::Kind::Replace:
+            books.replacePrice(local, c.id, c.price, emit);
+            break;
+        }
+    }
+
+    std::size_t ordersPerInstrument_;
+    int firstCpu_;
+    bool running_ = false;
+    SymbolTable symbols_; // global instrument ids
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<std::size_t> ready_{0};
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Hint to the core that we're in a spin-wait loop.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Wait-loop backoff: pause-spin briefly, then yield so a waiting thread can't
+// starve the one it waits on when both share a core.
+class Backoff {
+public:
+    void pause() noexcept {
+        if (spins_ < kSpinLimit) { cpu_relax(); ++spins_; }
+        else                     { std::this_thread::yield(); }
+    }
+    void reset() noexcept { spins_ = 0; }
+
+private:
+    static constexpr unsigned kSpinLimit = 64;
+    unsigned spins_ = 0;
+};
+
+/// Bounded lock-free single-producer / single-consumer ring.
+/// - Capacity rounds up to a power of two; indices are free-running counters
+/// - Producer and consumer state live on separate cache lines, and each side
+///   caches the other's index so the shared line is only read when the ring
+///   looks full (producer) or empty (consumer)
+/// - Elements must be trivially copyable (POD records like Trade)
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRing elements must be trivially copyable");
+
+public:
+    explicit SpscRing(std::size_t capacity)
+        : cap_(roundUpPow2(capacity)), mask_(cap_ - 1), buf_(new T[cap_]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // --- Producer side ----------------------------------------------------
+    bool try_push(const T& v) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tailCache_ == cap_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head - tailCache_ == cap_) return false; // full
+        }
+        buf_[head & mask_] = v;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Occupancy as last seen by the producer (upper bound: the consumer may
+    // have drained more since). Cheap enough to call after every push.
+    std::size_t producer_size() const noexcept {
+        return head_.load(std::memory_order_relaxed) - tailCache_;
+    }
+
+    // Exact occupancy from the producer: re-reads the consumer index (touches
+    // the shared line), which also refreshes the cached value used by try_push.
+    std::size_t producer_refresh() noexcept {
+        tailCache_ = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_relaxed) - tailCache_;
+    }
+
+    // --- Consumer side ----------------------------------------------------
+    bool try_pop(T& out) noexcept {
+        return consume([&](const T& v) { out = v; }, 1) == 1;
+    }
+
+    // Hand up to max_items to f(const T&) and release them in one store.
+    template <typename F>
+    std::size_t consume(F&& f, std::size_t max_items) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (headCache_ == tail) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (headCache_ == tail) return 0; // empty
+        }
+        std::size_t n = headCache_ - tail;
+        if (n > max_items) n = max_items;
+        for (std::size_t i = 0; i < n; ++i) f(buf_[(tail + i) & mask_]);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // --- Either side (approximate while the other side is running) ---------
+    std::size_t size() const noexcept {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    bool empty() const noexcept { return size() == 0; }
+    std::size_t capacity() const noexcept { return cap_; }
+
+private:
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t c = 2;
+        while (c < n) c *= 2;
+        return c;
+    }
+
+    static constexpr std::size_t kLine = 64;
+
+    // Producer line
+    alignas(kLine) std::atomic<std::size_t> head_{0};
+    std::size_t tailCache_ = 0;
+    // Consumer line
+    alignas(kLine) std::atomic<std::size_t> tail_{0};
+    std::size_t headCache_ = 0;
+    // Read-only after construction
+    alignas(kLine) const std::size_t cap_;
+    const std::size_t mask_;
+    std::unique_ptr<T[]> buf_;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Interns symbol names to dense uint32_t ids (0, 1, 2, ... in first-seen order).
+/// - Intern once at startup; per-tick structures then carry only the id
+/// - name(id) is a vector index; find()/intern() hash the name (setup path)
+class SymbolTable {
+public:
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    // Id for name, assigning the next free id if it's new
+    std::uint32_t intern(const std::string& name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+        const auto id = static_cast<std::uint32_t>(names_.size());
+        names_.push_back(name);
+        ids_.emplace(name, id);
+        return id;
+    }
+
+    std::uint32_t find(const std::string& name) const {
+        auto it = ids_.find(name);
+        return it == ids_.end() ? npos : it->second;
+    }
+
+    const std::string& name(std::uint32_t id) const { return names_[id]; }
+    std::uint32_t size() const noexcept { return static_cast<std::uint32_t>(names_.size()); }
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, std::uint32_t> ids_;
+};
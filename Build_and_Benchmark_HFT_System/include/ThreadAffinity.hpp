@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// Pin the calling thread to one CPU. Returns false if pinning isn't supported
+// on this platform (e.g. macOS) or the CPU id is invalid; callers just carry on.
+inline bool pin_current_thread(int cpu) noexcept {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// CPU the calling thread is running on right now, or -1
+inline int current_cpu() noexcept {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+// Online CPUs (at least 1)
+inline int online_cpus() noexcept {
+#if defined(__linux__)
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? static_cast<int>(n) : 1;
+#else
+    return 1;
+#endif
+}
+
+// NUMA node of a CPU from sysfs (cpuN/nodeM link), or -1 when unknown.
+// Memory first touched by a thread pinned to that CPU lands on this node.
+inline int numa_node_of_cpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return -1;
+    const std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* d = opendir(dir.c_str());
+    if (!d) return -1;
+    int node = -1;
+    while (dirent* e = readdir(d)) {
+        const std::string name = e->d_name;
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            name.find_first_not_of("0123456789", 4) == std::string::npos) {
+            node = std::stoi(name.substr(4));
+            break;
+        }
+    }
+    closedir(d);
+    return node;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
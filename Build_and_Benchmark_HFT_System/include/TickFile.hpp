@@ -0,0 +1,241 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "SpscRing.hpp" // cpu_relax
+#include "SymbolTable.hpp"
+
+// --- On-disk format ---------------------------------------------------------
+// [TickFileHeader][RecordT x count][symbol block]
+// Records are the in-memory tick struct verbatim (host little-endian), starting
+// at header_size (a multiple of the record's alignment), so a mapped file can
+// be iterated in place. The symbol block is u32 count, then per symbol a u32
+// length and the name bytes, in id order.
+
+constexpr char          kTickFileMagic[8] = {'H', 'F', 'T', 'T', 'I', 'C', 'K', '\0'};
+constexpr std::uint32_t kTickFileVersion  = 1;
+
+struct TickFileHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;    // offset of the first record
+    std::uint32_t record_size;    // sizeof(RecordT)
+    std::uint32_t record_align;   // alignof(RecordT)
+    std::uint64_t count;          // records
+    std::uint64_t symbols_offset; // 0 if no symbol block
+    std::uint64_t symbols_bytes;
+    std::uint8_t  pad[16];
+};
+static_assert(sizeof(TickFileHeader) == 64, "TickFileHeader must stay 64 bytes");
+
+/// Appends ticks to a capture file through a user-space buffer (one write()
+/// per MB, not per tick). close() writes the symbol block and final header.
+/// - Every write is checked: record()/close() throw std::runtime_error on a
+///   short write and close the file; a later close() is a no-op and a later
+///   record() that needs to write throws
+/// - Call close() to see errors; the destructor only reports them on stderr
+/// - Records are written byte for byte, so RecordT should have no unnamed
+///   padding (MarketData names and zeroes all of its own)
+template <typename RecordT>
+class TickRecorder {
+    static_assert(std::is_trivially_copyable<RecordT>::value, "tick records must be trivially copyable");
+    static_assert(alignof(RecordT) <= sizeof(TickFileHeader), "record alignment exceeds header size");
+
+public:
+    explicit TickRecorder(const std::string& path, std::size_t buffer_bytes = 1 << 20)
+        : path_(path) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) throw std::runtime_error("TickRecorder: cannot open " + path);
+        buffer_.reserve(buffer_bytes);
+        TickFileHeader h{};
+        if (std::fwrite(&h, sizeof(h), 1, file_) != 1) { // placeholder, rewritten by close()
+            std::fclose(file_);
+            throw std::runtime_error("TickRecorder: short write to " + path);
+        }
+    }
+
+    TickRecorder(const TickRecorder&) = delete;
+    TickRecorder& operator=(const TickRecorder&) = delete;
+
+    ~TickRecorder() noexcept {
+        try {
+            close();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s (capture is incomplete)\n", e.what());
+        }
+    }
+
+    void record(const RecordT& r) {
+        if (buffer_.size() + sizeof(RecordT) > buffer_.capacity()) drain();
+        const auto* p = reinterpret_cast<const char*>(&r);
+        buffer_.insert(buffer_.end(), p, p + sizeof(RecordT));
+        ++count_;
+    }
+
+    void record(const RecordT* first, const RecordT* last) {
+        for (; first != last; ++first) record(*first);
+    }
+
+    // Finish the file; symbols (optional) are stored so ids resolve on replay
+    void close(const SymbolTable* symbols = nullptr) {
+        if (!file_) return;
+        finish(symbols);
+        const int rc = std::fclose(file_); // flushes stdio's buffer: can fail too
+        file_ = nullptr;
+        if (rc != 0) throw std::runtime_error("TickRecorder: cannot close " + path_);
+    }
+
+    std::uint64_t size() const noexcept { return count_; }
+
+private:
+    void finish(const SymbolTable* symbols) {
+        drain();
+
+        TickFileHeader h{};
+        std::memcpy(h.magic, kTickFileMagic, sizeof(h.magic));
+        h.version      = kTickFileVersion;
+        h.header_size  = sizeof(TickFileHeader);
+        h.record_size  = sizeof(RecordT);
+        h.record_align = alignof(RecordT);
+        h.count        = count_;
+
+        if (symbols && symbols->size() > 0) {
+            h.symbols_offset = sizeof(TickFileHeader) + count_ * sizeof(RecordT);
+            const std::uint32_t n = symbols->size();
+            write(&n, sizeof(n));
+            h.symbols_bytes = sizeof(n);
+            for (std::uint32_t id = 0; id < n; ++id) {
+                const std::string& name = symbols->name(id);
+                const auto len = static_cast<std::uint32_t>(name.size());
+                write(&len, sizeof(len));
+                write(name.data(), len);
+                h.symbols_bytes += sizeof(len) + len;
+            }
+        }
+
+        if (std::fseek(file_, 0, SEEK_SET) != 0) fail("cannot seek in ");
+        write(&h, sizeof(h));
+    }
+
+    void drain() {
+        write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    void write(const void* p, std::size_t bytes) {
+        if (!file_) throw std::runtime_error("TickRecorder: " + path_ + " is already closed");
+        if (bytes != 0 && std::fwrite(p, 1, bytes, file_) != bytes) fail("short write to ");
+    }
+
+    // Give up on the file: close it so the destructor doesn't retry
+    [[noreturn]] void fail(const char* what) {
+        std::fclose(file_);
+        file_ = nullptr;
+        buffer_.clear();
+        throw std::runtime_error(std::string("TickRecorder: ") + what + path_);
+    }
+
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    std::vector<char> buffer_;
+    std::uint64_t count_ = 0;
+};
+
+/// Zero-copy tick source: maps a capture file read-only and iterates the
+/// records in place. madvise(MADV_SEQUENTIAL) lets the kernel read ahead
+/// aggressively and drop pages behind the cursor, so sessions far larger than
+/// RAM replay at disk/page-cache speed without a std::vector copy.
+template <typename RecordT>
+class MappedTickFile {
+public:
+    explicit MappedTickFile(const std::string& path)
+        : file_(path, sizeof(TickFileHeader), "MappedTickFile", "tick file") {
+        const TickFileHeader& h = header();
+        const bool ok = std::memcmp(h.magic, kTickFileMagic, sizeof(h.magic)) == 0
+                     && h.version == kTickFileVersion
+                     && h.record_size == sizeof(RecordT)
+                     && h.record_align == alignof(RecordT)
+                     && h.header_size % alignof(RecordT) == 0
+                     && file_.fits(h.header_size, h.count, h.record_size)
+                     && file_.fits(h.symbols_offset, h.symbols_bytes, 1);
+        if (!ok) throw std::runtime_error("MappedTickFile: bad header or record layout in " + path);
+        loadSymbols();
+    }
+
+    const RecordT* begin() const noexcept {
+        return reinterpret_cast<const RecordT*>(file_.data() + header().header_size);
+    }
+    const RecordT* end() const noexcept { return begin() + size(); }
+    const RecordT& operator[](std::size_t i) const noexcept { return begin()[i]; }
+    std::size_t size() const noexcept { return static_cast<std::size_t>(header().count); }
+
+    const TickFileHeader& header() const noexcept {
+        return *reinterpret_cast<const TickFileHeader*>(file_.data());
+    }
+    const SymbolTable& symbols() const noexcept { return symbols_; }
+
+private:
+    void loadSymbols() {
+        const TickFileHeader& h = header();
+        if (h.symbols_offset == 0 || h.symbols_bytes < sizeof(std::uint32_t)) return;
+        const char* p = file_.data() + h.symbols_offset;
+        const char* end = p + h.symbols_bytes;
+        std::uint32_t n;
+        std::memcpy(&n, p, sizeof(n));
+        p += sizeof(n);
+        for (std::uint32_t i = 0; i < n && p + sizeof(std::uint32_t) <= end; ++i) {
+            std::uint32_t len;
+            std::memcpy(&len, p, sizeof(len));
+            p += sizeof(len);
+            if (len > static_cast<std::size_t>(end - p)) break;
+            symbols_.intern(std::string(p, len));
+            p += len;
+        }
+    }
+
+    MappedFileReader file_;
+    SymbolTable symbols_;
+};
+
+enum class ReplayPacing : unsigned char {
+    AsFastAsPossible, // hand ticks over back to back
+    Original          // honour the captured inter-tick gaps (scaled by speed)
+};
+
+/// Feeds a tick range to sink(const RecordT&) with the chosen pacing.
+/// ts_ns(const RecordT&) extracts the capture timestamp in ns (Original mode).
+/// Long gaps sleep; the last ~50 us before a tick are spun for precision.
+template <typename RecordT, typename Sink, typename TsFn>
+std::size_t replayTicks(const RecordT* first, const RecordT* last, Sink&& sink, TsFn&& ts_ns,
+                        ReplayPacing pacing = ReplayPacing::AsFastAsPossible, double speed = 1.0) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (pacing == ReplayPacing::AsFastAsPossible || n == 0) {
+        for (; first != last; ++first) sink(*first);
+        return n;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    constexpr std::int64_t kSpinNs = 50'000;
+    const auto wall0 = Clock::now();
+    const std::int64_t ts0 = static_cast<std::int64_t>(ts_ns(*first));
+    for (; first != last; ++first) {
+        const double offset = static_cast<double>(static_cast<std::int64_t>(ts_ns(*first)) - ts0) / speed;
+        const auto due = wall0 + std::chrono::nanoseconds(static_cast<std::int64_t>(offset));
+        for (auto now = Clock::now(); now < due; now = Clock::now()) {
+            const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(due - now).count();
+            if (left > kSpinNs) std::this_thread::sleep_for(std::chrono::nanoseconds(left - kSpinNs));
+            else                cpu_relax();
+        }
+        sink(*first);
+    }
+    return n;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+// -----------------------------------------------------------------------------
+// Fixed-point (tick) prices
+// -----------------------------------------------------------------------------
+// A tick price is an integral count of the instrument's tick size. Integral
+// PriceTypes select the flat ladder book (OrderBook<>), compare and hash as
+// plain integers, and give exact level keys: 100.10 is tick 10010 no matter
+// how it was computed. Feeds stay in double; convert once at the boundary.
+// -----------------------------------------------------------------------------
+
+using Ticks32 = std::int32_t; // +-21M ticks: equities at 0.01 up to ~$21M
+using Ticks64 = std::int64_t; // wide ranges or sub-cent tick sizes
+
+/// Converts feed prices (double) to PriceType and back for one tick size.
+/// - Integral PriceType: fromTicks() is the tick count itself.
+/// - Floating PriceType: fromTicks() is ticks * tick_size, one expression for
+///   every price, so equal tick counts still give bit-identical level keys.
+/// Either way toTicks() rounds to the nearest tick, so orders built as
+/// fromTicks(toTicks(px) + k) land on the same grid for every PriceType.
+template <typename PriceType>
+class TickScale {
+    static_assert(std::is_arithmetic<PriceType>::value,
+                  "PriceType must be integral (ticks) or floating point");
+
+public:
+    explicit TickScale(double tick_size = 0.01) noexcept
+        : tick_(tick_size), inv_tick_(1.0 / tick_size) {}
+
+    double tickSize() const noexcept { return tick_; }
+
+    // Nearest tick of a feed price
+    std::int64_t toTicks(double px) const noexcept {
+        return static_cast<std::int64_t>(std::llround(px * inv_tick_));
+    }
+
+    PriceType fromTicks(std::int64_t ticks) const noexcept {
+        if constexpr (std::is_integral<PriceType>::value) return static_cast<PriceType>(ticks);
+        else return static_cast<PriceType>(static_cast<double>(ticks) * tick_);
+    }
+
+    // Feed price -> PriceType, snapped to the tick grid
+    PriceType fromDouble(double px) const noexcept { return fromTicks(toTicks(px)); }
+
+    // PriceType -> display / feed units
+    double toDouble(PriceType px) const noexcept {
+        if constexpr (std::is_integral<PriceType>::value) return static_cast<double>(px) * tick_;
+        else return static_cast<double>(px);
+    }
+
+private:
+    double tick_;
+    double inv_tick_;
+};
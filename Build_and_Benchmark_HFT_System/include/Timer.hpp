@@ -1,7 +1,12 @@
 #pragma once
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include "TscClock.hpp"
 
-class Timer {
+// Wall-clock timer on high_resolution_clock (~20 ns per now() on most boxes)
+class ChronoTimer {
 public:
     using Clock = std::chrono::high_resolution_clock;
 
@@ -18,3 +23,47 @@ public:
 private:
     Clock::time_point start_{Clock::now()};
 };
+
+// Cycle-counter timer (see TscClock); falls back to steady_clock when the TSC
+// isn't invariant. Same interface as ChronoTimer.
+class TscTimer {
+public:
+    void start() noexcept {
+        start_ = TscClock::start();
+    }
+
+    // Returns elapsed nanoseconds since start()
+    long long stop() const noexcept {
+        const std::uint64_t end = TscClock::stop();
+        return static_cast<long long>(TscClock::toNs(end - start_) + 0.5);
+    }
+
+private:
+    std::uint64_t start_ = 0;
+};
+
+using Timer = TscTimer;
+
+// Mean cost of an empty start()/stop() pair in ns: the floor under every
+// latency sample taken with TimerT. Subtract it when comparing to raw numbers.
+template <typename TimerT = Timer>
+double timerOverheadNs(int iterations = 200000) {
+    TscClock::calibrate();
+    long long total = 0;
+    for (int i = 0; i < iterations; ++i) {
+        TimerT t; t.start();
+        total += t.stop();
+    }
+    return static_cast<double>(total) / iterations;
+}
+
+// Benchmark header line: clock source, tick period and per-sample overhead
+inline void printTimerInfo(std::ostream& os) {
+    const double tsc_ns    = timerOverheadNs<TscTimer>();
+    const double chrono_ns = timerOverheadNs<ChronoTimer>();
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "Timer: %s (%.4f ns/tick), overhead %.1f ns/sample (chrono %.1f ns)\n",
+                  TscClock::source(), TscClock::nsPerTick(), tsc_ns, chrono_ns);
+    os << line;
+}
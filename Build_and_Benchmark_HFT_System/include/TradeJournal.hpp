@@ -0,0 +1,240 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "TickPrice.hpp"
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "TradeJournal writes records in host order and requires a little-endian target"
+#endif
+
+// --- On-disk format ---------------------------------------------------------
+// [JournalHeader][JournalRecord x count][unused, pre-sized tail]
+// All fields little-endian. `count` is advanced after each record is complete,
+// so a reader of a crashed journal only ever sees whole records.
+
+constexpr char          kJournalMagic[8] = {'H', 'F', 'T', 'J', 'R', 'N', 'L', '\0'};
+constexpr std::uint32_t kJournalVersion  = 2;
+
+enum class JournalPriceKind : std::uint8_t { SignedInt = 0, Float = 1 };
+
+struct JournalHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;  // offset of the first record
+    std::uint32_t record_size;  // sizeof(JournalRecord)
+    std::uint8_t  price_width;  // sizeof(PriceType): 4 or 8
+    std::uint8_t  price_kind;   // JournalPriceKind
+    std::uint8_t  reserved[2];
+    std::uint64_t capacity;     // records the file is currently sized for
+    std::uint64_t count;        // records written
+    double        tick_size;    // price tick of tick-encoded records (0: unused)
+    std::int64_t  id_base;      // ids are stored as offsets from this
+    std::uint8_t  pad[8];       // header fills exactly one cache line
+};
+static_assert(sizeof(JournalHeader) == 64, "JournalHeader must stay 64 bytes");
+
+/// Fixed 24-byte trade record with no padding. The price is a count of the
+/// header's tick_size and the ids are offsets from its id_base, so the layout
+/// does not depend on PriceType or OrderIdType (the price type is recorded in
+/// the header for decoding).
+struct JournalRecord {
+    std::int64_t  ts_ns;
+    std::uint32_t buy_id;       // id - id_base
+    std::uint32_t sell_id;      // id - id_base
+    std::int32_t  price_ticks;
+    std::int32_t  quantity;
+};
+static_assert(sizeof(JournalRecord) == 24 && std::has_unique_object_representations<JournalRecord>::value,
+              "JournalRecord must stay 24 bytes with no padding");
+
+/// A journal record decoded back to the trade's values.
+template <typename PriceType>
+struct JournalTrade {
+    std::int64_t ts_ns;
+    std::int64_t buy_id;
+    std::int64_t sell_id;
+    PriceType    price;
+    std::int32_t quantity;
+};
+
+template <typename PriceType>
+constexpr JournalPriceKind journalPriceKind() {
+    static_assert(std::is_floating_point<PriceType>::value || std::is_signed<PriceType>::value,
+                  "journal prices must be floating point or signed integers");
+    return std::is_floating_point<PriceType>::value ? JournalPriceKind::Float
+                                                    : JournalPriceKind::SignedInt;
+}
+
+/// Binary trade journal on a memory-mapped, pre-sized file.
+/// - push() is one fixed-size record store into the mapping plus a count update: no
+///   formatting and no syscall on the hot path
+/// - Size the file up front with the expected trade count; running past it
+///   remaps at double the size (a syscall, so keep it off the hot path)
+/// - The destructor truncates the file to the records actually written
+/// - Prices must sit on the tick grid and fit 32-bit ticks, and ids must lie
+///   within 2^32 of id_base; push() throws otherwise
+/// - Convert offline with `journal_to_csv` to the TradeLogger CSV columns
+template <typename TradeT>
+class TradeJournal {
+public:
+    using PriceType  = decltype(TradeT{}.price);
+    using RecordType = JournalRecord;
+
+    explicit TradeJournal(std::string path, std::size_t capacity_records = 1 << 20,
+                          double tick_size = 0.01, std::int64_t id_base = 0)
+        : file_(std::move(path), bytesFor(capacity_records ? capacity_records : 1), "TradeJournal"),
+          scale_(tick_size), id_base_(id_base) {
+        static_cast<void>(journalPriceKind<PriceType>()); // rejects unsupported price types
+        attach(capacity_records ? capacity_records : 1);
+
+        JournalHeader& h = header();
+        std::memcpy(h.magic, kJournalMagic, sizeof(h.magic));
+        h.version     = kJournalVersion;
+        h.header_size = sizeof(JournalHeader);
+        h.record_size = sizeof(RecordType);
+        h.price_width = sizeof(PriceType);
+        h.price_kind  = static_cast<std::uint8_t>(journalPriceKind<PriceType>());
+        h.capacity    = capacity_;
+        h.count       = 0;
+        h.tick_size   = tick_size;
+        h.id_base     = id_base;
+    }
+
+    TradeJournal(const TradeJournal&) = delete;
+    TradeJournal& operator=(const TradeJournal&) = delete;
+
+    ~TradeJournal() {
+        if (!file_) return;
+        header().capacity = count_;
+        file_.finish(bytesFor(count_)); // on failure the pre-sized file stays; count is still exact
+    }
+
+    void push(const TradeT& t) {
+        if (count_ == capacity_) grow();
+        RecordType r{};
+        r.ts_ns       = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            t.ts.time_since_epoch()).count();
+        r.buy_id      = idOffset(t.buy_id);
+        r.sell_id     = idOffset(t.sell_id);
+        r.price_ticks = priceTicks(t.price);
+        r.quantity    = t.quantity;
+        records_[count_] = r;
+        header().count = ++count_;
+    }
+
+    // Lets the journal be passed straight to MatchingEngine::submit as a trade sink
+    void operator()(const TradeT& t) { push(t); }
+
+    void append(const std::vector<TradeT>& trades) {
+        for (const auto& t : trades) push(t);
+    }
+
+    // Schedule write-back of dirty pages (the kernel writes them back regardless)
+    void flush() { file_.flush(); }
+
+    std::size_t size() const noexcept { return count_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    const std::string& path() const noexcept { return file_.path(); }
+
+private:
+    JournalHeader& header() noexcept { return *reinterpret_cast<JournalHeader*>(file_.data()); }
+
+    static std::size_t bytesFor(std::size_t records) noexcept {
+        return sizeof(JournalHeader) + records * sizeof(RecordType);
+    }
+
+    template <typename IdT>
+    std::uint32_t idOffset(IdT id) const {
+        const std::int64_t off = static_cast<std::int64_t>(id) - id_base_;
+        if (off < 0 || off > static_cast<std::int64_t>(UINT32_MAX))
+            throw std::runtime_error("TradeJournal: order id out of range of id_base in " + path());
+        return static_cast<std::uint32_t>(off);
+    }
+
+    std::int32_t priceTicks(PriceType px) const {
+        std::int64_t ticks;
+        if constexpr (std::is_integral<PriceType>::value) {
+            ticks = static_cast<std::int64_t>(px); // integral prices are ticks already
+        } else {
+            ticks = scale_.toTicks(static_cast<double>(px));
+            if (scale_.fromTicks(ticks) != px)
+                throw std::runtime_error("TradeJournal: price off the tick grid in " + path());
+        }
+        if (ticks < INT32_MIN || ticks > INT32_MAX)
+            throw std::runtime_error("TradeJournal: price out of 32-bit tick range in " + path());
+        return static_cast<std::int32_t>(ticks);
+    }
+
+    void attach(std::size_t capacity_records) noexcept {
+        capacity_ = capacity_records;
+        records_  = reinterpret_cast<RecordType*>(file_.data() + sizeof(JournalHeader));
+    }
+
+    void grow() {
+        file_.resize(bytesFor(capacity_ * 2));
+        attach(capacity_ * 2);
+        header().capacity = capacity_;
+    }
+
+    MappedFileWriter file_;
+    TickScale<PriceType> scale_;
+    std::int64_t id_base_;
+    RecordType* records_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t count_ = 0;
+};
+
+/// Read-only view of a journal file. Validates the header; records are read in
+/// place from the mapping and decoded with the header's tick size and id base.
+class TradeJournalReader {
+public:
+    explicit TradeJournalReader(const std::string& path)
+        : file_(path, sizeof(JournalHeader), "TradeJournalReader", "trade journal", MapAccess::Random) {
+        const JournalHeader& h = header();
+        const bool ok = std::memcmp(h.magic, kJournalMagic, sizeof(h.magic)) == 0
+                     && h.version == kJournalVersion
+                     && h.header_size >= sizeof(JournalHeader)
+                     && h.record_size == sizeof(JournalRecord)
+                     && file_.fits(h.header_size, h.count, h.record_size);
+        if (!ok) throw std::runtime_error("TradeJournalReader: bad header in " + path);
+    }
+
+    const JournalHeader& header() const noexcept {
+        return *reinterpret_cast<const JournalHeader*>(file_.data());
+    }
+    std::size_t size() const noexcept { return static_cast<std::size_t>(header().count); }
+
+    // True if the journal was written with PriceType prices
+    template <typename PriceType>
+    bool holds() const noexcept {
+        return header().price_width == sizeof(PriceType)
+            && header().price_kind == static_cast<std::uint8_t>(journalPriceKind<PriceType>());
+    }
+
+    // Raw records, as stored
+    const JournalRecord* records() const noexcept {
+        return reinterpret_cast<const JournalRecord*>(file_.data() + header().header_size);
+    }
+
+    // Record i decoded to PriceType prices and full ids; check holds<PriceType>() first
+    template <typename PriceType>
+    JournalTrade<PriceType> trade(std::size_t i) const noexcept {
+        const JournalHeader& h = header();
+        const JournalRecord& r = records()[i];
+        return JournalTrade<PriceType>{r.ts_ns, h.id_base + r.buy_id, h.id_base + r.sell_id,
+                                       TickScale<PriceType>(h.tick_size).fromTicks(r.price_ticks),
+                                       r.quantity};
+    }
+
+private:
+    MappedFileReader file_;
+};
@@ -4,6 +4,31 @@
 #include <string>
 #include <utility>
 #include <chrono>
+#include <ostream>
+
+// CSV layout shared by every trade logger / converter
+inline void writeTradeCsvHeader(std::ostream& os) {
+    os << "buy_id,sell_id,price,quantity,timestamp_ns\n";
+}
+
+template <typename IdT, typename PriceT>
+void writeTradeCsvFields(std::ostream& os, IdT buy_id, IdT sell_id, PriceT price,
+                         int quantity, long long ts_ns) {
+    os << buy_id   << ','
+       << sell_id  << ','
+       << price    << ','
+       << quantity << ','
+       << ts_ns    << '\n';
+}
+
+template <typename TradeT>
+void writeTradeCsvRow(std::ostream& os, const TradeT& t) {
+    long long ts_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            t.ts.time_since_epoch()).count();
+
+    writeTradeCsvFields(os, t.buy_id, t.sell_id, t.price, t.quantity, ts_ns);
+}
 
 template <typename TradeT>
 class TradeLogger {
@@ -11,7 +36,7 @@ public:
     explicit TradeLogger(std::string path, std::size_t batch_size = 4096)
         : path_(std::move(path)), batch_size_(batch_size) {
         file_.open(path_, std::ios::out | std::ios::trunc);
-        file_ << "buy_id,sell_id,price,quantity,timestamp_ns\n";
+        writeTradeCsvHeader(file_);
         buffer_.reserve(batch_size_);
     }
 
@@ -27,23 +52,16 @@ public:
         if (buffer_.size() >= batch_size_) flush();
     }
 
+    // Lets the logger be passed straight to MatchingEngine::submit as a trade sink
+    void operator()(const TradeT& t) { push(t); }
+
     void append(const std::vector<TradeT>& trades) {
         for (const auto& t : trades) push(t);
     }
 
     void flush() {
         if (buffer_.empty()) return;
-        for (const auto& t : buffer_) {
-            long long ts_ns =
-                std::chrono::duration_cast<std::chrono::nanoseconds>(
-                    t.ts.time_since_epoch()).count();
-
-            file_ << t.buy_id   << ','
-                  << t.sell_id  << ','
-                  << t.price    << ','
-                  << t.quantity << ','
-                  << ts_ns      << '\n';
-        }
+        for (const auto& t : buffer_) writeTradeCsvRow(file_, t);
         buffer_.clear();
         file_.flush();
     }
@@ -0,0 +1,135 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+/// Cycle-counter clock with a one-time calibration against steady_clock.
+/// - x86: rdtsc/rdtscp with lfence, used only when CPUID reports an invariant
+///   TSC (constant rate across P-states, keeps ticking in C-states)
+/// - aarch64: the generic timer's virtual counter (cntvct_el0), constant rate
+///   by architecture
+/// - Anywhere else, or without an invariant TSC, ticks are steady_clock ns
+/// Call calibrate() once at startup: the first use otherwise pays ~20 ms.
+class TscClock {
+public:
+    // Timestamp for the start of a measured region: earlier instructions retire
+    // before the read, later ones don't start until it's done.
+    static std::uint64_t start() noexcept {
+        if (!state().tsc) return chronoNs();
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_lfence();
+        const std::uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+#elif defined(__aarch64__)
+        return readVirtualCounter();
+#else
+        return chronoNs();
+#endif
+    }
+
+    // Timestamp for the end of a measured region: rdtscp waits for the region's
+    // instructions to finish, the lfence keeps later work from starting early.
+    static std::uint64_t stop() noexcept {
+        if (!state().tsc) return chronoNs();
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned aux;
+        const std::uint64_t t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+#elif defined(__aarch64__)
+        return readVirtualCounter();
+#else
+        return chronoNs();
+#endif
+    }
+
+    static double toNs(std::uint64_t ticks) noexcept {
+        return static_cast<double>(ticks) * state().nsPerTick;
+    }
+
+    static void calibrate() noexcept { (void)state(); }
+    static bool usingTsc() noexcept { return state().tsc; }
+    static double nsPerTick() noexcept { return state().nsPerTick; }
+
+    // Source name for benchmark headers
+    static const char* source() noexcept {
+        if (!usingTsc()) return "steady_clock";
+#if defined(__aarch64__)
+        return "cntvct_el0";
+#else
+        return "rdtsc";
+#endif
+    }
+
+private:
+    struct State {
+        bool tsc = false;
+        double nsPerTick = 1.0;
+    };
+
+    static std::uint64_t chronoNs() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+#if defined(__aarch64__)
+    static std::uint64_t readVirtualCounter() noexcept {
+        std::uint64_t v;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r"(v) :: "memory");
+        return v;
+    }
+#endif
+
+    static bool hasInvariantTsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned a, b, c, d;
+        if (!__get_cpuid(0x80000000u, &a, &b, &c, &d) || a < 0x80000007u) return false;
+        __get_cpuid(0x80000007u, &a, &b, &c, &d);
+        return (d & (1u << 8)) != 0; // "Invariant TSC"
+#elif defined(__aarch64__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static State calibrateNow() noexcept {
+        State s;
+        if (!hasInvariantTsc()) return s;
+        s.tsc = true;
+
+        // Busy-wait ~20 ms of steady_clock and count ticks over the same span
+        using Clock = std::chrono::steady_clock;
+        const auto c0 = Clock::now();
+        const std::uint64_t t0 = rawTicks();
+        auto c1 = c0;
+        while (c1 - c0 < std::chrono::milliseconds(20)) c1 = Clock::now();
+        const std::uint64_t t1 = rawTicks();
+
+        const double ns = std::chrono::duration<double, std::nano>(c1 - c0).count();
+        if (t1 <= t0) return State{}; // counter not usable
+        s.nsPerTick = ns / static_cast<double>(t1 - t0);
+        return s;
+    }
+
+    static std::uint64_t rawTicks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned aux;
+        return __rdtscp(&aux);
+#elif defined(__aarch64__)
+        return readVirtualCounter();
+#else
+        return chronoNs();
+#endif
+    }
+
+    static const State& state() noexcept {
+        static const State s = calibrateNow();
+        return s;
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+/// Simple, fast xorshift32 PRNG (deterministic). Shared by the CRTP
+/// experiment (its utils.hpp includes this header) and LoadGenerator.
+struct XorShift32 {
+    std::uint32_t state;
+
+    explicit XorShift32(std::uint32_t seed = 0xDEADBEEF) : state(seed) {}
+
+    /// Counter-based stream: generator for block `index` of a sequence seeded
+    /// with `seed`. Depends only on (seed, index), so any thread can produce
+    /// any block and the sequence is the same for every thread count.
+    static XorShift32 stream(std::uint32_t seed, std::uint64_t index) noexcept {
+        // splitmix64 finalizer over (seed, index); xorshift state must be non-zero
+        std::uint64_t z = (std::uint64_t{seed} << 32) ^ (index * 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        const auto s = static_cast<std::uint32_t>(z ^ (z >> 32));
+        return XorShift32(s ? s : 0xDEADBEEF);
+    }
+
+    std::uint32_t next_u32() {
+        std::uint32_t x = state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state = x;
+        return x;
+    }
+
+    // Produce doubles in [low, high)
+    double uniform(double low, double high) {
+        // 24-bit mantissa extraction for uniformity
+        const double scale = 1.0 / (1u << 24);
+        double u = (next_u32() & 0xFFFFFF) * scale;
+        return low + (high - low) * u;
+    }
+
+    // Integer in [low, high] (modulo bias is negligible for the spans used here)
+    std::int32_t between(std::int32_t low, std::int32_t high) {
+        const auto span = static_cast<std::uint32_t>(high - low) + 1u;
+        return low + static_cast<std::int32_t>(next_u32() % span);
+    }
+};
@@ -0,0 +1,2 @@
+// Intentionally empty: AsyncTradeLogger is a template (header-only)
+#include "../include/AsyncTradeLogger.hpp"
@@ -0,0 +1,2 @@
+// Intentionally empty: BookManager is a template (header-only)
+#include "../include/BookManager.hpp"
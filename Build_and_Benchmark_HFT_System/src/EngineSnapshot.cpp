@@ -0,0 +1,2 @@
+// Intentionally empty: EngineSnapshot is a template (header-only)
+#include "../include/EngineSnapshot.hpp"
@@ -0,0 +1,58 @@
+// Offline converter: binary TradeJournal -> the TradeLogger CSV columns
+//   journal_to_csv trades.bin [trades.csv]
+// Without an output path it writes alongside the input: trades.bin -> trades.bin.csv
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "../include/TradeJournal.hpp"
+#include "../include/TradeLogger.hpp"
+
+template <typename PriceType>
+static std::size_t convert(const TradeJournalReader& in, std::ostream& out) {
+    const std::size_t n = in.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const JournalTrade<PriceType> t = in.trade<PriceType>(i);
+        writeTradeCsvFields(out, t.buy_id, t.sell_id, t.price, t.quantity, static_cast<long long>(t.ts_ns));
+    }
+    return n;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <journal.bin> [out.csv]\n";
+        return 2;
+    }
+    const std::string in_path = argv[1];
+    // Appending (rather than swapping the extension) never names the input,
+    // even for a journal called *.csv or one inside a dotted directory
+    const std::string out_path = argc > 2 ? argv[2] : in_path + ".csv";
+    std::error_code ec;
+    if (out_path == in_path || std::filesystem::equivalent(in_path, out_path, ec)) {
+        std::cerr << "journal_to_csv: output " << out_path << " is the input journal\n";
+        return 2;
+    }
+
+    try {
+        TradeJournalReader in(in_path);
+        std::ofstream out(out_path, std::ios::out | std::ios::trunc);
+        if (!out) throw std::runtime_error("cannot open " + out_path);
+        writeTradeCsvHeader(out);
+
+        std::size_t n = 0;
+        if      (in.holds<double>())       n = convert<double>(in, out);
+        else if (in.holds<float>())        n = convert<float>(in, out);
+        else if (in.holds<std::int64_t>()) n = convert<std::int64_t>(in, out);
+        else if (in.holds<std::int32_t>()) n = convert<std::int32_t>(in, out);
+        else throw std::runtime_error("unsupported price type in " + in_path);
+
+        std::cout << "Wrote " << n << " trades to " << out_path << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "journal_to_csv: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,2 @@
+// Intentionally empty: LoadGenerator is header-only (its order flow is templated)
+#include "../include/LoadGenerator.hpp"
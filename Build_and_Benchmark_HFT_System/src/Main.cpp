@@ -1,78 +1,135 @@
-#include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <numeric>
+#include <memory>
 #include <random>
+#include <string>
 #include <vector>
 #include <cmath>
 
 #include "../include/MarketData.hpp"
+#include "../include/TickFile.hpp"
 #include "../include/Order.hpp"
 #include "../include/OrderBook.hpp"
-#include "../include/OrderManager.hpp"
+#include "../include/PooledOrderManager.hpp"
 #include "../include/MatchingEngine.hpp"
+#include "../include/BookManager.hpp"
 #include "../include/Timer.hpp"
-#include "../include/TradeLogger.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include "../include/AsyncTradeLogger.hpp"
+#include "../include/RuntimeConfig.hpp"
 
 // Alias types used throughout the run
 using Price  = double;
 using OrderId= int;
 
 using OrderType  = Order<Price, OrderId>;
-using Book       = OrderBook<Price, OrderId>;
-using OMS        = OrderManager<Price, OrderId>;
-using Engine     = MatchingEngine<Price, OrderId>;
 using TradeType  = Trade<Price, OrderId>;
+using Books      = BookManager<Price, OrderId>;
 
-static void analyzeLatencies(std::vector<long long>& latencies) {
-    if (latencies.empty()) return;
+static void analyzeLatencies(const LatencyHistogram& h) {
+    if (h.empty()) return;
 
-    std::sort(latencies.begin(), latencies.end());
-    long long minv = latencies.front();
-    long long maxv = latencies.back();
-    double mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+    std::cout << "Tick-to-Trade Latency (nanoseconds):\n";
+    std::cout << "Samples: " << h.count()
+              << "\nMin: " << h.min()
+              << "\nMax: " << h.max()
+              << "\nMean: " << h.mean()
+              << "\nStdDev: " << h.stddev()
+              << "\nP50: " << h.percentile(0.50)
+              << "\nP90: " << h.percentile(0.90)
+              << "\nP99: " << h.percentile(0.99)
+              << "\nP99.9: " << h.percentile(0.999) << "\n";
+}
 
-    double variance = 0.0;
-    for (auto l : latencies) {
-        double d = (double)l - mean;
-        variance += d * d;
+// Usage: hft_app [--record FILE] [--replay FILE [--paced]] [runtime flags]
+//   --record  capture the generated ticks to FILE before running them
+//   --replay  run a captured tick file, mapped in place, instead of generating
+//   --paced   replay with the captured inter-tick gaps (default: as fast as possible)
+//   runtime flags (RuntimeConfig.hpp): --cpu-matcher N pins the tick loop,
+//   --cpu-logger N the trade writer, --huge-pages backs the books' arenas
+int main(int argc, char** argv) {
+    std::string record_path, replay_path;
+    bool paced = false;
+    RuntimeConfig runtime;
+    constexpr unsigned kRoles = kRoleMatcher | kRoleLogger; // no feed or shard threads here
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        if (arg == "--record" && a + 1 < argc)      record_path = argv[++a];
+        else if (arg == "--replay" && a + 1 < argc) replay_path = argv[++a];
+        else if (arg == "--paced")                  paced = true;
+        else if (parseRuntimeFlag(a, argc, argv, runtime, kRoles)) {}
+        else {
+            std::cerr << "usage: " << argv[0] << " [--record FILE] [--replay FILE [--paced]]\n";
+            printRuntimeUsage(std::cerr, kRoles);
+            return 2;
+        }
     }
-    double stddev = std::sqrt(variance / latencies.size());
 
-    std::size_t p99_idx = static_cast<std::size_t>(latencies.size() * 0.99);
-    if (p99_idx >= latencies.size()) p99_idx = latencies.size() - 1;
-    long long p99 = latencies[p99_idx];
+    // Arena policy and pinning before anything is reserved: the books are
+    // built on this (matcher) thread, so their pages land on its node
+    applyRuntimeConfig(runtime);
+    if (runtime.matcher_cpu >= 0 && !pin_current_thread(runtime.matcher_cpu))
+        std::cerr << "could not pin matcher to cpu " << runtime.matcher_cpu << ", running unpinned\n";
+    printRuntimeConfig(std::cout, runtime, kRoles);
 
-    std::cout << "Tick-to-Trade Latency (nanoseconds):\n";
-    std::cout << "Min: " << minv
-              << "\nMax: " << maxv
-              << "\nMean: " << mean
-              << "\nStdDev: " << stddev
-              << "\nP99: " << p99 << "\n";
-}
+    // Calibrate the TSC up front and report what one latency sample costs
+    printTimerInfo(std::cout);
 
-int main() {
     // --- Modules ------------------------------------------------------------
-    Book   book;
-    OMS    oms;
-    Engine engine(book, oms);
-
-    // Reserve for fewer rehashes under load
+    // One book / OMS / engine per symbol, routed by instrument id
+    Books books;
     constexpr std::size_t N_ORDERS = 100000;
-    book.reserve(N_ORDERS);
-    oms.reserve(N_ORDERS);
 
-    // Trade logger: batch to CSV
-    TradeLogger<TradeType> logger("trades.csv", 4096);
+    // Trade logger: push() copies into a ring, a writer thread formats the CSV
+    AsyncTradeLogger<TradeType> logger("trades.csv", 1 << 16, Backpressure::Block, runtime.logger_cpu);
+
+    // --- Tick source: mock market data in RAM, or a capture mapped in place --
+    std::vector<MarketData> generated;
+    MarketDataFeed feed(generated);
+    std::unique_ptr<MappedTickFile<MarketData>> capture;
+    const MarketData* first = nullptr;
+    const MarketData* last  = nullptr;
+    const SymbolTable* symbols = nullptr;
+
+    if (!replay_path.empty()) {
+        capture = std::make_unique<MappedTickFile<MarketData>>(replay_path);
+        first   = capture->begin();
+        last    = capture->end();
+        symbols = &capture->symbols();
+    } else {
+        const int NUM_TICKS = 10000;
+        feed.generateData(NUM_TICKS); // fixed seed: reproducible runs
+        first   = generated.data();
+        last    = first + generated.size();
+        symbols = &feed.symbols();
+        if (!record_path.empty()) {
+            try {
+                TickRecorder<MarketData> recorder(record_path);
+                recorder.record(first, last);
+                recorder.close(symbols);
+                std::cout << "Recorded " << recorder.size() << " ticks to " << record_path << "\n";
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return 1;
+            }
+        }
+    }
+    if (symbols->size() == 0) {
+        std::cerr << "tick source has no symbols\n";
+        return 1;
+    }
 
-    // --- Generate mock market data -----------------------------------------
-    std::vector<MarketData> ticks;
-    MarketDataFeed feed(ticks);
-    const int NUM_TICKS = 10000;
-    feed.generateData(NUM_TICKS);
+    // Register the source's symbols in id order so symbol_id == instrument id
+    // (reserving for fewer rehashes under load)
+    const std::size_t n_ticks = static_cast<std::size_t>(last - first);
+    const std::size_t per_instrument = (n_ticks > N_ORDERS ? n_ticks : N_ORDERS) / symbols->size();
+    for (std::uint32_t id = 0; id < symbols->size(); ++id)
+        books.addInstrument(symbols->name(id), per_instrument);
 
     // --- Create orders and measure tick-to-trade latency --------------------
-    std::vector<long long> latencies;
-    latencies.reserve(NUM_TICKS);
+    // Fixed-memory histogram; prints an interval snapshot every SNAPSHOT_EVERY ticks
+    IntervalLatencyHistogram latencies;
+    const std::size_t SNAPSHOT_EVERY = 2500;
 
     // Randomize some aggressiveness so we get trades
     std::mt19937 rng(12345);
@@ -81,10 +138,9 @@ int main() {
     std::uniform_real_distribution<Price> skew(-0.10, 0.10); // +/- 10 cents
 
     OrderId next_id = 1;
+    std::size_t i = 0;
 
-    for (int i = 0; i < NUM_TICKS; ++i) {
-        const auto& md = ticks[i];
-
+    auto on_tick = [&](const MarketData& md) {
         // Simple strategy: place orders near mid with small skew to create crosses
         Price mid = (md.bid_price + md.ask_price) * 0.5;
         bool is_buy = (side_dist(rng) == 1);
@@ -94,25 +150,39 @@ int main() {
         // Start latency timer at "tick received"
         Timer t; t.start();
 
-        // Submit the order (engine will match immediately if it crosses)
+        // Route to the symbol's engine by id (matches immediately if it crosses)
         OrderType o{next_id++, px, qty, is_buy};
-        auto trades = engine.submit(o);
+        // Trades go straight to the async logger: no formatting or I/O on this thread
+        const std::size_t n_fills = books.submit(md.symbol_id, o, logger);
 
         // If a trade was produced, stop the clock (tick -> trade)
-        if (!trades.empty()) {
+        if (n_fills > 0) {
             long long ns = t.stop();
-            latencies.push_back(ns);
-            logger.append(trades); // batch write
+            latencies.record(ns);
         }
-    }
 
-    // Flush any buffered trades
+        if (++i % SNAPSHOT_EVERY == 0)
+            latencies.rollover(std::cout, "Interval ticks<=" + std::to_string(i) + ":");
+    };
+
+    replayTicks(first, last, on_tick,
+                [](const MarketData& md) { return md.exchange_ts_ns; },
+                paced ? ReplayPacing::Original : ReplayPacing::AsFastAsPossible);
+
+    // Wait for the writer thread to drain the ring
     logger.flush();
 
     // Analyze latency
-    analyzeLatencies(latencies);
-
-    // Show top-of-book snapshot (optional)
-    std::cout << "BestBid: " << book.bestBid() << "  BestAsk: " << book.bestAsk() << "\n";
+    analyzeLatencies(latencies.total());
+
+    // Show top-of-book snapshot per symbol (optional)
+    for (std::uint32_t id = 0; id < books.size(); ++id) {
+        const auto& inst = books.instrument(id);
+        std::cout << inst.symbol << " BestBid: ";
+        if (inst.book.hasBid()) std::cout << inst.book.bestBid(); else std::cout << "-";
+        std::cout << "  BestAsk: ";
+        if (inst.book.hasAsk()) std::cout << inst.book.bestAsk(); else std::cout << "-";
+        std::cout << "\n";
+    }
     return 0;
 }
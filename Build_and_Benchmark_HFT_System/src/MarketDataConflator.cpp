@@ -0,0 +1,2 @@
+// Intentionally empty: MarketDataConflator is a template (header-only)
+#include "../include/MarketDataConflator.hpp"
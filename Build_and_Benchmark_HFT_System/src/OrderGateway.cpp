@@ -0,0 +1,2 @@
+// Intentionally empty: OrderGateway is a template (header-only)
+#include "../include/OrderGateway.hpp"
@@ -0,0 +1,2 @@
+// Intentionally empty: OrderJournal is a template (header-only)
+#include "../include/OrderJournal.hpp"
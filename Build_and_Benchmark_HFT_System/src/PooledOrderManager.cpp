@@ -0,0 +1,2 @@
+// Intentionally empty: PooledOrderManager is a template (header-only)
+#include "../include/PooledOrderManager.hpp"
@@ -0,0 +1,2 @@
+// Intentionally empty: ShardedEngine is a template (header-only)
+#include "../include/ShardedEngine.hpp"
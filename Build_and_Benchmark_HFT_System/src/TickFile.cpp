@@ -0,0 +1,2 @@
+// Intentionally empty: TickFile is a template (header-only)
+#include "../include/TickFile.hpp"
@@ -0,0 +1,2 @@
+// Intentionally empty: TradeJournal is a template (header-only)
+#include "../include/TradeJournal.hpp"
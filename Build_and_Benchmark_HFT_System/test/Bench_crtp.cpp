@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../include/BenchRunner.hpp"
+#include "market_data.hpp"
+#include "signal_simd.hpp"
+#include "strategy_crtp.hpp"
+#include "strategy_virtual.hpp"
+#include "utils.hpp"
+
+// The CRTP experiment's rows (free_function, virtual_call, crtp_call,
+// simd_batch) as suite cases. Ticks and alphas match its main.cpp defaults.
+// Its headers are reached through the hft-crtp-include link that
+// CMakeLists.txt creates in the build tree.
+
+namespace {
+
+constexpr std::uint32_t kCrtpTicks = 1'000'000;
+constexpr std::size_t   kCrtpBatch = 1024;
+constexpr double kAlpha1 = 0.75;
+constexpr double kAlpha2 = 0.25;
+
+const std::vector<Quote>& crtp_ticks() {
+    static const std::vector<Quote> ticks = [] {
+        std::vector<Quote> out(kCrtpTicks);
+        XorShift32 rng(0xC001D00D);
+        for (Quote& q : out) {
+            const double midp = rng.uniform(99.5, 100.5);
+            const double sprd = rng.uniform(0.0005, 0.02);
+            const double bq   = rng.uniform(100.0, 5000.0);
+            const double aq   = rng.uniform(100.0, 5000.0);
+            q = Quote{.bid = midp - 0.5 * sprd, .ask = midp + 0.5 * sprd, .bid_qty = bq, .ask_qty = aq};
+        }
+        return out;
+    }();
+    return ticks;
+}
+
+double signal_free(const Quote& q, double a1, double a2) {
+    return a1 * (microprice(q) - mid(q)) + a2 * imbalance(q);
+}
+
+template <typename F>
+void per_tick_case(BenchState& st, F&& func) {
+    const std::vector<Quote>& ticks = crtp_ticks();
+    double sink = 0.0;
+    st.measure(ticks.size(), [&] {
+        for (const Quote& q : ticks) sink += func(q) * 1e-9;
+    });
+    benchKeep(sink);
+}
+
+} // namespace
+
+void registerCrtpBenchmarks(BenchRegistry& registry) {
+    registry.add("crtp/free_function", [](BenchState& st) {
+        per_tick_case(st, [](const Quote& q) { return signal_free(q, kAlpha1, kAlpha2); });
+    });
+
+    registry.add("crtp/virtual_call", [](BenchState& st) {
+        static SignalStrategyVirtual virt(kAlpha1, kAlpha2);
+        IStrategy* s = &virt;
+        benchKeep(s); // keep the call indirect
+        per_tick_case(st, [s](const Quote& q) { return s->on_tick(q); });
+    });
+
+    registry.add("crtp/crtp_call", [](BenchState& st) {
+        SignalStrategyCRTP crtp(kAlpha1, kAlpha2);
+        per_tick_case(st, [&crtp](const Quote& q) { return crtp.on_tick(q); });
+    });
+
+    registry.add("crtp/simd_batch", [](BenchState& st) {
+        static const QuoteBlock block(crtp_ticks());
+        SignalStrategyCRTP crtp(kAlpha1, kAlpha2);
+        std::vector<double> out(kCrtpBatch);
+        double sink = 0.0;
+        st.measure(block.size(), [&] {
+            for (std::size_t first = 0; first < block.size(); first += kCrtpBatch) {
+                const std::size_t n = std::min(kCrtpBatch, block.size() - first);
+                crtp.on_ticks(block.view(first, n), std::span<double>(out.data(), n));
+                sink += out[n - 1] * 1e-9;
+            }
+        });
+        benchKeep(sink);
+    });
+}
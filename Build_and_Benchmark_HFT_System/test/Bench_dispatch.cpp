@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/BenchRunner.hpp"
+#include "../../Measuring Virtual vs Non‑Virtual Dispatch in a Minimal HFT Order Processor/order_dispatch.hpp"
+
+// The dispatch experiment's stream patterns x implementations as suite cases:
+// virtual (one Processor* per order) and every OrderDispatcher mode. Orders,
+// seeds and patterns match hft_assignment.cpp, at 1M orders per repetition.
+
+namespace {
+
+using namespace order_dispatch;
+
+constexpr std::size_t kDispatchOrders = 1'000'000;
+
+const std::vector<Order>& dispatch_orders() {
+    static const std::vector<Order> orders = generate_random_orders(kDispatchOrders);
+    return orders;
+}
+
+std::vector<int> make_pattern(const std::string& name) {
+    std::vector<int> types(kDispatchOrders, 0); // homogeneous: all 'A'
+    if (name == "mixed_random") {
+        std::mt19937 rng(54321);
+        std::uniform_int_distribution<int> dist(0, 1);
+        for (int& t : types) t = dist(rng);
+    } else if (name == "bursty") {
+        for (std::size_t i = 0; i < types.size(); ++i) types[i] = (i % 80) < 64 ? 0 : 1; // 64 A, 16 B
+    }
+    return types;
+}
+
+} // namespace
+
+void registerDispatchBenchmarks(BenchRegistry& registry) {
+    for (const char* pattern : {"homogeneous", "mixed_random", "bursty"}) {
+        const std::string prefix = std::string("dispatch/") + pattern + "/";
+        const auto types = std::make_shared<const std::vector<int>>(make_pattern(pattern));
+
+        registry.add(prefix + "virtual", [types](BenchState& st) {
+            static StrategyA_V a;
+            static StrategyB_V b;
+            const std::vector<Order>& orders = dispatch_orders();
+            std::vector<Processor*> procs(orders.size());
+            for (std::size_t i = 0; i < orders.size(); ++i)
+                procs[i] = (*types)[i] == 0 ? static_cast<Processor*>(&a) : static_cast<Processor*>(&b);
+
+            std::uint64_t sum = 0;
+            st.measure(orders.size(), [&] {
+                for (std::size_t i = 0; i < orders.size(); ++i) sum += procs[i]->process(orders[i]);
+            });
+            benchKeep(sum);
+        });
+
+        for (DispatchMode mode : kDispatchModes) {
+            registry.add(prefix + dispatch_mode_name(mode), [types, mode](BenchState& st) {
+                static OrderDispatcher dispatcher;
+                const std::vector<Order>& orders = dispatch_orders();
+                std::uint64_t sum = 0;
+                st.measure(orders.size(), [&] { sum = dispatcher.dispatch(mode, orders, *types); });
+                benchKeep(sum);
+            });
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/BenchRunner.hpp"
+#include "../include/BookManager.hpp"
+#include "../include/MarketData.hpp"
+#include "../include/MatchingEngine.hpp"
+#include "../include/Order.hpp"
+#include "../include/OrderBook.hpp"
+#include "../include/PooledOrderManager.hpp"
+
+// Unified benchmark runner: the matching-engine cases below plus the CRTP
+// tick-processing cases (Bench_crtp.cpp) and the order-dispatch cases
+// (Bench_dispatch.cpp), all under one warmup/reps/pinning policy, with
+// JSON/CSV output and a baseline regression check.
+//
+//   hft_bench --json base.json                  # record a baseline
+//   hft_bench --baseline base.json --threshold 0.1   # exit 1 on regression
+
+void registerCrtpBenchmarks(BenchRegistry& registry);
+void registerDispatchBenchmarks(BenchRegistry& registry);
+
+using Price   = double;
+using OrderId = int;
+
+using OrderType = Order<Price, OrderId>;
+using Book      = OrderBook<Price, OrderId>;
+using OMS       = PooledOrderManager<Price, OrderId>;
+using Engine    = MatchingEngine<Price, OrderId>;
+using TradeType = Trade<Price, OrderId>;
+using Books     = BookManager<Price, OrderId>;
+
+constexpr int kEngineOrders = 200'000;
+
+struct FlowOrder {
+    std::uint32_t instrument;
+    OrderType order;
+};
+
+// Same synthetic flow as Test_latency's run_trial: orders a few cents either
+// side of each tick's mid, so roughly half of them cross (built untimed)
+static std::vector<FlowOrder> make_engine_flow(int n, std::uint32_t instruments) {
+    std::vector<MarketData> ticks;
+    MarketDataFeed feed(ticks, instruments);
+    feed.generateData(n);
+
+    std::mt19937 rng(2025);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> qty_dist(10, 200);
+    std::uniform_real_distribution<Price> skew(0.0, 0.10);
+
+    std::vector<FlowOrder> flow;
+    flow.reserve(static_cast<std::size_t>(n));
+    OrderId next_id = 1;
+    for (const MarketData& md : ticks) {
+        const Price mid = (md.bid_price + md.ask_price) * 0.5;
+        const bool is_buy = side_dist(rng) == 1;
+        const int qty = qty_dist(rng);
+        const Price px = is_buy ? mid + skew(rng) : mid - skew(rng);
+        flow.push_back(FlowOrder{md.symbol_id, OrderType{next_id++, px, qty, is_buy}});
+    }
+    return flow;
+}
+
+static void registerEngineBenchmarks(BenchRegistry& registry) {
+    // Throughput: one timed region over the whole flow into a reserved engine
+    registry.add("engine/submit", [](BenchState& st) {
+        static const std::vector<FlowOrder> flow = make_engine_flow(kEngineOrders, 10);
+        Book book;
+        OMS oms;
+        Engine engine(book, oms);
+        oms.reserve(flow.size());
+        book.reserveLevels(flow.size()); // double prices: up to one level per order
+        engine.reserveLevels(flow.size());
+
+        std::uint64_t trades = 0;
+        auto sink = [&](const TradeType&) { ++trades; };
+        st.measure(flow.size(), [&] {
+            for (const FlowOrder& f : flow) engine.submit(f.order, sink);
+        });
+        benchKeep(trades);
+    });
+
+    // Same flow through submitBatch() in bursts of 16
+    registry.add("engine/submit_batch16", [](BenchState& st) {
+        static const std::vector<OrderType> orders = [] {
+            std::vector<OrderType> out;
+            for (const FlowOrder& f : make_engine_flow(kEngineOrders, 10)) out.push_back(f.order);
+            return out;
+        }();
+        constexpr std::size_t kBatch = 16;
+        Book book;
+        OMS oms;
+        Engine engine(book, oms);
+        oms.reserve(orders.size());
+        book.reserveLevels(orders.size());
+        engine.reserveLevels(orders.size());
+
+        std::uint64_t trades = 0;
+        auto sink = [&](const TradeType&) { ++trades; };
+        st.measure(orders.size(), [&] {
+            for (std::size_t i = 0; i < orders.size(); i += kBatch)
+                engine.submitBatch(orders.data() + i, std::min(kBatch, orders.size() - i), sink);
+        });
+        benchKeep(trades);
+    });
+
+    // Latency: every submit timed on its own, so the suite tracks p99
+    registry.add("engine/submit_latency", [](BenchState& st) {
+        static const std::vector<FlowOrder> flow = make_engine_flow(kEngineOrders, 10);
+        Book book;
+        OMS oms;
+        Engine engine(book, oms);
+        oms.reserve(flow.size());
+        book.reserveLevels(flow.size()); // double prices: up to one level per order
+        engine.reserveLevels(flow.size());
+
+        std::uint64_t trades = 0;
+        auto sink = [&](const TradeType&) { ++trades; };
+        LatencyHistogram& lat = st.latencies();
+        st.measure(flow.size(), [&] {
+            for (const FlowOrder& f : flow) {
+                const std::uint64_t t0 = TscClock::start();
+                engine.submit(f.order, sink);
+                lat.record(static_cast<long long>(TscClock::toNs(TscClock::stop() - t0)));
+            }
+        });
+        benchKeep(trades);
+    });
+
+    // Routed by instrument id through BookManager (64 books)
+    registry.add("engine/books_submit", [](BenchState& st) {
+        constexpr std::uint32_t kInstruments = 64;
+        static const std::vector<FlowOrder> flow = make_engine_flow(kEngineOrders, kInstruments);
+        Books books;
+        for (std::uint32_t i = 0; i < kInstruments; ++i)
+            books.addInstrument("SYM" + std::to_string(i), flow.size() / kInstruments + 1);
+
+        std::uint64_t trades = 0;
+        auto sink = [&](const TradeType&) { ++trades; };
+        st.measure(flow.size(), [&] {
+            for (const FlowOrder& f : flow) books.submit(f.instrument, f.order, sink);
+        });
+        benchKeep(trades);
+    });
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!parseBenchArgs(argc, argv, opt)) return 2;
+
+    BenchRegistry registry;
+    registerEngineBenchmarks(registry);
+    registerCrtpBenchmarks(registry);
+    registerDispatchBenchmarks(registry);
+
+    try {
+        return runBenchSuite(registry, opt);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+}
@@ -1,18 +1,41 @@
 #include <algorithm>
+#include <cctype>
+#include <atomic>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
-#include <numeric>
+#include <map>
+#include <memory>
+#include <new>
 #include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "../include/MarketData.hpp"
+#include "../include/MarketDataConflator.hpp"
 #include "../include/Order.hpp"
 #include "../include/OrderBook.hpp"
 #include "../include/OrderManager.hpp"
+#include "../include/PooledOrderManager.hpp"
 #include "../include/MatchingEngine.hpp"
 #include "../include/Timer.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include "../include/LoadGenerator.hpp"
 #include "../include/TradeLogger.hpp"
+#include "../include/AsyncTradeLogger.hpp"
+#include "../include/TradeJournal.hpp"
+#include "../include/OrderJournal.hpp"
+#include "../include/EngineSnapshot.hpp"
+#include "../include/OrderGateway.hpp"
+#include "../include/TickFile.hpp"
+#include "../include/PerfCounters.hpp"
+#include "../include/TickPrice.hpp"
+#include "../include/RuntimeConfig.hpp"
 
 // Type aliases for convenience
 using Price   = double;
@@ -20,10 +43,42 @@ using OrderId = int;
 
 using OrderType = Order<Price, OrderId>;
 using Book      = OrderBook<Price, OrderId>;
-using OMS       = OrderManager<Price, OrderId>;
+using OMS       = PooledOrderManager<Price, OrderId>;
+using SharedOMS = OrderManager<Price, OrderId>; // legacy shared_ptr OMS (standalone)
 using Engine    = MatchingEngine<Price, OrderId>;
 using TradeType = Trade<Price, OrderId>;
 
+// --- Allocation counter --------------------------------------------------
+// Every global operator new in this binary bumps g_allocs, so a trial can
+// report exactly how many heap allocations its hot loop performed.
+static std::atomic<std::size_t> g_allocs{0};
+
+static void* counted_alloc(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+static void* counted_aligned_alloc(std::size_t n, std::align_val_t al) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    const auto a = static_cast<std::size_t>(al);
+    if (void* p = std::aligned_alloc(a, (n + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void* operator new(std::size_t n, std::align_val_t al) { return counted_aligned_alloc(n, al); }
+void* operator new[](std::size_t n, std::align_val_t al) { return counted_aligned_alloc(n, al); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
 struct Stats {
     long long minv{};
     long long maxv{};
@@ -32,31 +87,25 @@ struct Stats {
     long long p50{};
     long long p90{};
     long long p99{};
+    long long p999{};
     std::size_t samples{};
+    std::size_t allocs{};     // heap allocations inside the timed order loop
+    std::size_t orders{};     // orders submitted in the timed loop
+    PerfSample pmu{};         // hardware counters over the timed loop
 };
 
-static Stats compute_stats(std::vector<long long>& lat) {
+static Stats compute_stats(const LatencyHistogram& h) {
     Stats s{};
-    if (lat.empty()) return s;
-    std::sort(lat.begin(), lat.end());
-    s.samples = lat.size();
-    s.minv = lat.front();
-    s.maxv = lat.back();
-    s.mean = std::accumulate(lat.begin(), lat.end(), 0.0) / lat.size();
-    double var = 0.0;
-    for (auto v : lat) {
-        double d = (double)v - s.mean;
-        var += d * d;
-    }
-    s.stddev = std::sqrt(var / lat.size());
-    auto idx = [&](double q) {
-        std::size_t i = static_cast<std::size_t>(q * (lat.size() - 1));
-        if (i >= lat.size()) i = lat.size() - 1;
-        return lat[i];
-    };
-    s.p50 = idx(0.50);
-    s.p90 = idx(0.90);
-    s.p99 = idx(0.99);
+    if (h.empty()) return s;
+    s.samples = static_cast<std::size_t>(h.count());
+    s.minv = h.min();
+    s.maxv = h.max();
+    s.mean = h.mean();
+    s.stddev = h.stddev();
+    s.p50 = h.percentile(0.50);
+    s.p90 = h.percentile(0.90);
+    s.p99 = h.percentile(0.99);
+    s.p999 = h.percentile(0.999);
     return s;
 }
 
@@ -74,16 +123,33 @@ static void print_stats(const std::string& title, const Stats& s) {
               << "\nP50: "    << s.p50
               << "\nP90: "    << s.p90
               << "\nP99: "    << s.p99
-              << "\n\n";
+              << "\nP99.9: "  << s.p999
+              << "\nAllocs: " << s.allocs
+              << "\n";
+    PerfCounters::printPerOp(std::cout, s.pmu, static_cast<double>(s.orders), "order");
+    std::cout << "\n\n";
 }
 
+// How trades are logged inside the timed region
+enum class LogMode { Off, Sync, Async };
+
 struct TrialConfig {
     int num_ticks;
     bool pre_reserve;     // experiment: reserve() vs no reserve()
-    bool write_trades;    // optionally write CSV (disabled by default to reduce I/O noise)
+    LogMode log;          // Off: buffer only; Sync: TradeLogger; Async: AsyncTradeLogger
     std::string label;
 };
 
+// "Load=100K, log=sync" -> "Load_100K_log_sync"
+static std::string file_tag(const std::string& label) {
+    std::string out;
+    for (char c : label) {
+        if (std::isalnum(static_cast<unsigned char>(c))) out += c;
+        else if (c == '=' || c == ',') out += '_';
+    }
+    return out;
+}
+
 static Stats run_trial(const TrialConfig& cfg) {
     // Modules
     Book   book;
@@ -93,15 +159,19 @@ static Stats run_trial(const TrialConfig& cfg) {
     // Optional pre-reserve to reduce rehashing and vector growth
     if (cfg.pre_reserve) {
         std::size_t N = static_cast<std::size_t>(cfg.num_ticks);
-        book.reserve(N);
         oms.reserve(N);
+        book.reserveLevels(N); // prices off a random mid: up to one level per order
+        engine.reserveLevels(N);
     }
 
-    // Optional trade logger (batching). Keep off by default to avoid I/O impacting latency.
-    std::unique_ptr<TradeLogger<TradeType>> logger;
-    if (cfg.write_trades) {
-        logger = std::make_unique<TradeLogger<TradeType>>("trades_" + cfg.label + ".csv", 4096);
-    }
+    // Optional trade logger used directly as the submit sink, so its cost is timed
+    std::unique_ptr<TradeLogger<TradeType>> sync_logger;
+    std::unique_ptr<AsyncTradeLogger<TradeType>> async_logger;
+    const std::string log_path = "trades_" + file_tag(cfg.label) + ".csv";
+    if (cfg.log == LogMode::Sync)
+        sync_logger = std::make_unique<TradeLogger<TradeType>>(log_path, 4096);
+    else if (cfg.log == LogMode::Async)
+        async_logger = std::make_unique<AsyncTradeLogger<TradeType>>(log_path, 1 << 16, Backpressure::Block);
 
     // Generate ticks
     std::vector<MarketData> ticks;
@@ -114,10 +184,23 @@ static Stats run_trial(const TrialConfig& cfg) {
     std::uniform_int_distribution<int> qty_dist(10, 200);
     std::uniform_real_distribution<Price> skew(0.0, 0.10); // 0..10 cents (abs, sign set by side)
 
-    std::vector<long long> latencies;
-    latencies.reserve(cfg.num_ticks);
+    LatencyHistogram latencies;
+
+    // Reusable fill buffer (allocation-free submit path)
+    std::vector<TradeType> fills;
+    fills.reserve(64);
+    std::size_t n_logged = 0;
+    auto sink = [&](const TradeType& tr) {
+        ++n_logged;
+        if (sync_logger)       sync_logger->push(tr);
+        else if (async_logger) async_logger->push(tr);
+        else                   fills.push_back(tr);
+    };
 
     OrderId next_id = 1;
+    PerfCounters pmu;
+    const std::size_t allocs_before = g_allocs.load(std::memory_order_relaxed);
+    pmu.start();
 
     for (int i = 0; i < cfg.num_ticks; ++i) {
         const auto& md = ticks[i];
@@ -130,35 +213,1226 @@ static Stats run_trial(const TrialConfig& cfg) {
         Timer t; t.start();
 
         OrderType o{next_id++, px, qty, is_buy};
-        auto trades = engine.submit(o);
+        const std::size_t n_fills = engine.submit(o, sink);
 
-        if (!trades.empty()) {
+        if (n_fills > 0) {
             long long ns = t.stop();
-            latencies.push_back(ns);
-            if (logger) logger->append(trades);
+            latencies.record(ns);
+            fills.clear();
         }
     }
 
-    if (logger) logger->flush();
+    const PerfSample counters = pmu.stop();
+    const std::size_t allocs = g_allocs.load(std::memory_order_relaxed) - allocs_before;
+    if (sync_logger) sync_logger->flush();
+    if (async_logger) async_logger->flush();
 
     auto stats = compute_stats(latencies);
+    stats.allocs = allocs;
+    stats.orders = static_cast<std::size_t>(cfg.num_ticks);
+    stats.pmu = counters;
     print_stats(cfg.label, stats);
+    if (async_logger) {
+        const LoggerStats ls = async_logger->stats();
+        std::cout << "Logger: trades=" << n_logged << " pushed=" << ls.pushed
+                  << " written=" << ls.written << " dropped=" << ls.dropped
+                  << " stalls=" << ls.stalls << " high_water=" << ls.high_water
+                  << "/" << async_logger->ring_capacity() << "\n\n";
+    }
     return stats;
 }
 
+// Resting-depth sweep: `depth` bid levels below and `depth` ask levels above a
+// fixed mid, then alternating aggressive orders that each take out the top level.
+// The taken level is replenished outside the timed region, so depth stays constant
+// and any growth in latency comes from the engine's dependence on book depth.
+static Stats run_depth_trial(int depth, int num_orders) {
+    Book   book;
+    OMS    oms;
+    Engine engine(book, oms);
+
+    const std::size_t N = static_cast<std::size_t>(2 * depth + 2 * num_orders);
+    oms.reserve(N);
+    book.reserveLevels(static_cast<std::size_t>(depth) + 1);
+    engine.reserveLevels(static_cast<std::size_t>(depth) + 1);
+
+    constexpr int kMidTicks = 10'000'000;          // mid = 100000.00
+    auto px = [](int ticks) { return ticks * 0.01; }; // same expression everywhere -> exact keys
+    constexpr int kQty = 100;
+
+    std::size_t n_fills = 0;
+    auto count = [&](const TradeType&) { ++n_fills; };
+
+    OrderId next_id = 1;
+    for (int k = 1; k <= depth; ++k) {
+        engine.submit(OrderType{next_id++, px(kMidTicks - k), kQty, true}, count);
+        engine.submit(OrderType{next_id++, px(kMidTicks + k), kQty, false}, count);
+    }
+
+    LatencyHistogram latencies;
+
+    for (int i = 0; i < num_orders; ++i) {
+        const bool is_buy = (i & 1) == 0;
+        const int top = is_buy ? kMidTicks + 1 : kMidTicks - 1; // passive top level being hit
+
+        Timer t; t.start();
+        const std::size_t traded = engine.submit(OrderType{next_id++, px(top), kQty, is_buy}, count);
+        long long ns = t.stop();
+        if (traded > 0) latencies.record(ns);
+
+        // Restore the level we just consumed (untimed)
+        engine.submit(OrderType{next_id++, px(top), kQty, !is_buy}, count);
+    }
+
+    return compute_stats(latencies);
+}
+
+static void run_depth_sweep() {
+    constexpr int kOrders = 20'000;
+    std::cout << "=== Resting depth sweep (" << kOrders << " crossing orders per depth) ===\n";
+    std::cout << "Depth(levels/side)     P50      P90      P99     Mean\n";
+    for (int depth : {100, 1'000, 10'000, 100'000}) {
+        const Stats s = run_depth_trial(depth, kOrders);
+        std::printf("%18d %8lld %8lld %8lld %8.1f\n", depth, s.p50, s.p90, s.p99, s.mean);
+    }
+    std::cout << "\n";
+}
+
+// L2 depth output: the same crossing flow with no depth output, with level
+// deltas drained after every order, and with deltas plus a top-5 snapshot per
+// order. A mirror rebuilt purely from the deltas must match topN() at the end.
+template <typename PriceT>
+static void run_depth_publish_trial(const char* book_name, int num_orders, PriceT tick_size) {
+    using BookT   = OrderBook<PriceT, OrderId>;
+    using OmsT    = PooledOrderManager<PriceT, OrderId>;
+    using EngineT = MatchingEngine<PriceT, OrderId>;
+    using OrderT  = Order<PriceT, OrderId>;
+    using LevelT  = DepthLevel<PriceT>;
+    constexpr std::size_t kTop = 5;
+
+    // Orders within 20 ticks of a fixed mid (generated untimed)
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> off_dist(-20, 20);
+    std::uniform_int_distribution<int> qty_dist(10, 200);
+    std::vector<OrderT> flow;
+    flow.reserve(static_cast<std::size_t>(num_orders));
+    for (int i = 0; i < num_orders; ++i) {
+        const bool is_buy = (i & 1) == 0;
+        const int off = off_dist(rng);
+        flow.push_back(OrderT{i + 1, static_cast<PriceT>((10'000 + off) * tick_size), qty_dist(rng), is_buy});
+    }
+
+    enum class Output { None, Deltas, DeltasTopN };
+    auto run = [&](Output out, std::map<std::pair<bool, PriceT>, LevelT>* mirror) {
+        BookT book;
+        OmsT oms;
+        EngineT engine(book, oms);
+        oms.reserve(flow.size());
+        book.reserveLevels(41); // mid +- 20 ticks
+        engine.reserveLevels(41);
+        if (out != Output::None) book.enableDepthDeltas(1024);
+
+        LevelT bids[kTop], asks[kTop];
+        std::size_t published = 0, overflows = 0;
+        auto sink = [](const Trade<PriceT, OrderId>&) {};
+
+        Timer t; t.start();
+        for (const OrderT& o : flow) {
+            engine.submit(o, sink);
+            if (out == Output::None) continue;
+            const auto& deltas = book.depthDeltas();
+            published += deltas.size();
+            overflows += deltas.overflowed() ? 1 : 0;
+            if (mirror) {
+                for (const auto& d : deltas) {
+                    if (d.orderCount == 0) mirror->erase({d.is_buy, d.price});
+                    else (*mirror)[{d.is_buy, d.price}] = LevelT{d.price, d.totalQty, d.orderCount};
+                }
+            }
+            book.clearDepthDeltas();
+            if (out == Output::DeltasTopN) {
+                const DepthCounts c = book.topN(kTop, bids, asks);
+                published += c.bids + c.asks;
+            }
+        }
+        const double ns = static_cast<double>(t.stop()) / static_cast<double>(flow.size());
+
+        if (mirror) {
+            // Best kTop bids/asks of the mirror vs the book's own snapshot
+            book.topN(kTop, bids, asks);
+            std::size_t nb = 0, na = 0, mismatches = 0;
+            for (auto it = mirror->rbegin(); it != mirror->rend() && nb < kTop; ++it) {
+                if (!it->first.first) continue;
+                const LevelT& m = it->second;
+                if (m.price != bids[nb].price || m.totalQty != bids[nb].totalQty || m.orderCount != bids[nb].orderCount) ++mismatches;
+                ++nb;
+            }
+            for (auto it = mirror->begin(); it != mirror->end() && na < kTop; ++it) {
+                if (it->first.first) continue;
+                const LevelT& m = it->second;
+                if (m.price != asks[na].price || m.totalQty != asks[na].totalQty || m.orderCount != asks[na].orderCount) ++mismatches;
+                ++na;
+            }
+            std::printf("%-7s delta mirror vs topN(%zu): %zu mismatches, %zu overflows\n",
+                        book_name, kTop, mismatches, overflows);
+        }
+        return std::make_pair(ns, published);
+    };
+
+    const auto none   = run(Output::None, nullptr);
+    const auto deltas = run(Output::Deltas, nullptr);
+    const auto top    = run(Output::DeltasTopN, nullptr);
+    std::printf("%-7s %12.1f %12.1f %16.1f %14.2f\n", book_name, none.first, deltas.first, top.first,
+                static_cast<double>(deltas.second) / static_cast<double>(flow.size()));
+    std::map<std::pair<bool, PriceT>, LevelT> mirror;
+    run(Output::Deltas, &mirror);
+}
+
+static void run_depth_publish_bench() {
+    constexpr int kOrders = 200'000;
+    std::cout << "=== L2 depth output (" << kOrders << " orders, ns/order) ===\n";
+    std::printf("%-7s %12s %12s %16s %14s\n", "Book", "no output", "deltas", "deltas+top5", "deltas/order");
+    run_depth_publish_trial<double>("map", kOrders, 0.01);
+    run_depth_publish_trial<int>("ladder", kOrders, 1);
+    std::cout << "\n";
+}
+
+// Batched order entry: the run_trial flow through submit() one call per
+// order vs submitBatch() in batches of 1/16/256, then the resting orders
+// repriced and canceled per call vs in batches. Same trades at every size.
+static void run_batch_submit_bench() {
+    constexpr int N = 200'000;
+    using Replace = ReplaceRequest<Price, OrderId>;
+
+    std::vector<MarketData> ticks;
+    MarketDataFeed feed(ticks);
+    feed.generateData(N);
+    std::mt19937 rng(2025);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> qty_dist(10, 200);
+    std::uniform_real_distribution<Price> skew(0.0, 0.10);
+    std::vector<OrderType> flow;
+    flow.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        const Price mid = (ticks[i].bid_price + ticks[i].ask_price) * 0.5;
+        const bool is_buy = side_dist(rng) == 1;
+        const int qty = qty_dist(rng);
+        flow.push_back(OrderType{i + 1, is_buy ? mid + skew(rng) : mid - skew(rng), qty, is_buy});
+    }
+    std::vector<OrderId> ids(N);
+    std::vector<Replace> reprices(N);
+    for (int i = 0; i < N; ++i) {
+        ids[i] = i + 1;
+        reprices[i] = Replace{i + 1, flow[i].price + (flow[i].is_buy ? -0.25 : 0.25)}; // away from the touch
+    }
+
+    auto mops = [](std::size_t n, long long ns) { return static_cast<double>(n) * 1e3 / static_cast<double>(ns); };
+
+    std::cout << "=== Batched order entry (" << N << " orders, M ops/s) ===\n";
+    std::printf("%-10s %12s %12s %12s %10s\n", "Batch", "submit", "replace", "cancel", "trades");
+    for (std::size_t batch : {std::size_t{0}, std::size_t{1}, std::size_t{16}, std::size_t{256}}) {
+        Book   book;
+        OMS    oms;
+        Engine engine(book, oms);
+        oms.reserve(N);
+        book.reserveLevels(N); // prices off a random mid: up to one level per order
+        engine.reserveLevels(N);
+
+        std::size_t trades = 0;
+        auto sink = [&](const TradeType&) { ++trades; };
+        Timer t;
+
+        // batch 0: the per-order calls, for reference
+        t.start();
+        if (batch == 0) for (const OrderType& o : flow) engine.submit(o, sink);
+        else            for (std::size_t i = 0; i < flow.size(); i += batch)
+                            engine.submitBatch(flow.data() + i, std::min(batch, flow.size() - i), sink);
+        const long long submit_ns = t.stop();
+
+        t.start();
+        if (batch == 0) for (const Replace& r : reprices) engine.replacePrice(r.id, r.new_price, sink);
+        else            for (std::size_t i = 0; i < reprices.size(); i += batch)
+                            engine.replaceBatch(reprices.data() + i, std::min(batch, reprices.size() - i), sink);
+        const long long replace_ns = t.stop();
+
+        t.start();
+        if (batch == 0) for (OrderId id : ids) engine.cancel(id);
+        else            for (std::size_t i = 0; i < ids.size(); i += batch)
+                            engine.cancelBatch(ids.data() + i, std::min(batch, ids.size() - i));
+        const long long cancel_ns = t.stop();
+
+        const std::string label = batch == 0 ? "per-call" : std::to_string(batch);
+        std::printf("%-10s %12.2f %12.2f %12.2f %10zu\n", label.c_str(), mops(flow.size(), submit_ns),
+                    mops(reprices.size(), replace_ns), mops(ids.size(), cancel_ns), trades);
+    }
+    std::cout << "\n";
+}
+
+// --- Order-flow sequencer ---------------------------------------------------
+// Open-loop message schedule against a pre-populated book: message i arrives
+// at a fixed time (sustained: one per interval; burst: `burst` messages at
+// once, then an idle gap with the same mean rate) and is sent when it is due
+// or as soon as the previous one returns. Each message type has its own
+// histograms: service = the engine call alone, response = completion minus
+// scheduled arrival (includes queueing behind a burst, so no coordinated
+// omission). Message choice and fill bookkeeping happen outside the timing.
+// Depth is held at 3/4 or more of its start by untimed refill orders between
+// messages; they aren't messages, so the timed stream runs the requested mix.
+enum class MsgType : std::uint8_t { New, Aggressive, Cancel, Replace };
+constexpr std::size_t kMsgTypes = 4;
+constexpr const char* kMsgNames[kMsgTypes] = {"new", "aggressive", "cancel", "replace"};
+
+struct SequencerConfig {
+    OrderFlowProfile mix;        // cancel/replace/aggressive percentages and offsets
+    std::size_t  depth;          // resting orders before the first message
+    std::size_t  messages;
+    std::int64_t interval_ns;    // mean gap between arrivals
+    std::size_t  burst;          // 1: sustained; N: N arrivals per N * interval_ns
+};
+
+static void run_sequencer_trial(const SequencerConfig& cfg) {
+    constexpr std::int64_t kMidTicks = 15'000;
+    const TickScale<Price> scale(0.01);
+    const std::size_t max_ids = cfg.depth + 2 * cfg.messages + 1; // messages + refills
+
+    Book   book;
+    OMS    oms;
+    Engine engine(book, oms);
+    oms.reserve(max_ids);
+    book.reserveLevels(2 * static_cast<std::size_t>(cfg.mix.max_offset_ticks) + 8);
+    engine.reserveLevels(2 * static_cast<std::size_t>(cfg.mix.max_offset_ticks) + 8);
+
+    // Live resting orders (id, side) with O(1) removal by id
+    struct Live { OrderId id; bool is_buy; };
+    std::vector<Live> live;
+    std::vector<std::uint32_t> pos(max_ids, IdIndex<OrderId>::npos);
+    live.reserve(max_ids);
+    auto track = [&](OrderId id, bool is_buy) {
+        const Engine::RecordT* r = oms.record(id);
+        if (!r || !r->in_book || pos[id] != IdIndex<OrderId>::npos) return;
+        pos[id] = static_cast<std::uint32_t>(live.size());
+        live.push_back(Live{id, is_buy});
+    };
+    auto untrack = [&](OrderId id) {
+        const std::uint32_t j = pos[id];
+        if (j == IdIndex<OrderId>::npos) return;
+        live[j] = live.back();
+        pos[live[j].id] = j;
+        live.pop_back();
+        pos[id] = IdIndex<OrderId>::npos;
+    };
+
+    XorShift32 rng(0x5E0F10u);
+    auto passive = [&](bool buy) {
+        const std::int64_t off = rng.between(1, cfg.mix.max_offset_ticks);
+        return scale.fromTicks(buy ? kMidTicks - off : kMidTicks + off);
+    };
+    std::vector<TradeType> fills;
+    fills.reserve(256);
+    auto sink = [&](const TradeType& t) { fills.push_back(t); };
+
+    // Drop filled orders from the live set after any engine call (untimed)
+    auto settle = [&] {
+        for (const TradeType& t : fills) {
+            for (OrderId side_id : {t.buy_id, t.sell_id}) {
+                const Engine::RecordT* r = oms.record(side_id);
+                if (!r || !r->in_book) untrack(side_id);
+            }
+        }
+        fills.clear();
+    };
+
+    OrderId next_id = 1;
+    std::size_t refills = 0;
+    auto rest_passive = [&](bool buy) {
+        const OrderId id = next_id++;
+        engine.submit(OrderType{id, passive(buy), rng.between(cfg.mix.min_qty, cfg.mix.max_qty), buy}, sink);
+        settle();
+        track(id, buy);
+    };
+    for (std::size_t i = 0; i < cfg.depth; ++i) rest_passive((i & 1) != 0);
+
+    LatencyHistogram service[kMsgTypes], response[kMsgTypes];
+    const double ticks_per_ns = 1.0 / TscClock::nsPerTick();
+    const std::uint64_t start = TscClock::start() + static_cast<std::uint64_t>(1'000'000 * ticks_per_ns);
+    const std::size_t burst = cfg.burst ? cfg.burst : 1;
+    const std::size_t floor = cfg.depth * 3 / 4; // refill (untimed) below this depth
+    std::size_t behind = 0;
+
+    for (std::size_t i = 0; i < cfg.messages; ++i) {
+        // Choose the message (untimed)
+        const std::uint32_t roll = rng.next_u32() % 100;
+        MsgType type = MsgType::New;
+        Live target{};
+        if (!live.empty() && roll < cfg.mix.cancel_pct + cfg.mix.replace_pct) {
+            target = live[rng.next_u32() % live.size()];
+            type = roll < cfg.mix.cancel_pct ? MsgType::Cancel : MsgType::Replace;
+        } else if (rng.next_u32() % 100 < cfg.mix.aggressive_pct) {
+            type = MsgType::Aggressive;
+        }
+        const bool buy = type == MsgType::New || type == MsgType::Aggressive ? (rng.next_u32() & 1) != 0
+                                                                           : target.is_buy;
+        const std::int64_t through = rng.between(1, cfg.mix.max_offset_ticks);
+        const Price px = type == MsgType::Aggressive
+                             ? scale.fromTicks(buy ? kMidTicks + through : kMidTicks - through)
+                             : passive(buy);
+        const int qty = rng.between(cfg.mix.min_qty, cfg.mix.max_qty);
+        const OrderId id = type == MsgType::Cancel || type == MsgType::Replace ? target.id : next_id++;
+
+        // Wait for the scheduled arrival (never, when behind)
+        const std::uint64_t arrival = start + static_cast<std::uint64_t>(
+            static_cast<double>((i / burst) * burst * cfg.interval_ns) * ticks_per_ns);
+        std::uint64_t t0 = TscClock::start();
+        if (t0 < arrival) {
+            while ((t0 = TscClock::start()) < arrival) cpu_relax();
+        } else if (burst == 1 && t0 > arrival + static_cast<std::uint64_t>(cfg.interval_ns * ticks_per_ns)) {
+            ++behind;
+        }
+
+        switch (type) {
+        case MsgType::New:
+        case MsgType::Aggressive: engine.submit(OrderType{id, px, qty, buy}, sink); break;
+        case MsgType::Cancel:     engine.cancel(id); break;
+        case MsgType::Replace:    engine.replacePrice(id, px, sink); break;
+        }
+        const std::uint64_t t1 = TscClock::stop();
+        const auto k = static_cast<std::size_t>(type);
+        service[k].record(static_cast<long long>(TscClock::toNs(t1 - t0)));
+        response[k].record(static_cast<long long>(TscClock::toNs(t1 - arrival)));
+
+        // Book-keeping (untimed): drop filled/canceled orders, track new
+        // resters, top the book back up to the floor
+        if (type == MsgType::Cancel) untrack(id);
+        settle();
+        if (type == MsgType::New || type == MsgType::Aggressive) track(id, buy);
+        for (; live.size() < floor; ++refills) rest_passive((refills & 1) != 0);
+    }
+
+    // Requested share per type, from the profile's percentages
+    const double others = 100.0 - cfg.mix.cancel_pct - cfg.mix.replace_pct;
+    const double asked[kMsgTypes] = {others * (100 - cfg.mix.aggressive_pct) / 100.0,
+                                     others * cfg.mix.aggressive_pct / 100.0,
+                                     static_cast<double>(cfg.mix.cancel_pct),
+                                     static_cast<double>(cfg.mix.replace_pct)};
+
+    std::printf("%-12s %-9s", cfg.mix.name, burst == 1 ? "sustained" : "burst");
+    std::printf("  (%zu msgs, 1 per %lld ns%s, depth %zu -> %zu)\n", cfg.messages,
+                static_cast<long long>(cfg.interval_ns),
+                burst == 1 ? "" : (", bursts of " + std::to_string(burst)).c_str(), cfg.depth, live.size());
+    std::printf("  type        share  (asked)   service p50/p99/p99.9/max ns      response p50/p99/p99.9/max ns\n");
+    for (std::size_t k = 0; k < kMsgTypes; ++k) {
+        if (service[k].empty()) continue;
+        const Stats sv = compute_stats(service[k]), rs = compute_stats(response[k]);
+        std::printf("  %-10s %5.1f%%  (%5.1f%%)   %6lld %6lld %7lld %8lld      %7lld %7lld %7lld %8lld\n",
+                    kMsgNames[k], 100.0 * sv.samples / cfg.messages, asked[k], sv.p50, sv.p99, sv.p999,
+                    static_cast<long long>(sv.maxv), rs.p50, rs.p99, rs.p999, static_cast<long long>(rs.maxv));
+    }
+    if (refills) std::printf("  untimed refill orders (not in the mix): %zu\n", refills);
+    if (burst == 1 && behind) std::printf("  behind schedule by > 1 interval: %zu msgs\n", behind);
+    std::cout << "\n";
+}
+
+// Flow mixes against a 100K-order book, sustained (1 msg/us) and in bursts
+// of 1000 at the same mean rate. cancel-90: 90% cancels, 5% replaces, our
+// production mix; the untimed refills keep the book from draining, so the
+// realised share matches the requested one.
+static void run_order_flow_sequencer() {
+    constexpr std::size_t kDepth = 100'000;
+    constexpr std::size_t kMsgs = 500'000;
+    OrderFlowProfile cancel90 = orderFlowProfile(OrderFlow::CancelHeavy);
+    cancel90.name = "cancel-90";
+    cancel90.cancel_pct = 90;
+    cancel90.replace_pct = 5;
+
+    std::cout << "=== Order-flow sequencer (depth " << kDepth << ") ===\n";
+    for (const OrderFlowProfile& mix : {orderFlowProfile(OrderFlow::Balanced), cancel90,
+                                        orderFlowProfile(OrderFlow::Aggressive),
+                                        orderFlowProfile(OrderFlow::DeepBook)}) {
+        run_sequencer_trial({mix, kDepth, kMsgs, 1'000, 1});
+        run_sequencer_trial({mix, kDepth, kMsgs, 1'000, 1'000});
+    }
+}
+
+// Price representation: the run_trial flow (mid +- 0..10 ticks) priced on a
+// 0.01 tick grid at the feed boundary, through double on the map book, int64
+// ticks on the map book (integer keys alone) and int32/int64 ticks on the
+// ladder. Every variant sees the same tick counts, so trades must match.
+template <typename PriceT, typename BookT = OrderBook<PriceT, OrderId>>
+static void run_price_type_trial(const char* label, const std::vector<MarketData>& ticks,
+                                 std::size_t& trades_out) {
+    using OrderT  = Order<PriceT, OrderId>;
+    using EngineT = MatchingEngine<PriceT, OrderId, BookT>;
+    using TradeT  = Trade<PriceT, OrderId>;
+
+    const TickScale<PriceT> scale(0.01);
+    std::mt19937 rng(2025);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> qty_dist(10, 200);
+    std::uniform_int_distribution<int> skew_ticks(0, 10);
+    std::vector<OrderT> flow;
+    flow.reserve(ticks.size());
+    OrderId next_id = 1;
+    for (const MarketData& md : ticks) {
+        const std::int64_t mid = scale.toTicks((md.bid_price + md.ask_price) * 0.5);
+        const bool is_buy = side_dist(rng) == 1;
+        const int qty = qty_dist(rng);
+        const int skew = skew_ticks(rng);
+        flow.push_back(OrderT{next_id++, scale.fromTicks(is_buy ? mid + skew : mid - skew), qty, is_buy});
+    }
+
+    BookT book;
+    PooledOrderManager<PriceT, OrderId> oms;
+    EngineT engine(book, oms);
+    oms.reserve(flow.size());
+    book.reserveLevels(flow.size()); // feed mids span 10K ticks: bound by the order count
+    engine.reserveLevels(flow.size());
+
+    std::size_t trades = 0;
+    auto sink = [&](const TradeT&) { ++trades; };
+    LatencyHistogram latencies;
+    Timer total;
+    total.start();
+    for (const OrderT& o : flow) {
+        Timer t; t.start();
+        if (engine.submit(o, sink) > 0) latencies.record(t.stop());
+    }
+    const long long ns = total.stop();
+
+    const Stats s = compute_stats(latencies);
+    std::printf("%-16s %10.1f %8lld %8lld %10zu %8zu  %s / %s\n", label,
+                static_cast<double>(ns) / static_cast<double>(flow.size()), s.p50, s.p99, trades,
+                engine.levelCount(),
+                engine.hasBid() ? std::to_string(scale.toDouble(engine.bestBid())).c_str() : "-",
+                engine.hasAsk() ? std::to_string(scale.toDouble(engine.bestAsk())).c_str() : "-");
+    trades_out = trades;
+}
+
+static void run_price_type_bench() {
+    constexpr int N = 1'000'000;
+    std::vector<MarketData> ticks;
+    MarketDataFeed feed(ticks);
+    feed.generateData(N);
+
+    std::cout << "=== Price type (" << N << " orders, 0.01 tick) ===\n";
+    std::printf("%-16s %10s %8s %8s %10s %8s  %s\n", "PriceType/book", "ns/order", "P50", "P99", "trades",
+                "levels", "bid / ask");
+    std::size_t t_double = 0, t_map64 = 0, t_lad32 = 0, t_lad64 = 0;
+    run_price_type_trial<double>("double/map", ticks, t_double);
+    run_price_type_trial<Ticks64, MapOrderBook<Ticks64, OrderId>>("int64/map", ticks, t_map64);
+    run_price_type_trial<Ticks32>("int32/ladder", ticks, t_lad32);
+    run_price_type_trial<Ticks64>("int64/ladder", ticks, t_lad64);
+    std::cout << "Same trades for every price type: "
+              << (t_double == t_map64 && t_map64 == t_lad32 && t_lad32 == t_lad64 ? "yes" : "NO") << "\n\n";
+}
+
+// Warm restart: rest ~1M orders (every command logged to the order journal),
+// snapshot, run a mixed tail, then rebuild a fresh engine (a) from the
+// snapshot plus the journal tail and (b) by replaying the whole journal.
+// Both must end in the live engine's state.
+static void run_snapshot_restart_bench() {
+    constexpr int kResting = 1'000'000;
+    constexpr int kTail    = 100'000;
+    const std::string journal_path  = "restart_orders.bin";
+    const std::string snapshot_path = "restart_engine.snap";
+    using Journal = OrderJournal<Price, OrderId>;
+    using Level   = DepthLevel<Price>;
+
+    Book   book;
+    OMS    oms;
+    Engine engine(book, oms);
+    oms.reserve(kResting + kTail);
+    book.reserveLevels(2'000); // 1..2000 cents from 100.00
+    engine.reserveLevels(2'000);
+
+    std::size_t trades = 0;
+    auto sink = [&](const TradeType&) { ++trades; };
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> tick_dist(1, 2'000);  // cents away from 100.00
+    std::uniform_int_distribution<int> qty_dist(10, 200);
+    std::uniform_int_distribution<int> kind_dist(0, 9);
+    double snapshot_ms = 0.0;
+    std::uint64_t snapshot_offset = 0;
+    {
+        Journal journal(journal_path, kResting + kTail);
+        OrderId next_id = 1;
+        auto new_order = [&](bool may_cross) {
+            const bool is_buy = (next_id & 1) != 0;
+            const int ticks = may_cross ? tick_dist(rng) - 20 : tick_dist(rng);
+            const OrderType o{next_id++, 100.0 + (is_buy ? -ticks : ticks) * 0.01, qty_dist(rng), is_buy};
+            journal.logNew(o);
+            engine.submit(o, sink);
+        };
+        for (int i = 0; i < kResting; ++i) new_order(false);
+
+        Timer t;
+        t.start();
+        writeEngineSnapshot(snapshot_path, engine, oms, journal.offset());
+        snapshot_ms = static_cast<double>(t.stop()) / 1e6;
+        snapshot_offset = journal.offset();
+
+        // Tail: 40% new (some crossing), 30% cancel, 30% replace of random ids
+        for (int i = 0; i < kTail; ++i) {
+            const int k = kind_dist(rng);
+            const OrderId id = std::uniform_int_distribution<OrderId>(1, next_id - 1)(rng);
+            if (k < 4) {
+                new_order(true);
+            } else if (k < 7) {
+                journal.logCancel(id);
+                engine.cancel(id);
+            } else {
+                const OrderType* o = oms.get(id);
+                if (!o) { journal.logCancel(id); engine.cancel(id); continue; } // keep the mix's count
+                const Price px = 100.0 + (o->is_buy ? -1 : 1) * tick_dist(rng) * 0.01;
+                journal.logReplace(id, px);
+                engine.replacePrice(id, px, sink);
+            }
+        }
+    } // journal closed: header count final, file trimmed
+
+    auto same_state = [&](const Book& b, const OMS& m, const Engine& e) {
+        constexpr std::size_t kTop = 10;
+        Level lb[kTop], la[kTop], rb[kTop], ra[kTop];
+        const DepthCounts lc = book.topN(kTop, lb, la);
+        const DepthCounts rc = b.topN(kTop, rb, ra);
+        bool ok = e.bestBid() == engine.bestBid() && e.bestAsk() == engine.bestAsk()
+               && e.levelCount() == engine.levelCount() && m.size() == oms.size()
+               && lc.bids == rc.bids && lc.asks == rc.asks;
+        for (std::size_t i = 0; ok && i < lc.bids; ++i)
+            ok = lb[i].price == rb[i].price && lb[i].totalQty == rb[i].totalQty && lb[i].orderCount == rb[i].orderCount;
+        for (std::size_t i = 0; ok && i < lc.asks; ++i)
+            ok = la[i].price == ra[i].price && la[i].totalQty == ra[i].totalQty && la[i].orderCount == ra[i].orderCount;
+        return ok;
+    };
+    auto drop = [](const TradeType&) {};
+
+    // (a) snapshot + journal tail
+    Book   warm_book;
+    OMS    warm_oms;
+    Engine warm(warm_book, warm_oms);
+    warm_book.reserveLevels(2'000);
+    warm.reserveLevels(2'000);
+    const WarmRestartStats ws = warmRestart(snapshot_path, journal_path, warm_book, warm_oms, warm, drop);
+
+    // (b) full journal replay from an empty engine
+    Book   cold_book;
+    OMS    cold_oms;
+    Engine cold(cold_book, cold_oms);
+    cold_oms.reserve(kResting + kTail);
+    cold_book.reserveLevels(2'000);
+    cold.reserveLevels(2'000);
+    Timer t;
+    t.start();
+    std::size_t replayed = 0;
+    {
+        using Kind = GatewayCommand<Price, OrderId>::Kind;
+        const OrderJournalReader<Price> journal(journal_path);
+        for (const auto& r : journal) {
+            switch (static_cast<Kind>(r.kind)) {
+            case Kind::New:     cold.submit(OrderType{static_cast<OrderId>(r.id), r.price, r.quantity, r.is_buy != 0}, drop); break;
+            case Kind::Cancel:  cold.cancel(static_cast<OrderId>(r.id)); break;
+            case Kind::Replace: cold.replacePrice(static_cast<OrderId>(r.id), r.price, drop); break;
+            }
+            ++replayed;
+        }
+    }
+    const double cold_ms = static_cast<double>(t.stop()) / 1e6;
+
+    std::cout << "=== Snapshot + warm restart (" << kResting << " resting, " << kTail << " tail commands) ===\n";
+    std::printf("Snapshot write:          %9.1f ms (%zu levels, %zu orders, offset %llu)\n", snapshot_ms,
+                ws.levels, ws.orders, static_cast<unsigned long long>(snapshot_offset));
+    std::printf("Warm: restore + tail     %9.1f ms  (%.1f + %.1f, %zu replayed)\n", ws.restore_ms + ws.replay_ms,
+                ws.restore_ms, ws.replay_ms, ws.replayed);
+    std::printf("Cold: full replay        %9.1f ms  (%zu replayed)\n", cold_ms, replayed);
+    std::cout << "Warm state matches live: " << (same_state(warm_book, warm_oms, warm) ? "yes" : "NO")
+              << ", cold state matches live: " << (same_state(cold_book, cold_oms, cold) ? "yes" : "NO") << "\n\n";
+
+    std::remove(journal_path.c_str());
+    std::remove(snapshot_path.c_str());
+}
+
+// Conflation under a sustained burst: 64 instruments, a tick every 100 ns of
+// feed time, into a consumer that needs 1 us per tick (10x too slow). Feed
+// time is simulated (publish everything stamped <= now, then poll with
+// now), so the run is deterministic; age = feed time at the end of the
+// consumer's work on a tick minus its exchange timestamp. Stage ns/tick is
+// the real cost of publish + poll per published tick.
+static void run_conflation_bench() {
+    constexpr int N = 1'000'000;
+    constexpr std::uint32_t kInstruments = 64;
+    constexpr std::int64_t kConsumerNs = 1'000;
+
+    std::vector<MarketData> ticks;
+    MarketDataFeed feed(ticks, kInstruments);
+    feed.generateData(N);
+
+    struct ModeCase { const char* label; ConflationConfig cfg; };
+    const ModeCase cases[] = {
+        {"every-tick",  {ConflationMode::EveryTick, 0, static_cast<std::size_t>(N)}},
+        {"latest-only", {ConflationMode::LatestOnly, 0, 0}},
+        {"window=10us", {ConflationMode::Window, 10'000, 0}},
+        {"window=100us", {ConflationMode::Window, 100'000, 0}},
+    };
+
+    std::cout << "=== Market-data conflation (" << N << " ticks, " << kInstruments
+              << " instruments, feed 100 ns/tick, consumer 1 us/tick) ===\n";
+    std::printf("%-13s %10s %10s %11s %9s %10s %10s %10s %9s\n", "Mode", "delivered", "conflated", "max_pending",
+                "max_batch", "age_p50us", "age_p99us", "age_maxus", "ns/tick");
+    for (const ModeCase& mc : cases) {
+        MarketDataConflator<> stage(kInstruments, mc.cfg);
+        LatencyHistogram age;
+        std::size_t max_pending = 0;
+        std::int64_t now = ticks.front().exchange_ts_ns;
+        std::size_t next = 0;
+        auto consume = [&](const MarketData& md) {
+            now += kConsumerNs;
+            age.record(now - md.exchange_ts_ns);
+        };
+
+        Timer wall;
+        wall.start();
+        while (next < ticks.size() || stage.pending() > 0) {
+            while (next < ticks.size() && ticks[next].exchange_ts_ns <= now) stage.publish(ticks[next++]);
+            max_pending = std::max(max_pending, stage.pending());
+            if (stage.poll(consume, now) == 0)
+                now = next < ticks.size() ? ticks[next].exchange_ts_ns : now + kConsumerNs; // idle or window wait
+        }
+        const long long wall_ns = wall.stop();
+
+        const ConflationStats s = stage.stats();
+        std::printf("%-13s %10llu %10llu %11zu %9llu %10.1f %10.1f %10.1f %9.1f\n", mc.label,
+                    static_cast<unsigned long long>(s.delivered), static_cast<unsigned long long>(s.conflated),
+                    max_pending, static_cast<unsigned long long>(s.max_batch), age.percentile(0.50) / 1e3,
+                    age.percentile(0.99) / 1e3, age.max() / 1e3, static_cast<double>(wall_ns) / N);
+    }
+    std::cout << "\n";
+}
+
+// Arena page size: 2M resting orders (128MB of records, a 32MB id index),
+// then random-id lookups and cancels, i.e. one dependent miss per probe
+// spread over the whole arena. Default 4K pages vs 2MB pages (hugetlb if
+// reserved, else THP via madvise); dTLB misses come from the PMU when exposed.
+static void run_arena_pages_bench() {
+    constexpr int kOrders = 2'000'000;
+    constexpr int kProbes = 1'000'000;
+
+    std::mt19937 rng(4242);
+    std::uniform_int_distribution<OrderId> id_dist(1, kOrders);
+    std::vector<OrderId> probe_ids(kProbes);
+    for (OrderId& id : probe_ids) id = id_dist(rng);
+    std::vector<OrderId> cancel_ids(kOrders);
+    for (int i = 0; i < kOrders; ++i) cancel_ids[i] = i + 1;
+    std::shuffle(cancel_ids.begin(), cancel_ids.end(), rng);
+    cancel_ids.resize(kProbes);
+
+    std::cout << "=== Arena pages (" << kOrders << " resting orders, " << kProbes << " random probes) ===\n";
+    std::printf("%-8s %9s %9s %10s %9s %12s %12s %11s\n", "Pages", "get ns", "get p99", "cancel ns", "cancel p99",
+                "get dTLB/op", "thp MB", "hugetlb MB");
+    for (bool huge : {false, true}) {
+        arenaMemoryPolicy().huge_pages = huge;
+        const long anon_before = meminfoValue("AnonHugePages:");
+        {
+            Book   book;
+            OMS    oms;
+            Engine engine(book, oms);
+            oms.reserve(kOrders);
+            book.reserveLevels(2'000); // 1..2000 ticks from 100.00
+            engine.reserveLevels(2'000);
+            auto none = [](const TradeType&) {};
+            for (OrderId id = 1; id <= kOrders; ++id) {
+                const bool is_buy = (id & 1) != 0;
+                const int tick = 1 + id % 2'000;
+                engine.submit(OrderType{id, 100.0 + (is_buy ? -tick : tick) * 0.01, 100, is_buy}, none);
+            }
+            const long thp_mb = (meminfoValue("AnonHugePages:") - anon_before) / 1024;
+            const std::size_t hugetlb_mb = arenaMemoryStats().hugetlb_bytes.load() >> 20;
+
+            LatencyHistogram get_lat, cancel_lat;
+            PerfCounters pmu;
+            long long qty = 0;
+            Timer t;
+            t.start();
+            pmu.start();
+            for (OrderId id : probe_ids) {
+                const std::uint64_t t0 = TscClock::start();
+                const OrderType* o = oms.get(id);
+                qty += o ? o->quantity : 0;
+                get_lat.record(static_cast<long long>(TscClock::toNs(TscClock::stop() - t0)));
+            }
+            const PerfSample get_pmu = pmu.stop();
+            const long long get_ns = t.stop();
+
+            t.start();
+            for (OrderId id : cancel_ids) {
+                const std::uint64_t t0 = TscClock::start();
+                engine.cancel(id);
+                cancel_lat.record(static_cast<long long>(TscClock::toNs(TscClock::stop() - t0)));
+            }
+            const long long cancel_ns = t.stop();
+
+            const double dtlb = get_pmu.perOp(PerfEvent::DtlbMisses, kProbes);
+            char dtlb_txt[32];
+            if (dtlb < 0) std::snprintf(dtlb_txt, sizeof(dtlb_txt), "n/a");
+            else          std::snprintf(dtlb_txt, sizeof(dtlb_txt), "%.3f", dtlb);
+            std::printf("%-8s %9.1f %9lld %10.1f %9lld %12s %12ld %11zu\n", huge ? "2MB" : "4K",
+                        static_cast<double>(get_ns) / kProbes, get_lat.percentile(0.99),
+                        static_cast<double>(cancel_ns) / kProbes, cancel_lat.percentile(0.99), dtlb_txt,
+                        thp_mb, hugetlb_mb);
+            if (qty < 0) std::cout << qty; // keep the lookups
+        }
+    }
+    arenaMemoryPolicy().huge_pages = false;
+    std::cout << "\n";
+}
+
+// The pre-interning tick layout: one std::string per tick, built per tick
+struct alignas(kAlign) StringMarketData {
+    std::string symbol;
+    double bid_price;
+    double ask_price;
+    std::chrono::high_resolution_clock::time_point timestamp;
+};
+
+static void generate_string_ticks(std::vector<StringMarketData>& data, int num_ticks) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> price_dist(100.0, 200.0);
+    data.reserve(num_ticks);
+    for (int i = 0; i < num_ticks; ++i) {
+        StringMarketData md;
+        md.symbol = "SYM" + std::to_string(i % 10);
+        md.bid_price = price_dist(gen);
+        md.ask_price = price_dist(gen) + 0.05;
+        md.timestamp = std::chrono::high_resolution_clock::now();
+        data.push_back(md);
+    }
+}
+
+// Feed generation throughput: string symbol per tick vs interned POD ticks,
+// plus the cost of copying the generated feed (e.g. into a replay buffer)
+static void run_feed_generation_bench() {
+    constexpr int N = 1'000'000;
+    auto mticks = [](long long ns) { return N * 1e3 / static_cast<double>(ns); };
+    auto time_ns = [](auto&& body) {
+        Timer t; t.start();
+        body();
+        return t.stop();
+    };
+
+    std::vector<StringMarketData> string_ticks, string_copy;
+    std::vector<MarketData> pod_ticks, pod_copy;
+    MarketDataFeed feed(pod_ticks);
+
+    const long long string_gen = time_ns([&] { generate_string_ticks(string_ticks, N); });
+    const long long pod_gen    = time_ns([&] { feed.generateData(N); });
+    string_copy.resize(N); // destinations pre-faulted: time the element copies only
+    pod_copy.resize(N);
+    const long long string_cp  = time_ns([&] { std::copy(string_ticks.begin(), string_ticks.end(), string_copy.begin()); });
+    const long long pod_cp     = time_ns([&] { std::copy(pod_ticks.begin(), pod_ticks.end(), pod_copy.begin()); }); // memmove
+
+    std::cout << "=== Feed generation (" << N << " ticks) ===\n";
+    std::printf("Layout              generate Mticks/s   copy Mticks/s\n");
+    std::printf("std::string symbol  %17.2f %15.2f\n", mticks(string_gen), mticks(string_cp));
+    std::printf("interned POD        %17.2f %15.2f\n\n", mticks(pod_gen), mticks(pod_cp));
+}
+
+// Order-sensitive digest of generated ticks (fields only: padding is not data)
+static std::uint64_t tick_digest(const MarketData* t, std::size_t n, std::uint64_t h = 1469598103934665603ull) {
+    auto mix = [&h](std::uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t bid, ask;
+        std::memcpy(&bid, &t[i].bid_price, sizeof bid);
+        std::memcpy(&ask, &t[i].ask_price, sizeof ask);
+        mix(t[i].symbol_id);
+        mix(bid);
+        mix(ask);
+        mix(static_cast<std::uint64_t>(t[i].bid_size) << 32 | static_cast<std::uint32_t>(t[i].ask_size));
+        mix(static_cast<std::uint64_t>(t[i].exchange_ts_ns));
+    }
+    return h;
+}
+
+// Parallel load generation: 10M ticks from MarketDataFeed (mt19937, one
+// thread) vs LoadGenerator at 1/2/4/8 workers into a pre-faulted vector, then
+// a 100M-tick scenario streamed through per-worker blocks (never resident),
+// then 10M commands per order-flow profile. Every worker count must produce
+// the same digest; the profiles report the mix they actually generated.
+static void run_load_generator_bench() {
+    constexpr std::size_t N = 10'000'000;
+    constexpr std::size_t kStream = 100'000'000;
+    constexpr std::size_t kCmds = 10'000'000;
+    constexpr std::int64_t kStart = 1'700'000'000'000'000'000;
+    auto time_ns = [](auto&& body) {
+        Timer t; t.start();
+        body();
+        return t.stop();
+    };
+    auto config = [&](unsigned threads) {
+        LoadGenConfig cfg;
+        cfg.threads = threads;
+        cfg.start_ns = kStart;
+        return cfg;
+    };
+
+    std::cout << "=== Load generator (" << N << " ticks, " << std::thread::hardware_concurrency()
+              << " hw threads) ===\n";
+    std::printf("Generator              ms   Mticks/s  same digest\n");
+    {
+        std::vector<MarketData> ticks;
+        MarketDataFeed feed(ticks);
+        const long long ns = time_ns([&] { feed.generateData(static_cast<int>(N)); });
+        std::printf("mt19937, 1 thread %7.1f %10.1f  %s\n", ns / 1e6, N * 1e3 / ns, "-");
+    }
+    std::vector<MarketData> ticks(N); // pre-faulted: time the generation only
+    std::uint64_t reference = 0;
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        const LoadGenerator gen(config(threads));
+        const long long ns = time_ns([&] { gen.fillTicks(ticks.data(), N); });
+        const std::uint64_t digest = tick_digest(ticks.data(), N);
+        if (threads == 1) reference = digest;
+        std::printf("xorshift, %u thread%s %6.1f %10.1f  %s\n", threads, threads == 1 ? " " : "s",
+                    ns / 1e6, N * 1e3 / ns, digest == reference ? "yes" : "NO");
+    }
+    ticks.clear();
+    ticks.shrink_to_fit();
+
+    // Blocks arrive out of order: combine per-block digests order-independently
+    std::cout << "\n" << kStream << "-tick scenario, streamed in "
+              << LoadGenConfig{}.block << "-tick blocks:\n";
+    std::uint64_t stream_ref = 0;
+    for (unsigned threads : {1u, 4u}) {
+        const LoadGenerator gen(config(threads));
+        std::atomic<std::uint64_t> combined{0};
+        const long long ns = time_ns([&] {
+            gen.streamTicks(kStream, [&](const MarketData* t, std::size_t count, std::size_t first) {
+                combined.fetch_add(tick_digest(t, count, first * 0x9E3779B97F4A7C15ull + 1),
+                                   std::memory_order_relaxed);
+            });
+        });
+        const std::uint64_t digest = combined.load();
+        if (threads == 1) stream_ref = digest;
+        std::printf("  %u worker%s %8.2f s %8.1f Mticks/s  same digest: %s\n", gen.threads(),
+                    gen.threads() == 1 ? " " : "s", ns / 1e9, kStream * 1e3 / ns,
+                    digest == stream_ref ? "yes" : "NO");
+    }
+
+    std::cout << "\nOrder flow (" << kCmds << " commands, all workers):\n";
+    std::printf("Profile          ms    new%%  cancel%%  replace%%  crossing%%  1-thread same\n");
+    using Command = GatewayCommand<Price, OrderId>;
+    std::vector<Command> cmds, single;
+    for (OrderFlow flow : {OrderFlow::Balanced, OrderFlow::CancelHeavy, OrderFlow::Aggressive,
+                           OrderFlow::DeepBook}) {
+        const OrderFlowProfile profile = orderFlowProfile(flow);
+        const LoadGenerator gen(config(0));
+        const long long ns = time_ns([&] { gen.generateOrders(cmds, kCmds, profile); });
+        LoadGenerator(config(1)).generateOrders(single, kCmds, profile);
+        bool same = true;
+        std::size_t news = 0, cancels = 0, replaces = 0, crossing = 0;
+        const Price mid = LoadGenConfig{}.mid_ticks * LoadGenConfig{}.tick_size;
+        for (std::size_t i = 0; i < kCmds; ++i) {
+            const Command& c = cmds[i];
+            const Command& o = single[i];
+            same = same && c.kind == o.kind && c.id == o.id && c.price == o.price &&
+                   c.quantity == o.quantity && c.is_buy == o.is_buy;
+            switch (c.kind) {
+            case Command::Kind::New:
+                ++news;
+                crossing += c.is_buy ? c.price > mid : c.price < mid;
+                break;
+            case Command::Kind::Cancel:  ++cancels; break;
+            case Command::Kind::Replace: ++replaces; break;
+            }
+        }
+        auto pct = [&](std::size_t k) { return 100.0 * k / kCmds; };
+        std::printf("%-13s %6.1f %7.1f %8.1f %9.1f %10.1f  %s\n", profile.name, ns / 1e6, pct(news),
+                    pct(cancels), pct(replaces), 100.0 * crossing / (news ? news : 1), same ? "yes" : "NO");
+    }
+    std::cout << "\n";
+}
+
+// CSV TradeLogger vs binary TradeJournal on the same trades: write cost per
+// trade (including the final flush/close) and bytes on disk, then check that
+// the journal converts back to exactly the CSV the logger wrote.
+static void run_journal_comparison() {
+    constexpr std::size_t N = 1'000'000;
+    const std::string csv_path = "journal_cmp.csv";
+    const std::string bin_path = "journal_cmp.bin";
+
+    std::vector<TradeType> trades(N);
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> tick_dist(9'000, 11'000);
+    for (std::size_t i = 0; i < N; ++i) {
+        trades[i] = TradeType{static_cast<OrderId>(2 * i + 1), static_cast<OrderId>(2 * i + 2),
+                              tick_dist(rng) * 0.01, 10 + static_cast<int>(i % 190),
+                              t0 + std::chrono::nanoseconds(137 * i)};
+    }
+
+    auto file_bytes = [](const std::string& path) {
+        std::ifstream f(path, std::ios::binary | std::ios::ate);
+        return static_cast<long long>(f.tellg());
+    };
+    auto time_ns = [](auto&& body) {
+        Timer t; t.start();
+        body();
+        return t.stop();
+    };
+
+    const long long csv_ns = time_ns([&] {
+        TradeLogger<TradeType> logger(csv_path, 4096);
+        for (const auto& tr : trades) logger.push(tr);
+    });
+    const long long bin_ns = time_ns([&] {
+        TradeJournal<TradeType> journal(bin_path, N);
+        for (const auto& tr : trades) journal.push(tr);
+    });
+
+    // Offline conversion must reproduce the logger's CSV byte for byte
+    std::ostringstream converted;
+    {
+        TradeJournalReader in(bin_path);
+        writeTradeCsvHeader(converted);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            const JournalTrade<Price> t = in.trade<Price>(i);
+            writeTradeCsvFields(converted, t.buy_id, t.sell_id, t.price, t.quantity,
+                                static_cast<long long>(t.ts_ns));
+        }
+    }
+    std::ostringstream original;
+    original << std::ifstream(csv_path).rdbuf();
+
+    const long long csv_bytes = file_bytes(csv_path);
+    const long long bin_bytes = file_bytes(bin_path);
+    std::cout << "=== Trade journal vs CSV (" << N << " trades) ===\n";
+    std::printf("Format       ns/trade      bytes   MB per 10M trades\n");
+    std::printf("CSV       %11.1f %10lld %19.1f\n", (double)csv_ns / N, csv_bytes, csv_bytes * 10.0 / 1e6);
+    std::printf("Journal   %11.1f %10lld %19.1f\n", (double)bin_ns / N, bin_bytes, bin_bytes * 10.0 / 1e6);
+    std::cout << "Converted journal matches CSV: "
+              << (converted.str() == original.str() ? "yes" : "NO") << "\n\n";
+}
+
+// Tick capture and replay: record a generated session, map it back and drive
+// the same engine from the vector and from the mapped file. Replay must be
+// tick-for-tick identical (same trades); a fixed seed must regenerate a
+// byte-identical capture; paced replay must take about as long as the
+// captured session.
+static void run_tick_replay_bench() {
+    constexpr int N = 1'000'000;
+    const std::string path = "ticks_replay.bin";
+    const std::string path2 = "ticks_replay_again.bin";
+
+    std::vector<MarketData> ticks;
+    MarketDataFeed feed(ticks);
+    feed.generateData(N);
+
+    auto same_tick = [](const MarketData& a, const MarketData& b) {
+        return a.symbol_id == b.symbol_id && a.bid_size == b.bid_size && a.ask_size == b.ask_size
+            && a.bid_price == b.bid_price && a.ask_price == b.ask_price
+            && a.exchange_ts_ns == b.exchange_ts_ns;
+    };
+    auto ts_of = [](const MarketData& md) { return md.exchange_ts_ns; };
+
+    // Crossing order flow per tick, one engine per replay; returns trades
+    struct Replay { std::size_t trades; long long ns; };
+    auto drive = [&](const MarketData* first, const MarketData* last, ReplayPacing pacing) {
+        Book   book;
+        OMS    oms;
+        Engine engine(book, oms);
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        oms.reserve(n);
+        book.reserveLevels(n); // prices off each tick's mid: up to one level per order
+        engine.reserveLevels(n);
+
+        std::size_t trades = 0;
+        auto count = [&](const TradeType&) { ++trades; };
+        OrderId next_id = 1;
+        bool is_buy = false;
+        Timer t; t.start();
+        replayTicks(first, last, [&](const MarketData& md) {
+            const Price mid = (md.bid_price + md.ask_price) * 0.5;
+            is_buy = !is_buy;
+            engine.submit(OrderType{next_id++, is_buy ? mid + 0.05 : mid - 0.05, 100, is_buy}, count);
+        }, ts_of, pacing);
+        return Replay{trades, t.stop()};
+    };
+
+    auto capture = [](const std::string& to, const std::vector<MarketData>& from, const SymbolTable& symbols) {
+        Timer t; t.start();
+        TickRecorder<MarketData> recorder(to);
+        recorder.record(from.data(), from.data() + from.size());
+        recorder.close(&symbols);
+        return t.stop();
+    };
+    const long long record_ns = capture(path, ticks, feed.symbols());
+
+    MappedTickFile<MarketData> file(path);
+    bool identical = file.size() == ticks.size() && file.symbols().size() == feed.symbols().size();
+    for (std::size_t i = 0; identical && i < ticks.size(); ++i) identical = same_tick(file[i], ticks[i]);
+
+    const Replay from_vec  = drive(ticks.data(), ticks.data() + ticks.size(), ReplayPacing::AsFastAsPossible);
+    const Replay from_file = drive(file.begin(), file.end(), ReplayPacing::AsFastAsPossible);
+
+    // Same seed, new feed: rebased onto the first capture's start time (the
+    // base is a wall-clock read), its capture must match byte for byte
+    std::vector<MarketData> again;
+    MarketDataFeed feed2(again);
+    feed2.generateData(N);
+    const std::int64_t dt = again.front().exchange_ts_ns - ticks.front().exchange_ts_ns;
+    for (MarketData& md : again) md.exchange_ts_ns -= dt;
+    capture(path2, again, feed2.symbols());
+    auto file_bytes = [](const std::string& p) {
+        std::ostringstream os;
+        os << std::ifstream(p, std::ios::binary).rdbuf();
+        return os.str();
+    };
+    const bool reproducible = file_bytes(path2) == file_bytes(path);
+
+    // Paced: 10K ticks 100 ns apart span >= 1 ms of wall time (more when the
+    // engine is slower than the captured tick rate)
+    constexpr std::size_t kPaced = 10'000;
+    const Replay paced = drive(file.begin(), file.begin() + kPaced, ReplayPacing::Original);
+    const double captured_ms = (file[kPaced - 1].exchange_ts_ns - file[0].exchange_ts_ns) / 1e6;
+
+    auto mticks = [](const Replay& r, std::size_t n) { return n * 1e3 / static_cast<double>(r.ns); };
+    std::cout << "=== Tick capture/replay (" << N << " ticks) ===\n";
+    std::printf("Record: %.2f Mticks/s\n", N * 1e3 / static_cast<double>(record_ns));
+    std::printf("Source           Mticks/s     trades\n");
+    std::printf("std::vector     %9.2f %10zu\n", mticks(from_vec, N), from_vec.trades);
+    std::printf("mmap file       %9.2f %10zu\n", mticks(from_file, N), from_file.trades);
+    std::printf("Paced %zu ticks: %.2f ms wall for %.2f ms captured\n",
+                kPaced, paced.ns / 1e6, captured_ms);
+    std::cout << "Mapped ticks match recorded: " << (identical ? "yes" : "NO")
+              << ", same trades: " << (from_vec.trades == from_file.trades ? "yes" : "NO")
+              << ", seed reproducible (capture bytes): " << (reproducible ? "yes" : "NO") << "\n\n";
+}
+
+// Producer threads -> OrderGateway -> matcher thread -> response rings.
+// Each producer sends a new/cancel/replace mix and times enqueue -> first fill
+// of its own aggressive commands; histograms are merged across producers.
+// Returns true if every trade reached the owners of both its orders.
+static bool run_gateway_trial(std::size_t producers, int cmds_per_producer) {
+    using Gateway  = OrderGateway<Price, OrderId>;
+    using Command  = Gateway::CommandT;
+    using Response = Gateway::ResponseT;
+
+    const unsigned hw = std::thread::hardware_concurrency();
+    const std::size_t total = producers * static_cast<std::size_t>(cmds_per_producer);
+    Gateway gw(producers, 4096, total, hw > 1 ? 0 : -1);
+
+    std::vector<LatencyHistogram> hists(producers);
+    std::vector<std::uint64_t> fills(producers, 0);
+    std::atomic<std::size_t> submitted_all{0};
+
+    auto producer = [&](std::size_t p) {
+        LatencyHistogram& h = hists[p];
+        std::mt19937 rng(1000 + static_cast<unsigned>(p));
+        std::uniform_int_distribution<int> kind_dist(0, 9);
+        std::uniform_int_distribution<int> side_dist(0, 1);
+        std::uniform_int_distribution<int> qty_dist(10, 200);
+        std::uniform_int_distribution<int> skew_dist(0, 10); // ticks through mid
+
+        auto on_response = [&](const Response& r) {
+            if (r.kind == Response::Kind::Fill) ++fills[p];
+            if (r.kind == Response::Kind::Fill && r.first_fill)
+                h.record(static_cast<long long>(TscClock::toNs(TscClock::stop() - r.enqueue_tsc)));
+        };
+
+        // Ids interleave across producers so they never collide
+        OrderId recent[64] = {};
+        OrderId next_id = static_cast<OrderId>(p + 1);
+        const OrderId id_step = static_cast<OrderId>(producers);
+
+        for (int k = 0; k < cmds_per_producer; ++k) {
+            Command c;
+            const int kind = kind_dist(rng);
+            const OrderId old_id = recent[rng() & 63];
+            if (kind == 0 && old_id != 0) {
+                c.kind = Command::Kind::Cancel;
+                c.id = old_id;
+            } else if (kind == 1 && old_id != 0) {
+                c.kind = Command::Kind::Replace;
+                c.id = old_id;
+                c.price = (10'000 + skew_dist(rng) - 5) * 0.01;
+            } else {
+                c.kind = Command::Kind::New;
+                c.id = next_id;
+                c.is_buy = side_dist(rng) == 1;
+                c.quantity = qty_dist(rng);
+                const int s = skew_dist(rng);
+                c.price = (10'000 + (c.is_buy ? s : -s)) * 0.01;
+                recent[k & 63] = next_id;
+                next_id += id_step;
+            }
+
+            c.enqueue_tsc = TscClock::start();
+            gw.submit(p, c, on_response);
+            gw.poll(p, on_response);
+        }
+        submitted_all.fetch_add(1, std::memory_order_release);
+
+        // Keep draining until the matcher has handed off its last fills
+        Backoff wait;
+        while (!gw.stopped()) {
+            if (gw.poll(p, on_response) == 0) wait.pause();
+        }
+        while (gw.poll(p, on_response) > 0) {}
+    };
+
+    Timer wall; wall.start();
+    gw.start();
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) threads.emplace_back(producer, p);
+    while (submitted_all.load(std::memory_order_acquire) < producers) std::this_thread::yield();
+    gw.stop();
+    const long long ns = wall.stop();
+    for (auto& t : threads) t.join();
+
+    LatencyHistogram all;
+    for (const auto& h : hists) all.merge(h);
+    const GatewayStats& gs = gw.stats();
+    std::printf("%9zu %12.2f %9llu %8lld %8lld %8lld %10llu %8llu %8llu\n",
+                producers, gs.commands * 1e3 / (double)ns, (unsigned long long)gs.trades,
+                all.percentile(0.50), all.percentile(0.99), all.percentile(0.999),
+                (unsigned long long)gs.response_stalls, (unsigned long long)gs.throttled,
+                (unsigned long long)gs.rejects);
+    std::uint64_t delivered = 0;
+    for (std::uint64_t f : fills) delivered += f;
+
+    return delivered == 2 * gs.trades;
+}
+
+static void run_gateway_scaling() {
+    constexpr int kCmds = 50'000;
+    std::cout << "=== Order gateway: enqueue -> first fill (" << kCmds << " commands per producer, "
+              << std::thread::hardware_concurrency() << " hw threads) ===\n";
+    std::cout << "Producers   Mcmds/sec    Trades      P50      P99    P99.9  RespStall Throttle  Rejects\n";
+    bool delivered = true;
+    for (std::size_t producers : {1, 2, 4, 8}) delivered &= run_gateway_trial(producers, kCmds);
+    std::cout << "Every fill delivered to both owners: " << (delivered ? "yes" : "NO") << "\n\n";
+}
+
 int main() {
+    // Calibrate the TSC up front; every number below includes this overhead
+    printTimerInfo(std::cout);
+    {
+        PerfCounters probe;
+        PerfCounters::printInfo(std::cout, probe);
+    }
+    std::cout << "\n";
+
     // Experiments per the exercise:
     // - Load scaling: 1K, 10K, 100K ticks
     // - Container preallocation: reserve() ON vs OFF
     // You can add more trials for alignas(64) toggle, allocators, container layout, etc.
 
     std::vector<TrialConfig> trials = {
-        { 1'000,  false, false, "Load=1K, reserve=OFF" },
-        { 1'000,  true,  false, "Load=1K, reserve=ON"  },
-        { 10'000, false, false, "Load=10K, reserve=OFF" },
-        { 10'000, true,  false, "Load=10K, reserve=ON"  },
-        { 100'000,false, false, "Load=100K, reserve=OFF" },
-        { 100'000,true,  false, "Load=100K, reserve=ON"  },
+        { 1'000,  false, LogMode::Off, "Load=1K, reserve=OFF" },
+        { 1'000,  true,  LogMode::Off, "Load=1K, reserve=ON"  },
+        { 10'000, false, LogMode::Off, "Load=10K, reserve=OFF" },
+        { 10'000, true,  LogMode::Off, "Load=10K, reserve=ON"  },
+        { 100'000,false, LogMode::Off, "Load=100K, reserve=OFF" },
+        { 100'000,true,  LogMode::Off, "Load=100K, reserve=ON"  },
+        // Logging on the matching thread vs handing off to the writer thread
+        { 100'000,true,  LogMode::Sync,  "Load=100K, log=sync"  },
+        { 100'000,true,  LogMode::Async, "Load=100K, log=async" },
     };
 
     // Run all trials
@@ -166,21 +1440,153 @@ int main() {
         run_trial(cfg);
     }
 
+    // Crossing cost vs resting book depth (should stay flat)
+    run_depth_sweep();
+
+    // Incremental L2 deltas and top-N snapshots per order
+    run_depth_publish_bench();
+
+    // submit/replace/cancel one call per order vs batches of 1/16/256
+    run_batch_submit_bench();
+
+    // new/cancel/replace/aggressive mixes, per-type service and response tails
+    run_order_flow_sequencer();
+
+    // double vs int32/int64 tick prices, map vs ladder book
+    run_price_type_bench();
+
+    // Snapshot + journal-tail warm restart vs full journal replay (1M resting)
+    run_snapshot_restart_bench();
+
+    // Book/OMS arenas on 4K vs 2MB pages under random-id access
+    run_arena_pages_bench();
+
+    // Slow consumer behind every-tick / latest-only / windowed conflation
+    run_conflation_bench();
+
+    // Tick generation: per-tick std::string vs interned symbol ids
+    run_feed_generation_bench();
+
+    // Parallel deterministic ticks/order flow vs the single-threaded feed
+    run_load_generator_bench();
+
+    // Binary journal vs text CSV write cost and file size
+    run_journal_comparison();
+
+    // Captured ticks replayed from a mapped file vs the in-memory vector
+    run_tick_replay_bench();
+
+    // Multi-producer gateway: latency and throughput vs producer count
+    run_gateway_scaling();
+
+    // OMS hot path in isolation: create -> partial fill -> fill/cancel after reserve()
+    {
+        constexpr int N = 100'000;
+        auto oms_allocs = [&](auto& oms) {
+            oms.reserve(N);
+            const std::size_t before = g_allocs.load(std::memory_order_relaxed);
+            for (OrderId id = 1; id <= N; ++id) {
+                (void)oms.create(id, 100.0, 100, (id & 1) != 0);
+                oms.fill(id, 40);
+                if (id % 3 == 0) oms.cancel(id);
+                else             oms.fill(id, 60);
+            }
+            return g_allocs.load(std::memory_order_relaxed) - before;
+        };
+        SharedOMS shared_oms;
+        OMS       pooled_oms;
+        std::cout << "=== OMS hot-path allocations (" << N << " orders, reserve=ON) ===\n"
+                  << "OrderManager (shared_ptr): " << oms_allocs(shared_oms) << "\n"
+                  << "PooledOrderManager:        " << oms_allocs(pooled_oms) << "\n\n";
+    }
+
     // Optional: show current top-of-book state in a small sanity check run
     {
         Book book;
         OMS  oms;
         Engine engine(book, oms);
-        book.reserve(10000);
         oms.reserve(10000);
 
         // Simple two-order cross
         engine.submit(OrderType{1, 100.5, 100, true});  // buy
         engine.submit(OrderType{2, 100.4, 100, false}); // sell
 
-        std::cout << "Snapshot BestBid=" << book.bestBid()
-                  << " BestAsk=" << book.bestAsk() << "\n";
+        // Both orders filled: the book is empty on both sides, not "at 0"
+        std::cout << "Snapshot BestBid=" << (book.hasBid() ? std::to_string(book.bestBid()) : "-")
+                  << " BestAsk=" << (book.hasAsk() ? std::to_string(book.bestAsk()) : "-") << "\n";
+    }
+
+    // Integer tick prices select the flat-array ladder book
+    {
+        using TickOrder  = Order<int, OrderId>;
+        using TickBook   = OrderBook<int, OrderId>; // -> LadderOrderBook
+        using TickOMS    = PooledOrderManager<int, OrderId>;
+        using TickEngine = MatchingEngine<int, OrderId>;
+
+        TickBook book;
+        TickOMS  oms;
+        TickEngine engine(book, oms);
+
+        engine.submit(TickOrder{1, 10050, 100, true});  // buy 100 @ 100.50
+        engine.submit(TickOrder{2, 10040,  60, false}); // sell 60 @ 100.40 -> partial fill
+        engine.submit(TickOrder{3, 10110,  50, false}); // resting ask
+
+        std::cout << "Ladder Snapshot BestBid=" << book.bestBid()
+                  << " BestAsk=" << book.bestAsk()
+                  << " BidVol=" << book.totalVolume(10050)
+                  << " Levels=" << book.levelCount() << "\n";
+    }
+
+    // A price 2^28 ticks from the resting band: the ladder window stays
+    // capped and the far level lives in the overflow map (no multi-GB arrays)
+    bool ladder_far_ok = true;
+    {
+        using FarOrder  = Order<long long, OrderId>;
+        using FarBook   = OrderBook<long long, OrderId>;
+        using FarEngine = MatchingEngine<long long, OrderId, FarBook, PooledOrderManager<long long, OrderId>>;
+        constexpr long long kFar = 15'000 + (1LL << 28);
+
+        FarBook book;
+        PooledOrderManager<long long, OrderId> oms;
+        FarEngine engine(book, oms);
+        engine.submit(FarOrder{1, 15'000, 100, true});
+        engine.submit(FarOrder{2, kFar, 40, false});
+        engine.submit(FarOrder{3, 15'010, 30, false});   // in-window ask beats the far one
+        ladder_far_ok &= book.tickCapacity() <= book.maxTickCapacity() && book.overflowLevelCount() == 1;
+        ladder_far_ok &= book.bestBid() == 15'000 && book.bestAsk() == 15'010 && book.totalVolume(kFar) == 40;
+        engine.cancel(3);
+        ladder_far_ok &= book.bestAsk() == kFar;    // only the far ask is left
+        DepthLevel<long long> bids[4], asks[4];
+        const DepthCounts c = book.topN(4, bids, asks);
+        ladder_far_ok &= c.bids == 1 && c.asks == 1 && asks[0].price == kFar;
+        engine.submit(FarOrder{4, kFar, 40, true}); // crosses the far ask
+        ladder_far_ok &= !book.hasAsk() && book.overflowLevelCount() == 0 && book.levelCount() == 1;
+        std::cout << "Ladder far price (" << kFar << "): window " << book.tickCapacity() << "/"
+                  << book.maxTickCapacity() << " ticks, overflow handled: " << (ladder_far_ok ? "yes" : "NO") << "\n";
+    }
+
+    // Resting orders are shared with the book: the OMS must refuse to amend,
+    // reprice, cancel or release them behind the engine's back
+    bool oms_guard_ok = true;
+    {
+        using TickOrder = Order<long long, OrderId>;
+        OrderBook<long long, OrderId> book;
+        PooledOrderManager<long long, OrderId> oms;
+        MatchingEngine<long long, OrderId> engine(book, oms);
+        engine.submit(TickOrder{1, 10'000, 100, true});
+        engine.submit(TickOrder{2, 10'000, 50, true});
+        oms_guard_ok &= !oms.amendQuantity(1, 10) && !oms.replacePrice(1, 9'990);
+        oms_guard_ok &= !oms.cancel(2) && !oms.fill(2, 20) && !oms.release(2);
+        oms_guard_ok &= book.totalVolume(10'000) == 150 && oms.getRemainingQty(1) == 100;
+
+        // The engine path still works, and leaves the level consistent
+        oms_guard_ok &= engine.cancel(2) && book.totalVolume(10'000) == 100;
+        oms_guard_ok &= oms.release(2) && !oms.exists(2); // off the book: releasable
+        engine.submit(TickOrder{3, 10'000, 100, false});  // takes all of order 1
+        oms_guard_ok &= !book.hasBid() && !book.hasAsk() && oms.state(1) == OrderState::Filled;
+        oms_guard_ok &= oms.release(1);
+        std::cout << "OMS refuses to edit resting orders: " << (oms_guard_ok ? "yes" : "NO") << "\n";
     }
 
-    return 0;
+    return ladder_far_ok && oms_guard_ok ? 0 : 1;
 }
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/RuntimeConfig.hpp"
+#include "../include/ShardedEngine.hpp"
+#include "../include/Timer.hpp"
+
+// Symbol-sharded matching throughput: the same routed command stream is run
+// through 1, 2, 4 and 8 shards; one router thread feeds the shard rings.
+
+using Price   = double;
+using OrderId = int;
+
+using Sharded = ShardedEngine<Price, OrderId>;
+using Command = Sharded::CommandT;
+
+struct Routed {
+    std::uint32_t instrument;
+    Command cmd;
+};
+
+// New/cancel/replace mix crossing around a per-instrument mid (kept out of the timed region)
+static std::vector<Routed> make_flow(std::uint32_t instruments, std::size_t n, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::uint32_t> inst_dist(0, instruments - 1);
+    std::uniform_int_distribution<int> kind_dist(0, 9);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> qty_dist(10, 200);
+    std::uniform_int_distribution<int> skew_dist(0, 10);
+
+    std::vector<std::vector<OrderId>> recent(instruments, std::vector<OrderId>(64, 0));
+    std::vector<Routed> flow;
+    flow.reserve(n);
+    OrderId next_id = 1;
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::uint32_t inst = inst_dist(rng);
+        const int mid = 10'000 + 100 * static_cast<int>(inst);
+        Command c;
+        const int kind = kind_dist(rng);
+        const OrderId old_id = recent[inst][rng() & 63];
+        if (kind == 0 && old_id != 0) {
+            c.kind = Command::Kind::Cancel;
+            c.id = old_id;
+        } else if (kind == 1 && old_id != 0) {
+            c.kind = Command::Kind::Replace;
+            c.id = old_id;
+            c.price = (mid + skew_dist(rng) - 5) * 0.01;
+        } else {
+            c.kind = Command::Kind::New;
+            c.id = next_id++;
+            c.is_buy = side_dist(rng) == 1;
+            c.quantity = qty_dist(rng);
+            const int s = skew_dist(rng);
+            c.price = (mid + (c.is_buy ? s : -s)) * 0.01;
+            recent[inst][k & 63] = c.id;
+        }
+        flow.push_back(Routed{inst, c});
+    }
+    return flow;
+}
+
+// Runtime flags (RuntimeConfig.hpp): --cpu-feed N pins the router,
+// --cpu-shards FIRST the workers, --huge-pages backs the books' arenas.
+// Without pinning flags: router on cpu 0, workers on 1..shards when the box has the cores.
+int main(int argc, char** argv) {
+    RuntimeConfig runtime;
+    constexpr unsigned kRoles = kRoleFeed | kRoleShards; // no matcher or logger thread here
+    for (int a = 1; a < argc; ++a) {
+        if (!parseRuntimeFlag(a, argc, argv, runtime, kRoles)) {
+            std::cerr << "usage: " << argv[0] << "\n";
+            printRuntimeUsage(std::cerr, kRoles);
+            return 2;
+        }
+    }
+    applyRuntimeConfig(runtime);
+    const bool explicit_pins = runtime.feed_cpu >= 0 || runtime.shard_first_cpu >= 0;
+
+    printTimerInfo(std::cout);
+    printRuntimeConfig(std::cout, runtime, kRoles);
+
+    constexpr std::uint32_t kInstruments = 64;
+    constexpr std::size_t kCommands = 2'000'000;
+    const unsigned hw = std::thread::hardware_concurrency();
+
+    const std::vector<Routed> flow = make_flow(kInstruments, kCommands, 2025);
+    const std::size_t per_instrument = kCommands / kInstruments * 2;
+
+    std::cout << "\n=== Shard scaling (" << kInstruments << " instruments, " << kCommands
+              << " commands, " << hw << " hw threads) ===\n";
+    std::cout << "Shards   Mcmds/sec  Speedup    Trades  MinCmds/shard  MaxCmds/shard  Pinned\n";
+
+    double base = 0.0;
+    for (std::size_t shards : {1, 2, 4, 8}) {
+        const bool pin = explicit_pins || hw > shards;
+        const int router_cpu = explicit_pins ? runtime.feed_cpu : 0;
+        const int first_worker = explicit_pins ? runtime.shard_first_cpu : 1;
+        Sharded engine(shards, per_instrument, pin ? first_worker : -1);
+        for (std::uint32_t i = 0; i < kInstruments; ++i) engine.addInstrument("SYM" + std::to_string(i));
+        if (pin && router_cpu >= 0) pin_current_thread(router_cpu);
+        engine.start();
+
+        Timer t; t.start();
+        for (const Routed& r : flow) engine.submit(r.instrument, r.cmd);
+        engine.stop();
+        const long long ns = t.stop();
+
+        std::uint64_t trades = 0, min_cmds = ~0ull, max_cmds = 0;
+        for (std::size_t s = 0; s < shards; ++s) {
+            trades += engine.sink(s).trades;
+            min_cmds = std::min<std::uint64_t>(min_cmds, engine.commands(s));
+            max_cmds = std::max<std::uint64_t>(max_cmds, engine.commands(s));
+        }
+        const double mcps = kCommands * 1e3 / static_cast<double>(ns);
+        if (shards == 1) base = mcps;
+        std::printf("%6zu %11.2f %8.2fx %9llu %14llu %14llu  %s\n", shards, mcps, mcps / base,
+                    (unsigned long long)trades, (unsigned long long)min_cmds,
+                    (unsigned long long)max_cmds, pin ? "yes" : "no");
+    }
+    return 0;
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+
+#include <vector>
+
 
 
 
@@ -48,4 +52,68 @@ inline double imbalance(const Quote& q) noexcept {
 
     return (q.bid_qty - q.ask_qty) / denom;
 
-}
\ No newline at end of file
+}
+
+
+
+
+// Structure-of-arrays view of a run of quotes: one contiguous column per
+
+// field, so a batch kernel loads N bids, N asks, ... with plain vector loads
+
+struct QuoteBlockView {
+
+    const double* bid;
+
+    const double* ask;
+
+    const double* bid_qty;
+
+    const double* ask_qty;
+
+    std::size_t size;
+
+};
+
+
+
+
+// Owning SoA storage for a quote stream (built once, outside the hot path)
+
+struct QuoteBlock {
+
+    std::vector<double> bid, ask, bid_qty, ask_qty;
+
+    explicit QuoteBlock(const std::vector<Quote>& quotes) {
+
+        const std::size_t n = quotes.size();
+
+        bid.resize(n); ask.resize(n); bid_qty.resize(n); ask_qty.resize(n);
+
+        for (std::size_t i = 0; i < n; ++i) {
+
+            bid[i] = quotes[i].bid;
+
+            ask[i] = quotes[i].ask;
+
+            bid_qty[i] = quotes[i].bid_qty;
+
+            ask_qty[i] = quotes[i].ask_qty;
+
+        }
+
+    }
+
+    std::size_t size() const noexcept { return bid.size(); }
+
+    // Quotes [first, first + n)
+
+    QuoteBlockView view(std::size_t first, std::size_t n) const noexcept {
+
+        return QuoteBlockView{bid.data() + first, ask.data() + first,
+
+                              bid_qty.data() + first, ask_qty.data() + first, n};
+
+    }
+
+};
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HFT_SIMD_X86 1
+#endif
+
+#include "market_data.hpp"
+
+// Batch form of the per-tick signal
+//   alpha1 * (microprice - mid) + alpha2 * imbalance
+// over a QuoteBlockView, writing one value per quote to out[0..size).
+// Same operation order as the scalar helpers in market_data.hpp, so every
+// kernel matches on_tick() up to FMA contraction.
+namespace simd {
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+inline const char* isa_name(Isa isa) {
+    switch (isa) {
+    case Isa::Avx512: return "avx512";
+    case Isa::Avx2:   return "avx2";
+    default:          return "scalar";
+    }
+}
+
+using SignalKernel = void (*)(const QuoteBlockView&, double a1, double a2, double* out);
+
+inline void signal_scalar(const QuoteBlockView& q, double a1, double a2, double* out) {
+    for (std::size_t i = 0; i < q.size; ++i) {
+        const double denom = q.bid_qty[i] + q.ask_qty[i];
+        const double mp  = (q.bid[i] * q.ask_qty[i] + q.ask[i] * q.bid_qty[i]) / denom;
+        const double m   = (q.bid[i] + q.ask[i]) * 0.5;
+        const double imb = (q.bid_qty[i] - q.ask_qty[i]) / denom;
+        out[i] = a1 * (mp - m) + a2 * imb;
+    }
+}
+
+#ifdef HFT_SIMD_X86
+// Compiled for the target ISA regardless of -march; only called after the
+// runtime check in detect_isa(), so the binary still runs on older cores.
+__attribute__((target("avx2,fma")))
+inline void signal_avx2(const QuoteBlockView& q, double a1, double a2, double* out) {
+    const __m256d va1 = _mm256_set1_pd(a1), va2 = _mm256_set1_pd(a2), half = _mm256_set1_pd(0.5);
+    std::size_t i = 0;
+    for (; i + 4 <= q.size; i += 4) {
+        const __m256d b  = _mm256_loadu_pd(q.bid + i);
+        const __m256d a  = _mm256_loadu_pd(q.ask + i);
+        const __m256d bq = _mm256_loadu_pd(q.bid_qty + i);
+        const __m256d aq = _mm256_loadu_pd(q.ask_qty + i);
+        const __m256d denom = _mm256_add_pd(bq, aq);
+        const __m256d mp  = _mm256_div_pd(_mm256_fmadd_pd(b, aq, _mm256_mul_pd(a, bq)), denom);
+        const __m256d m   = _mm256_mul_pd(_mm256_add_pd(b, a), half);
+        const __m256d imb = _mm256_div_pd(_mm256_sub_pd(bq, aq), denom);
+        _mm256_storeu_pd(out + i, _mm256_fmadd_pd(va1, _mm256_sub_pd(mp, m), _mm256_mul_pd(va2, imb)));
+    }
+    QuoteBlockView tail{q.bid + i, q.ask + i, q.bid_qty + i, q.ask_qty + i, q.size - i};
+    signal_scalar(tail, a1, a2, out + i);
+}
+
+__attribute__((target("avx512f")))
+inline void signal_avx512(const QuoteBlockView& q, double a1, double a2, double* out) {
+    const __m512d va1 = _mm512_set1_pd(a1), va2 = _mm512_set1_pd(a2), half = _mm512_set1_pd(0.5);
+    std::size_t i = 0;
+    for (; i + 8 <= q.size; i += 8) {
+        const __m512d b  = _mm512_loadu_pd(q.bid + i);
+        const __m512d a  = _mm512_loadu_pd(q.ask + i);
+        const __m512d bq = _mm512_loadu_pd(q.bid_qty + i);
+        const __m512d aq = _mm512_loadu_pd(q.ask_qty + i);
+        const __m512d denom = _mm512_add_pd(bq, aq);
+        const __m512d mp  = _mm512_div_pd(_mm512_fmadd_pd(b, aq, _mm512_mul_pd(a, bq)), denom);
+        const __m512d m   = _mm512_mul_pd(_mm512_add_pd(b, a), half);
+        const __m512d imb = _mm512_div_pd(_mm512_sub_pd(bq, aq), denom);
+        _mm512_storeu_pd(out + i, _mm512_fmadd_pd(va1, _mm512_sub_pd(mp, m), _mm512_mul_pd(va2, imb)));
+    }
+    // Masked tail: the last size % 8 quotes in one pass
+    const __mmask8 k = static_cast<__mmask8>((1u << (q.size - i)) - 1u);
+    if (k) {
+        const __m512d b  = _mm512_maskz_loadu_pd(k, q.bid + i);
+        const __m512d a  = _mm512_maskz_loadu_pd(k, q.ask + i);
+        const __m512d bq = _mm512_mask_loadu_pd(_mm512_set1_pd(1.0), k, q.bid_qty + i); // keep denom != 0
+        const __m512d aq = _mm512_maskz_loadu_pd(k, q.ask_qty + i);
+        const __m512d denom = _mm512_add_pd(bq, aq);
+        const __m512d mp  = _mm512_div_pd(_mm512_fmadd_pd(b, aq, _mm512_mul_pd(a, bq)), denom);
+        const __m512d m   = _mm512_mul_pd(_mm512_add_pd(b, a), half);
+        const __m512d imb = _mm512_div_pd(_mm512_sub_pd(bq, aq), denom);
+        _mm512_mask_storeu_pd(out + i, k, _mm512_fmadd_pd(va1, _mm512_sub_pd(mp, m), _mm512_mul_pd(va2, imb)));
+    }
+}
+#endif
+
+// Widest ISA this CPU supports; HFT_SIMD=scalar|avx2|avx512 caps it (for A/B runs)
+inline Isa detect_isa() {
+    Isa best = Isa::Scalar;
+#ifdef HFT_SIMD_X86
+    if (__builtin_cpu_supports("avx512f"))                                    best = Isa::Avx512;
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) best = Isa::Avx2;
+#endif
+    if (const char* env = std::getenv("HFT_SIMD")) {
+        Isa cap = best;
+        if (std::strcmp(env, "scalar") == 0)    cap = Isa::Scalar;
+        else if (std::strcmp(env, "avx2") == 0) cap = Isa::Avx2;
+        if (static_cast<int>(cap) < static_cast<int>(best)) best = cap;
+    }
+    return best;
+}
+
+inline SignalKernel select_kernel(Isa isa) {
+#ifdef HFT_SIMD_X86
+    if (isa == Isa::Avx512) return &signal_avx512;
+    if (isa == Isa::Avx2)   return &signal_avx2;
+#else
+    (void)isa;
+#endif
+    return &signal_scalar;
+}
+
+// Resolved once per process; strategies cache the pointer at construction
+inline Isa active_isa() {
+    static const Isa isa = detect_isa();
+    return isa;
+}
+
+} // namespace simd
@@ -1,5 +1,7 @@
 #pragma once
+#include <span>
 #include "market_data.hpp"
+#include "signal_simd.hpp"
 
 // CRTP base: static dispatch
 template <class Derived>
@@ -8,12 +10,24 @@ struct StrategyBase {
     double on_tick(const Quote& q) {
         return static_cast<Derived*>(this)->on_tick_impl(q);
     }
+
+    // Batch form: one signal per quote of an SoA block into out[0..block.size).
+    // Forwards to Derived::on_ticks_impl if it has one, else loops on_tick().
+    void on_ticks(const QuoteBlockView& block, std::span<double> out) {
+        static_cast<Derived*>(this)->on_ticks_impl(block, out);
+    }
+
+    void on_ticks_impl(const QuoteBlockView& block, std::span<double> out) {
+        for (std::size_t i = 0; i < block.size; ++i)
+            out[i] = on_tick(Quote{block.bid[i], block.ask[i], block.bid_qty[i], block.ask_qty[i]});
+    }
 };
 
 // Same behavior as SignalStrategyVirtual but via CRTP
 struct SignalStrategyCRTP : public StrategyBase<SignalStrategyCRTP> {
     double alpha1;
     double alpha2;
+    simd::SignalKernel kernel = simd::select_kernel(simd::active_isa());
 
     explicit SignalStrategyCRTP(double a1, double a2) : alpha1(a1), alpha2(a2) {}
 
@@ -24,4 +38,9 @@ struct SignalStrategyCRTP : public StrategyBase<SignalStrategyCRTP> {
         const double imb = imbalance(q);
         return alpha1 * (mp - m) + alpha2 * imb;
     }
+
+    // Widest SIMD kernel the CPU supports (runtime dispatch, scalar fallback)
+    void on_ticks_impl(const QuoteBlockView& block, std::span<double> out) {
+        kernel(block, alpha1, alpha2, out.data());
+    }
 };
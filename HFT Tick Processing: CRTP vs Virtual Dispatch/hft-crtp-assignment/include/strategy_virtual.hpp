@@ -1,14 +1,24 @@
 #pragma once
+#include <span>
 #include "market_data.hpp"
+#include "signal_simd.hpp"
 
 struct IStrategy {
     virtual ~IStrategy() = default;
     virtual double on_tick(const Quote& q) = 0; 
+
+    // Batch form: one virtual call per block instead of per tick.
+    // Default loops on_tick(); strategies override with a vector kernel.
+    virtual void on_ticks(const QuoteBlockView& block, std::span<double> out) {
+        for (std::size_t i = 0; i < block.size; ++i)
+            out[i] = on_tick(Quote{block.bid[i], block.ask[i], block.bid_qty[i], block.ask_qty[i]});
+    }
 };
 
 struct SignalStrategyVirtual : IStrategy {
     double alpha1;
     double alpha2;
+    simd::SignalKernel kernel = simd::select_kernel(simd::active_isa());
 
     explicit SignalStrategyVirtual(double a1, double a2)
         : alpha1(a1), alpha2(a2) {}
@@ -19,4 +29,8 @@ struct SignalStrategyVirtual : IStrategy {
         const double imb = imbalance(q);
         return alpha1 * (mp - m) + alpha2 * imb;
     }
+
+    void on_ticks(const QuoteBlockView& block, std::span<double> out) override {
+        kernel(block, alpha1, alpha2, out.data());
+    }
 };
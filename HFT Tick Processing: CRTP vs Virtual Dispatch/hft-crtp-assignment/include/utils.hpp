@@ -1,6 +1,9 @@
 #pragma once
 #include <chrono>
 #include <cstdint>
+#include "../../../Build_and_Benchmark_HFT_System/include/TscClock.hpp"
+#include "../../../Build_and_Benchmark_HFT_System/include/PerfCounters.hpp"
+#include "../../../Build_and_Benchmark_HFT_System/include/XorShift32.hpp" // XorShift32 (deterministic PRNG)
 
 
 // Prevent the optimizer from eliding computations.
@@ -28,7 +31,7 @@ inline void do_not_optimize_away(T const& value) {
 
 
 
-struct Timer {
+struct ChronoTimer {
 
     using clock = std::chrono::steady_clock;
 
@@ -49,42 +52,41 @@ struct Timer {
 
 
 
-// Simple, fast xorshift32 PRNG (deterministic)
-
-struct XorShift32 {
+// Invariant-TSC timer (steady_clock fallback); call TscClock::calibrate() first
 
-    uint32_t state;
+struct Timer {
 
-    explicit XorShift32(uint32_t seed = 0xDEADBEEF) : state(seed) {}
+    uint64_t t0 = 0;
 
-    uint32_t next_u32() {
+    void start() { t0 = TscClock::start(); }
 
-        uint32_t x = state;
+    double stop_ns() const { return TscClock::toNs(TscClock::stop() - t0); }
 
-        x ^= x << 13;
+};
 
-        x ^= x >> 17;
 
-        x ^= x << 5;
 
-        state = x;
 
-        return x;
+// Mean cost of an empty start()/stop_ns() pair, in ns
 
-    }
+template <class TimerT = Timer>
 
-    // Produce doubles in [low, high)
+inline double timer_overhead_ns(int iterations = 200000) {
 
-    double uniform(double low, double high) {
+    TscClock::calibrate();
 
-        // 24-bit mantissa extraction for uniformity
+    double total = 0.0;
 
-        const double scale = 1.0 / (1u << 24);
+    for (int i = 0; i < iterations; ++i) {
 
-        double u = (next_u32() & 0xFFFFFF) * scale;
+        TimerT t; t.start();
 
-        return low + (high - low) * u;
+        total += t.stop_ns();
 
     }
 
-};
+    return total / iterations;
+
+}
+
+
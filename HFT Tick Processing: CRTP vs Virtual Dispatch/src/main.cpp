@@ -3,11 +3,16 @@
 #include <vector>
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <sstream>
 
 #include "market_data.hpp"
 #include "utils.hpp"
 #include "strategy_virtual.hpp"
 #include "strategy_crtp.hpp"
+#include "signal_simd.hpp"
 
 // ----- Free function baseline (control)
 inline double signal_free(const Quote& q, double a1, double a2) {
@@ -35,6 +40,13 @@ static void generate_ticks(std::vector<Quote>& out, uint32_t n, uint32_t seed) {
     }
 }
 
+// ----- Per-tick hardware counters under each timed row ("PMU: n/a" without perf)
+static void print_counters(const PerfSample& counters, double ticks) {
+    std::ostringstream line;
+    PerfCounters::printPerOp(line, counters, ticks, "tick");
+    std::printf("%-18s  %s\n", "", line.str().c_str());
+}
+
 // ----- Benchmark harness
 template <typename F>
 static double run_bench(const char* name,
@@ -42,6 +54,8 @@ static double run_bench(const char* name,
                         F&& func,
                         int iters)
 {
+    PerfCounters pmu;
+    pmu.start();
     Timer t; t.start();
     volatile double sink = 0.0; // prevent DCE
 
@@ -53,7 +67,45 @@ static double run_bench(const char* name,
     }
 
     double ns = t.stop_ns();
+    const PerfSample counters = pmu.stop();
     std::printf("%-18s  time: %.3f ms  sink=%.6f\n", name, ns / 1e6, sink);
+    print_counters(counters, static_cast<double>(ticks.size()) * iters);
+    return ns;
+}
+
+// ----- Batch harness: SoA blocks of kBatch quotes through on_ticks()
+constexpr std::size_t kBatch = 1024;
+
+template <typename F>
+static double run_batch_bench(const char* name,
+                              const QuoteBlock& block,
+                              F&& func,
+                              int iters)
+{
+    std::vector<double> out(kBatch);
+    PerfCounters pmu;
+    pmu.start();
+    Timer t; t.start();
+    volatile double sink = 0.0; // prevent DCE
+
+    for (int r = 0; r < iters; ++r) {
+        for (std::size_t first = 0; first < block.size(); first += kBatch) {
+            const std::size_t n = std::min(kBatch, block.size() - first);
+            func(block.view(first, n), std::span<double>(out.data(), n));
+            // Four partial sums: consuming the block shouldn't serialize on one add chain
+            double acc[4] = {0.0, 0.0, 0.0, 0.0};
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+                for (int l = 0; l < 4; ++l) acc[l] += out[i + l] * 1e-9;
+            for (; i < n; ++i) acc[0] += out[i] * 1e-9;
+            sink = sink + ((acc[0] + acc[1]) + (acc[2] + acc[3]));
+        }
+    }
+
+    double ns = t.stop_ns();
+    const PerfSample counters = pmu.stop();
+    std::printf("%-18s  time: %.3f ms  sink=%.6f\n", name, ns / 1e6, sink);
+    print_counters(counters, static_cast<double>(block.size()) * iters);
     return ns;
 }
 
@@ -68,10 +120,22 @@ int main(int argc, char** argv) {
     if (argc > 1) n_ticks = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
     if (argc > 2) iters   = std::atoi(argv[2]);
 
+    // Calibrate once, then report the per-sample timer cost for this box
+    std::printf("Timer: %s (%.4f ns/tick), overhead %.1f ns/sample (chrono %.1f ns)\n",
+                TscClock::source(), TscClock::nsPerTick(),
+                timer_overhead_ns<Timer>(), timer_overhead_ns<ChronoTimer>());
+    {
+        PerfCounters probe;
+        PerfCounters::printInfo(std::cout, probe);
+    }
+
     std::cout << "Generating " << n_ticks << " ticks, iters=" << iters << "...\n";
     std::vector<Quote> ticks;
     generate_ticks(ticks, n_ticks, seed);
 
+    // SoA copy for the batch kernels (built outside the timed region)
+    const QuoteBlock block(ticks);
+
     // Baseline (free function)
     auto ns_free = run_bench(
         "free_function", ticks,
@@ -93,6 +157,26 @@ int main(int argc, char** argv) {
         [&](const Quote& q){ return crtp.on_tick(q); }, iters
     );
 
+    // CRTP batch API: SoA blocks through the widest SIMD kernel available
+    std::printf("SIMD kernel: %s\n", simd::isa_name(simd::active_isa()));
+    auto ns_simd = run_batch_bench(
+        "simd_batch", block,
+        [&](const QuoteBlockView& b, std::span<double> out){ crtp.on_ticks(b, out); }, iters
+    );
+
+    // The batch path must agree with the per-tick path (up to FMA rounding)
+    {
+        double max_diff = 0.0;
+        std::vector<double> out(kBatch);
+        for (std::size_t first = 0; first < block.size(); first += kBatch) {
+            const std::size_t n = std::min(kBatch, block.size() - first);
+            crtp.on_ticks(block.view(first, n), std::span<double>(out.data(), n));
+            for (std::size_t i = 0; i < n; ++i)
+                max_diff = std::max(max_diff, std::abs(out[i] - crtp.on_tick(ticks[first + i])));
+        }
+        std::printf("simd_batch max |diff| vs crtp_call: %.3g\n", max_diff);
+    }
+
     const double total_ops = static_cast<double>(n_ticks) * iters;
 
     auto report = [&](const char* name, double ns) {
@@ -106,7 +190,8 @@ int main(int argc, char** argv) {
     report("free_function", ns_free);
     report("virtual_call", ns_virtual);
     report("crtp_call", ns_crtp);
+    report("simd_batch", ns_simd);
 
-    std::puts("\nTip: on Linux use perf: cycles,instructions,branches,branch-misses");
+    std::puts("\nPer-row PMU lines attribute gaps to branch_misses vs cache/TLB misses (perf_event_open).");
     return 0;
 }
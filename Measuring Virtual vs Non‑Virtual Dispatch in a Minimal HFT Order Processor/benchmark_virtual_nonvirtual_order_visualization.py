@@ -41,7 +41,8 @@ def create_chart(csv_file='results.csv', output_image='throughput_chart.png'):
     ax = median_throughput.plot(
         kind='bar',
         figsize=(12, 7),
-        color={'virtual': '#ff6347', 'non-virtual': '#4682b4'},
+        color={'virtual': '#ff6347', 'non-virtual': '#4682b4', 'type_sorted': '#3cb371',
+               'variant': '#daa520', 'jump_table': '#9370db', 'auto': '#708090'},
         edgecolor='black',
         width=0.8
     )
@@ -1,187 +1,17 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <cstdint>
 #include <string>
 #include <map>
 
-// 1. PROBLEM SPECIFICATION
+#include "../Build_and_Benchmark_HFT_System/include/PerfCounters.hpp"
 
-// Order struct with the exact specified layout
-struct Order {
-    uint64_t id;
-    int side;      // 0 or 1
-    int qty;
-    int price;
-    int payload[2];
-};
+#include "order_dispatch.hpp" // 1-4: orders, strategies, dispatch layer
 
-// Function to generate N random orders with a deterministic seed for reproducibility
-std::vector<Order> generate_random_orders(size_t n) {
-    constexpr unsigned int seed = 12345;
-    std::mt19937 rng(seed);
+using namespace order_dispatch;
 
-    std::uniform_int_distribution<int> side_dist(0, 1);
-    std::uniform_int_distribution<int> qty_dist(1, 1000);
-    std::uniform_int_distribution<int> price_dist(9900, 10100);
-    std::uniform_int_distribution<int> payload_dist(0, 5000);
-
-    std::vector<Order> orders;
-    orders.reserve(n);
-
-    for (size_t i = 0; i < n; ++i) {
-        orders.push_back(Order{
-            .id = i,
-            .side = side_dist(rng),
-            .qty = qty_dist(rng),
-            .price = price_dist(rng),
-            .payload = {payload_dist(rng), payload_dist(rng)}
-        });
-    }
-    
-    return orders;
-}
-
-// 2. VIRTUAL IMPLEMENTATION
-
-// Abstract base class
-class Processor {
-public:
-    virtual uint64_t process(const Order& order) = 0;
-    virtual ~Processor() = default;
-};
-
-// Derived class Strategy A (Virtual)
-class StrategyA_V : public Processor {
-public:
-    uint64_t process(const Order& order) override {
-        // Use static arrays to simulate a persistent order book in L1 cache
-        static uint64_t book_prices[64] = {0};
-        static int book_quantities[64] = {0};
-        static uint64_t side_counter[2] = {0};
-
-        // 6-10 integer arithmetic operations
-        uint64_t checksum = order.id * 7;
-        checksum += order.price;
-        checksum -= order.qty;
-        checksum ^= (order.price << 3);
-        checksum += order.payload[0];
-        checksum ^= order.payload[1];
-
-        // Two small, fixed-size memory writes
-        int index = order.id % 64;
-        book_prices[index] = order.price;
-        book_quantities[index] = order.qty;
-
-        // One small conditional branch
-        if (order.side == 0) {
-            side_counter[0]++;
-        } else {
-            side_counter[1]++;
-        }
-        
-        return checksum;
-    }
-};
-
-// Derived class Strategy B (Virtual)
-class StrategyB_V : public Processor {
-public:
-    uint64_t process(const Order& order) override {
-        static uint64_t book_prices[64] = {0};
-        static int book_quantities[64] = {0};
-        static uint64_t side_counter[2] = {0};
-
-        // Different but comparable work
-        uint64_t checksum = order.id * 11;
-        checksum ^= order.price;
-        checksum += order.qty;
-        checksum -= (order.qty << 2);
-        checksum ^= order.payload[1];
-        checksum += order.payload[0];
-
-        // Two small, fixed-size memory writes
-        int index = (order.id + 32) % 64; // Different access pattern
-        book_prices[index] = order.price + 1;
-        book_quantities[index] = order.qty - 1;
-
-        // One small conditional branch
-        if (order.side == 1) {
-            side_counter[1]++;
-        } else {
-            side_counter[0]++;
-        }
-        
-        return checksum;
-    }
-};
-
-
-// 3. NON-VIRTUAL IMPLEMENTATION
-
-// Concrete class Strategy A (Non-Virtual) - NO INHERITANCE
-class StrategyA_NV {
-public:
-    uint64_t run(const Order& order) {
-        // The work here MUST be IDENTICAL to StrategyA_V::process
-        static uint64_t book_prices[64] = {0};
-        static int book_quantities[64] = {0};
-        static uint64_t side_counter[2] = {0};
-
-        uint64_t checksum = order.id * 7;
-        checksum += order.price;
-        checksum -= order.qty;
-        checksum ^= (order.price << 3);
-        checksum += order.payload[0];
-        checksum ^= order.payload[1];
-
-        int index = order.id % 64;
-        book_prices[index] = order.price;
-        book_quantities[index] = order.qty;
-
-        if (order.side == 0) {
-            side_counter[0]++;
-        } else {
-            side_counter[1]++;
-        }
-        
-        return checksum;
-    }
-};
-
-// Concrete class Strategy B (Non-Virtual) - NO INHERITANCE
-class StrategyB_NV {
-public:
-    uint64_t run(const Order& order) {
-        // The work here MUST be IDENTICAL to StrategyB_V::process
-        static uint64_t book_prices[64] = {0};
-        static int book_quantities[64] = {0};
-        static uint64_t side_counter[2] = {0};
-
-        uint64_t checksum = order.id * 11;
-        checksum ^= order.price;
-        checksum += order.qty;
-        checksum -= (order.qty << 2);
-        checksum ^= order.payload[1];
-        checksum += order.payload[0];
-
-        int index = (order.id + 32) % 64;
-        book_prices[index] = order.price + 1;
-        book_quantities[index] = order.qty - 1;
-
-        if (order.side == 1) {
-            side_counter[1]++;
-        } else {
-            side_counter[0]++;
-        }
-        
-        return checksum;
-    }
-};
-
-
-// 4. MEASUREMENT HARNESS
+// 5. MEASUREMENT HARNESS
 
 int main() {
     // Setup
@@ -226,8 +56,14 @@ int main() {
     }
     std::cerr << "Warmup complete. Checksum: " << warmup_checksum << std::endl; // Change to cerr
 
+    // Hardware counters around every timed repeat (empty CSV fields without a PMU)
+    PerfCounters pmu;
+    PerfCounters::printInfo(std::cerr, pmu);
+
     // Print CSV header
-    std::cout << "\npattern,impl,repeat,orders,elapsed_ns,ops_per_sec,checksum" << std::endl;
+    std::cout << "\npattern,impl,repeat,orders,elapsed_ns,ops_per_sec,checksum";
+    PerfCounters::csvHeader(std::cout);
+    std::cout << std::endl;
 
     // Main benchmark loop
     for (const auto& pair : patterns) {
@@ -242,6 +78,7 @@ int main() {
         // VIRTUAL IMPLEMENTATION RUNS
         for (int r = 0; r < REPEATS; ++r) {
             volatile uint64_t total_checksum = 0; // The volatile sink
+            pmu.start();
             auto start = std::chrono::high_resolution_clock::now();
             
             for (size_t i = 0; i < N; ++i) {
@@ -249,15 +86,19 @@ int main() {
             }
 
             auto end = std::chrono::high_resolution_clock::now();
+            const PerfSample counters = pmu.stop();
             auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
             double ops_per_sec = (double)N / (elapsed_ns / 1e9);
             
-            std::cout << pattern_name << ",virtual," << r << "," << N << "," << elapsed_ns << "," << ops_per_sec << "," << total_checksum << std::endl;
+            std::cout << pattern_name << ",virtual," << r << "," << N << "," << elapsed_ns << "," << ops_per_sec << "," << total_checksum;
+            PerfCounters::csvFields(std::cout, counters, (double)N);
+            std::cout << std::endl;
         }
 
         // NON-VIRTUAL IMPLEMENTATION RUNS
         for (int r = 0; r < REPEATS; ++r) {
             volatile uint64_t total_checksum = 0; // The volatile sink
+            pmu.start();
             auto start = std::chrono::high_resolution_clock::now();
 
             for (size_t i = 0; i < N; ++i) {
@@ -269,11 +110,38 @@ int main() {
             }
             
             auto end = std::chrono::high_resolution_clock::now();
+            const PerfSample counters = pmu.stop();
             auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
             double ops_per_sec = (double)N / (elapsed_ns / 1e9);
 
-            std::cout << pattern_name << ",non-virtual," << r << "," << N << "," << elapsed_ns << "," << ops_per_sec << "," << total_checksum << std::endl;
+            std::cout << pattern_name << ",non-virtual," << r << "," << N << "," << elapsed_ns << "," << ops_per_sec << "," << total_checksum;
+            PerfCounters::csvFields(std::cout, counters, (double)N);
+            std::cout << std::endl;
+        }
+
+        // DEVIRTUALIZED DISPATCH MODES, then the mode calibrate() picks for this mix
+        OrderDispatcher dispatcher;
+        auto run_dispatch = [&](const std::string& impl, auto&& body) {
+            for (int r = 0; r < REPEATS; ++r) {
+                pmu.start();
+                auto start = std::chrono::high_resolution_clock::now();
+                volatile uint64_t total_checksum = body();
+                auto end = std::chrono::high_resolution_clock::now();
+                const PerfSample counters = pmu.stop();
+                auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                double ops_per_sec = (double)N / (elapsed_ns / 1e9);
+                std::cout << pattern_name << "," << impl << "," << r << "," << N << "," << elapsed_ns << "," << ops_per_sec << "," << total_checksum;
+                PerfCounters::csvFields(std::cout, counters, (double)N);
+                std::cout << std::endl;
+            }
+        };
+        for (DispatchMode mode : kDispatchModes) {
+            if (mode == DispatchMode::Branch) continue; // same loop as non-virtual above
+            run_dispatch(dispatch_mode_name(mode), [&] { return dispatcher.dispatch(mode, orders, assignments); });
         }
+        const DispatchMode picked = dispatcher.calibrate(orders, assignments);
+        std::cerr << pattern_name << ": auto dispatch picked " << dispatch_mode_name(picked) << std::endl;
+        run_dispatch("auto", [&] { return dispatcher.dispatch_auto(orders, assignments); });
     }
 
     return 0;
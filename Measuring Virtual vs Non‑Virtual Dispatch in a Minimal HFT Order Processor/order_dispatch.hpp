@@ -0,0 +1,320 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <variant>
+#include <vector>
+
+// Order model, strategies and dispatch layer of the virtual vs non-virtual
+// experiment. Shared by hft_assignment.cpp and the unified benchmark suite
+// (Build_and_Benchmark_HFT_System/test/Bench_dispatch.cpp); namespaced so it
+// can link next to the matching engine's own Order type.
+namespace order_dispatch {
+
+// 1. PROBLEM SPECIFICATION
+
+// Order struct with the exact specified layout
+struct Order {
+    uint64_t id;
+    int side;      // 0 or 1
+    int qty;
+    int price;
+    int payload[2];
+};
+
+// Function to generate N random orders with a deterministic seed for reproducibility
+inline std::vector<Order> generate_random_orders(size_t n) {
+    constexpr unsigned int seed = 12345;
+    std::mt19937 rng(seed);
+
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> qty_dist(1, 1000);
+    std::uniform_int_distribution<int> price_dist(9900, 10100);
+    std::uniform_int_distribution<int> payload_dist(0, 5000);
+
+    std::vector<Order> orders;
+    orders.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        orders.push_back(Order{
+            .id = i,
+            .side = side_dist(rng),
+            .qty = qty_dist(rng),
+            .price = price_dist(rng),
+            .payload = {payload_dist(rng), payload_dist(rng)}
+        });
+    }
+    
+    return orders;
+}
+
+// 2. VIRTUAL IMPLEMENTATION
+
+// Abstract base class
+class Processor {
+public:
+    virtual uint64_t process(const Order& order) = 0;
+    virtual ~Processor() = default;
+};
+
+// Derived class Strategy A (Virtual)
+class StrategyA_V : public Processor {
+public:
+    uint64_t process(const Order& order) override {
+        // Use static arrays to simulate a persistent order book in L1 cache
+        static uint64_t book_prices[64] = {0};
+        static int book_quantities[64] = {0};
+        static uint64_t side_counter[2] = {0};
+
+        // 6-10 integer arithmetic operations
+        uint64_t checksum = order.id * 7;
+        checksum += order.price;
+        checksum -= order.qty;
+        checksum ^= (order.price << 3);
+        checksum += order.payload[0];
+        checksum ^= order.payload[1];
+
+        // Two small, fixed-size memory writes
+        int index = order.id % 64;
+        book_prices[index] = order.price;
+        book_quantities[index] = order.qty;
+
+        // One small conditional branch
+        if (order.side == 0) {
+            side_counter[0]++;
+        } else {
+            side_counter[1]++;
+        }
+        
+        return checksum;
+    }
+};
+
+// Derived class Strategy B (Virtual)
+class StrategyB_V : public Processor {
+public:
+    uint64_t process(const Order& order) override {
+        static uint64_t book_prices[64] = {0};
+        static int book_quantities[64] = {0};
+        static uint64_t side_counter[2] = {0};
+
+        // Different but comparable work
+        uint64_t checksum = order.id * 11;
+        checksum ^= order.price;
+        checksum += order.qty;
+        checksum -= (order.qty << 2);
+        checksum ^= order.payload[1];
+        checksum += order.payload[0];
+
+        // Two small, fixed-size memory writes
+        int index = (order.id + 32) % 64; // Different access pattern
+        book_prices[index] = order.price + 1;
+        book_quantities[index] = order.qty - 1;
+
+        // One small conditional branch
+        if (order.side == 1) {
+            side_counter[1]++;
+        } else {
+            side_counter[0]++;
+        }
+        
+        return checksum;
+    }
+};
+
+
+// 3. NON-VIRTUAL IMPLEMENTATION
+
+// Concrete class Strategy A (Non-Virtual) - NO INHERITANCE
+class StrategyA_NV {
+public:
+    uint64_t run(const Order& order) {
+        // The work here MUST be IDENTICAL to StrategyA_V::process
+        static uint64_t book_prices[64] = {0};
+        static int book_quantities[64] = {0};
+        static uint64_t side_counter[2] = {0};
+
+        uint64_t checksum = order.id * 7;
+        checksum += order.price;
+        checksum -= order.qty;
+        checksum ^= (order.price << 3);
+        checksum += order.payload[0];
+        checksum ^= order.payload[1];
+
+        int index = order.id % 64;
+        book_prices[index] = order.price;
+        book_quantities[index] = order.qty;
+
+        if (order.side == 0) {
+            side_counter[0]++;
+        } else {
+            side_counter[1]++;
+        }
+        
+        return checksum;
+    }
+};
+
+// Concrete class Strategy B (Non-Virtual) - NO INHERITANCE
+class StrategyB_NV {
+public:
+    uint64_t run(const Order& order) {
+        // The work here MUST be IDENTICAL to StrategyB_V::process
+        static uint64_t book_prices[64] = {0};
+        static int book_quantities[64] = {0};
+        static uint64_t side_counter[2] = {0};
+
+        uint64_t checksum = order.id * 11;
+        checksum ^= order.price;
+        checksum += order.qty;
+        checksum -= (order.qty << 2);
+        checksum ^= order.payload[1];
+        checksum += order.payload[0];
+
+        int index = (order.id + 32) % 64;
+        book_prices[index] = order.price + 1;
+        book_quantities[index] = order.qty - 1;
+
+        if (order.side == 1) {
+            side_counter[1]++;
+        } else {
+            side_counter[0]++;
+        }
+        
+        return checksum;
+    }
+};
+
+
+// 4. DEVIRTUALIZED DISPATCH LAYER
+
+// Takes a mixed order stream (orders[i] goes to strategy assignments[i]) and
+// processes it without virtual calls, in one of several modes:
+//   branch      - if/else per order (the non-virtual baseline above)
+//   type_sorted - bucket order indices by strategy type first, then run each
+//                 strategy over its own batch: the per-order branch becomes a
+//                 branch-free bucket store and every batch is homogeneous
+//   variant     - std::variant<StrategyA_NV, StrategyB_NV> per type + std::visit
+//   jump_table  - function-pointer table indexed by strategy type
+// The dispatcher owns its strategies and fixed scratch buffers; dispatching
+// never allocates.
+enum class DispatchMode { Branch, TypeSorted, Variant, JumpTable };
+
+inline const char* dispatch_mode_name(DispatchMode m) {
+    switch (m) {
+    case DispatchMode::Branch:     return "branch";
+    case DispatchMode::TypeSorted: return "type_sorted";
+    case DispatchMode::Variant:    return "variant";
+    case DispatchMode::JumpTable:  return "jump_table";
+    }
+    return "?";
+}
+
+constexpr DispatchMode kDispatchModes[] = {
+    DispatchMode::Branch, DispatchMode::TypeSorted, DispatchMode::Variant, DispatchMode::JumpTable};
+
+class OrderDispatcher {
+public:
+    static constexpr int kTypes = 2; // 0 = StrategyA, 1 = StrategyB
+    static constexpr size_t kSortBlock = 256;
+
+    using StrategyVariant = std::variant<StrategyA_NV, StrategyB_NV>;
+
+    // Sum of the strategies' checksums over the stream
+    uint64_t dispatch(DispatchMode mode, const std::vector<Order>& orders,
+                      const std::vector<int>& assignments) {
+        switch (mode) {
+        case DispatchMode::Branch:     return run_branch(orders, assignments);
+        case DispatchMode::TypeSorted: return run_type_sorted(orders, assignments);
+        case DispatchMode::Variant:    return run_variant(orders, assignments);
+        case DispatchMode::JumpTable:  return run_jump_table(orders, assignments);
+        }
+        return 0;
+    }
+
+    // Time every mode on the first `sample` orders of the observed stream
+    // (best of `trials`) and keep the fastest; dispatch_auto() then uses it.
+    DispatchMode calibrate(const std::vector<Order>& orders, const std::vector<int>& assignments,
+                           size_t sample = 65536, int trials = 3) {
+        sample = std::min(sample, orders.size());
+        const std::vector<Order> sample_orders(orders.begin(), orders.begin() + sample);
+        const std::vector<int> sample_types(assignments.begin(), assignments.begin() + sample);
+
+        long long best_ns = -1;
+        for (DispatchMode mode : kDispatchModes) {
+            long long mode_ns = -1;
+            for (int t = 0; t < trials; ++t) {
+                auto start = std::chrono::high_resolution_clock::now();
+                volatile uint64_t sink = dispatch(mode, sample_orders, sample_types);
+                (void)sink;
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+                if (mode_ns < 0 || ns < mode_ns) mode_ns = ns;
+            }
+            if (best_ns < 0 || mode_ns < best_ns) {
+                best_ns = mode_ns;
+                chosen_ = mode;
+            }
+        }
+        return chosen_;
+    }
+
+    uint64_t dispatch_auto(const std::vector<Order>& orders, const std::vector<int>& assignments) {
+        return dispatch(chosen_, orders, assignments);
+    }
+
+    DispatchMode chosen() const { return chosen_; }
+
+private:
+    using RunFn = uint64_t (*)(OrderDispatcher&, const Order&);
+
+    static uint64_t run_a(OrderDispatcher& d, const Order& o) { return d.a_.run(o); }
+    static uint64_t run_b(OrderDispatcher& d, const Order& o) { return d.b_.run(o); }
+
+    uint64_t run_branch(const std::vector<Order>& orders, const std::vector<int>& assignments) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < orders.size(); ++i)
+            sum += (assignments[i] == 0) ? a_.run(orders[i]) : b_.run(orders[i]);
+        return sum;
+    }
+
+    // Sorted in blocks of kSortBlock orders so both the index buckets and the
+    // orders being gathered stay in L1
+    uint64_t run_type_sorted(const std::vector<Order>& orders, const std::vector<int>& assignments) {
+        uint64_t sum = 0;
+        for (size_t first = 0; first < orders.size(); first += kSortBlock) {
+            const size_t last = std::min(first + kSortBlock, orders.size());
+            size_t counts[kTypes] = {0, 0};
+            for (size_t i = first; i < last; ++i) {
+                const int t = assignments[i];
+                buckets_[t][counts[t]++] = static_cast<uint32_t>(i); // store, no branch
+            }
+            for (size_t k = 0; k < counts[0]; ++k) sum += a_.run(orders[buckets_[0][k]]);
+            for (size_t k = 0; k < counts[1]; ++k) sum += b_.run(orders[buckets_[1][k]]);
+        }
+        return sum;
+    }
+
+    uint64_t run_variant(const std::vector<Order>& orders, const std::vector<int>& assignments) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < orders.size(); ++i)
+            sum += std::visit([&](auto& s) { return s.run(orders[i]); }, variants_[assignments[i]]);
+        return sum;
+    }
+
+    uint64_t run_jump_table(const std::vector<Order>& orders, const std::vector<int>& assignments) {
+        static constexpr RunFn table[kTypes] = {&run_a, &run_b};
+        uint64_t sum = 0;
+        for (size_t i = 0; i < orders.size(); ++i) sum += table[assignments[i]](*this, orders[i]);
+        return sum;
+    }
+
+    StrategyA_NV a_;
+    StrategyB_NV b_;
+    StrategyVariant variants_[kTypes] = {StrategyA_NV{}, StrategyB_NV{}};
+    uint32_t buckets_[kTypes][kSortBlock]; // order indices per strategy type, one block
+    DispatchMode chosen_ = DispatchMode::Branch;
+};
+
+} // namespace order_dispatch
@@ -1,11 +1,45 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
-#include <unordered_map>
 #include <fstream>
 #include <algorithm>
+#include <memory>
 #include <cmath>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+#include "../Build_and_Benchmark_HFT_System/include/BlockGenerator.hpp"
+#include "../Build_and_Benchmark_HFT_System/include/LatencyHistogram.hpp"
+#include "../Build_and_Benchmark_HFT_System/include/TickFile.hpp"
+
+// Branch and code-placement hints (plain code where the builtins are unavailable)
+#if defined(__GNUC__) || defined(__clang__)
+#define HFT_LIKELY(x)   __builtin_expect(!!(x), 1)
+#define HFT_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define HFT_COLD        __attribute__((noinline, cold))
+#elif defined(_MSC_VER)
+#define HFT_LIKELY(x)   (x)
+#define HFT_UNLIKELY(x) (x)
+#define HFT_COLD        __declspec(noinline)
+#else
+#define HFT_LIKELY(x)   (x)
+#define HFT_UNLIKELY(x) (x)
+#define HFT_COLD
+#endif
+
+// Write-intent prefetch hint (no-op where the builtin is unavailable)
+inline void prefetchLine(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 1);
+#else
+    (void)p;
+#endif
+}
 
 struct alignas(64) MarketData {
     int instrument_id; // instruments assigned by an integer id for each instance, not for each type
@@ -20,61 +54,448 @@ struct alignas(64) Order {
     std::chrono::high_resolution_clock::time_point timestamp;
 };
 
+/// Tick without the cache-line padding: 24 bytes instead of 64, so a line
+/// carries 2.67 ticks and the feed needs 2.7x less memory bandwidth.
+/// Field names match MarketData, so signals and the pipelined loop take either.
+struct PackedTick {
+    std::int64_t timestamp_ns; // high_resolution_clock ns since epoch
+    double price;
+    std::int32_t instrument_id;
+};
+static_assert(sizeof(PackedTick) == 24, "PackedTick must stay unpadded");
+
+// Converted outside any timed region
+inline std::vector<PackedTick> packTicks(const MarketData* ticks, std::size_t count) {
+    std::vector<PackedTick> out(count);
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = PackedTick{std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                ticks[i].timestamp.time_since_epoch()).count(),
+                            ticks[i].price, ticks[i].instrument_id};
+    return out;
+}
+
+/// Preallocated order sink. A tick places at most one order, so capacity =
+/// ticks per run and emit() is a store, an increment and one never-taken
+/// branch: a caller that under-reserves doubles the buffer on a cold path
+/// instead of writing past it. The slots are written once up front, so
+/// their pages are faulted in before the run.
+class OrderBuffer {
+public:
+    explicit OrderBuffer(std::size_t capacity = 0) { reserve(capacity); }
+
+    void reserve(std::size_t capacity) {
+        if (capacity <= cap) return;
+        std::unique_ptr<Order[]> grown(new Order[capacity]());
+        std::copy(slots.get(), slots.get() + n, grown.get());
+        slots = std::move(grown);
+        cap = capacity;
+    }
+
+    Order& emit() {
+        if (HFT_UNLIKELY(n == cap)) grow();
+        return slots[n++];
+    }
+    void clear() { n = 0; }
+
+    Order& operator[](std::size_t i) { return slots[i]; }
+    const Order* begin() const { return slots.get(); }
+    const Order* end() const { return slots.get() + n; }
+    std::size_t size() const { return n; }
+    std::size_t capacity() const { return cap; }
+
+private:
+    // Out of line so the hot emit() stays a store and an increment
+    HFT_COLD void grow() { reserve(cap ? 2 * cap : 64); }
+
+    std::unique_ptr<Order[]> slots;
+    std::size_t n = 0;
+    std::size_t cap = 0;
+};
+
 class MarketDataFeed {
 public:
-    MarketDataFeed(std::vector<MarketData>& ref) : data(ref) {}
-
-    void generateData(int num_ticks) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> price_dist(100.0, 200.0);
-
-        data.reserve(num_ticks); // preallocate memory contiguously
-        for (int i = 0; i < num_ticks; ++i) {
-            MarketData md;
-            md.instrument_id = i % 10;
-            md.price = price_dist(gen);
-            md.timestamp = std::chrono::high_resolution_clock::now();
-            data.push_back(md);
-        }
+    MarketDataFeed(std::vector<MarketData>& ref, int num_instruments = 10)
+        : data(ref), instruments(num_instruments) {}
+
+    // Fixed default seed: every run (and every capture) sees the same prices.
+    // Blocks of ticks are generated in parallel, each from its own XorShift32
+    // stream (BlockGenerator.hpp), so the feed is the same for any thread
+    // count (0: one per hardware thread). Timestamps advance 100 ns per tick
+    // from one clock read, so no clock is read per tick either.
+    void generateData(int num_ticks, std::uint32_t seed = 20250920, unsigned threads = 0) {
+        constexpr std::size_t kBlock = std::size_t{1} << 16;
+        const std::size_t n = static_cast<std::size_t>(num_ticks);
+        const auto t0 = std::chrono::high_resolution_clock::now();
+
+        data.clear();
+        data.resize(n); // preallocate memory contiguously
+        runBlocks((n + kBlock - 1) / kBlock, threads, [&](std::size_t b) {
+            XorShift32 rng = XorShift32::stream(seed, b);
+            const std::size_t end = std::min(n, (b + 1) * kBlock);
+            for (std::size_t i = b * kBlock; i < end; ++i) {
+                MarketData& md = data[i];
+                md.instrument_id = static_cast<int>(i % static_cast<std::size_t>(instruments));
+                md.price = rng.uniform(100.0, 200.0);
+                md.timestamp = t0 + std::chrono::nanoseconds(100 * i);
+            }
+        });
     }
 
 private:
     std::vector<MarketData>& data;
+    int instruments;
+};
+
+/// Last `capacity` prices of one instrument in a fixed ring buffer, with the
+/// mean and population variance kept incrementally (Welford's update, adjusted
+/// for the price that drops out of a full window). push() and every statistic
+/// are O(1), so the window length no longer scales the per-tick cost.
+/// The price slots live in storage owned by the instrument table, so every
+/// instrument's window is one slice of a single contiguous array.
+class RollingWindow {
+public:
+    RollingWindow() = default;
+    RollingWindow(double* storage, std::uint32_t capacity) : buf(storage), cap(capacity) {}
+
+    void push(double x) {
+        if (count < cap) {
+            ++count;
+            const double delta = x - avg;
+            avg += delta / count;
+            m2 += delta * (x - avg);
+        } else {
+            const double old = buf[head];
+            const double old_avg = avg;
+            avg += (x - old) / count;
+            m2 += (x - old) * (x - avg + old - old_avg);
+            if (m2 < 0.0) m2 = 0.0; // rounding can push a flat window slightly negative
+        }
+        buf[head] = x;
+        head = (head + 1 == cap) ? 0 : head + 1;
+    }
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return cap; }
+    double mean() const { return avg; }
+    double variance() const { return count ? m2 / count : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+
+    // k-th most recent price (0 = latest); requires k < size()
+    double back(std::size_t k = 0) const {
+        const std::size_t i = head + cap - 1 - k;
+        return buf[i >= cap ? i - cap : i];
+    }
+
+    // Visit prices oldest to newest
+    template <typename F>
+    void forEach(F&& f) const {
+        for (std::size_t k = count; k-- > 0;) f(back(k));
+    }
+
+private:
+    friend class InstrumentColumns;
+    friend class InstrumentSlots;
+
+    double* buf = nullptr;
+    std::uint32_t cap = 0;
+    std::uint32_t head = 0;  // next slot to write
+    std::uint32_t count = 0;
+    double avg = 0.0;
+    double m2 = 0.0;         // sum of squared deviations from avg
+};
+
+constexpr std::size_t kSignals = 4;
+
+// --- Per-instrument state, indexed by instrument id ------------------------
+// Both layouts are sized once from the instrument universe and indexed
+// directly by id: no hashing or allocation per tick. Ids must be < size().
+// Same interface; pick one with SIGNAL_STATE_SOA (see InstrumentStates).
+
+/// Array of structs: one cache line per instrument holds its window header,
+/// running stats and signal counters, so a tick touches that line plus the
+/// price slot it writes.
+class InstrumentSlots {
+public:
+    struct alignas(64) Slot {
+        RollingWindow window;
+        std::uint32_t hits[kSignals] = {}; // signal trigger counts
+    };
+    static_assert(sizeof(Slot) == 64, "one instrument per cache line");
+
+    InstrumentSlots(std::size_t instruments, std::size_t window)
+        : prices(instruments * window), slots(instruments) {
+        for (std::size_t id = 0; id < instruments; ++id)
+            slots[id].window = RollingWindow(&prices[id * window], static_cast<std::uint32_t>(window));
+    }
+
+    const RollingWindow& push(int id, double price) {
+        RollingWindow& w = slots[id].window;
+        w.push(price);
+        return w;
+    }
+    const RollingWindow& window(int id) const { return slots[id].window; }
+    void hit(int id, std::size_t signal) { ++slots[id].hits[signal]; }
+
+    // Pipelined loop: the slot line early, then (once it is cached) the price
+    // slot the next push() writes and back(1..2) read
+    void prefetch(int id) const { prefetchLine(&slots[id]); }
+    void prefetchWindow(int id) const {
+        const RollingWindow& w = slots[id].window;
+        prefetchLine(&prices[static_cast<std::size_t>(id) * w.capacity() + w.head]);
+    }
+    std::uint64_t hits(std::size_t signal) const {
+        std::uint64_t n = 0;
+        for (const Slot& s : slots) n += s.hits[signal];
+        return n;
+    }
+    std::size_t size() const { return slots.size(); }
+
+private:
+    std::vector<double> prices; // instruments x window
+    std::vector<Slot> slots;
+};
+
+/// Structure of arrays: each field is its own dense column. A pass that reads
+/// one field across many instruments (e.g. every mean) streams a single
+/// array instead of striding over whole slots.
+class InstrumentColumns {
+public:
+    InstrumentColumns(std::size_t instruments, std::size_t window)
+        : cap(static_cast<std::uint32_t>(window)), prices(instruments * window),
+          heads(instruments), counts(instruments), avgs(instruments), m2s(instruments) {
+        for (auto& column : hit_columns) column.assign(instruments, 0);
+    }
+
+    // Returns a snapshot view of the updated window (its prices stay live)
+    RollingWindow push(int id, double price) {
+        RollingWindow w = window(id);
+        w.push(price);
+        heads[id] = w.head;
+        counts[id] = w.count;
+        avgs[id] = w.avg;
+        m2s[id] = w.m2;
+        return w;
+    }
+    RollingWindow window(int id) const {
+        RollingWindow w(const_cast<double*>(&prices[static_cast<std::size_t>(id) * cap]), cap);
+        w.head = heads[id];
+        w.count = counts[id];
+        w.avg = avgs[id];
+        w.m2 = m2s[id];
+        return w;
+    }
+    void hit(int id, std::size_t signal) { ++hit_columns[signal][id]; }
+
+    // One line per column for the id, then the price slot push() writes
+    void prefetch(int id) const {
+        prefetchLine(&heads[id]);
+        prefetchLine(&counts[id]);
+        prefetchLine(&avgs[id]);
+        prefetchLine(&m2s[id]);
+    }
+    void prefetchWindow(int id) const {
+        prefetchLine(&prices[static_cast<std::size_t>(id) * cap + heads[id]]);
+    }
+    std::uint64_t hits(std::size_t signal) const {
+        std::uint64_t n = 0;
+        for (std::uint32_t h : hit_columns[signal]) n += h;
+        return n;
+    }
+    std::size_t size() const { return heads.size(); }
+
+private:
+    std::uint32_t cap;
+    std::vector<double> prices; // instruments x window
+    std::vector<std::uint32_t> heads, counts;
+    std::vector<double> avgs, m2s;
+    std::vector<std::uint32_t> hit_columns[kSignals];
+};
+
+#ifdef SIGNAL_STATE_SOA
+using InstrumentStates = InstrumentColumns;
+#else
+using InstrumentStates = InstrumentSlots;
+#endif
+
+// --- Signal components -------------------------------------------------------
+// A component is any type with
+//   unsigned operator()(const MarketData&, const RollingWindow&) const
+// returning a mask of kBuy / kSell votes (kNone when it doesn't fire).
+// Pipeline<...> ORs the votes of all its components; buy wins a tie, which
+// is how the hand-written TradeEngine::onTick combines signal1..signal4.
+
+enum Vote : unsigned { kNone = 0, kBuy = 1, kSell = 2 };
+
+// Signal 1: absolute price outlier
+struct Threshold {
+    double low = 105.0, high = 195.0;
+    unsigned operator()(const MarketData& tick, const RollingWindow&) const {
+        return (tick.price < low || tick.price > high) ? kBuy : kNone;
+    }
+};
+
+// Signal 2: more than `band` away from the average; trade back towards it
+struct MeanRevert {
+    double band = 0.02;
+    std::size_t min_samples = 5;
+    unsigned operator()(const MarketData& tick, const RollingWindow& hist) const {
+        if (hist.size() < min_samples) return kNone;
+        const double avg = hist.mean();
+        if (tick.price >= avg * (1.0 - band) && tick.price <= avg * (1.0 + band)) return kNone;
+        return tick.price < avg ? kBuy : kSell;
+    }
+};
+
+// Signal 3: two consecutive up-moves
+struct Momentum {
+    unsigned operator()(const MarketData&, const RollingWindow& hist) const {
+        if (hist.size() < 3) return kNone;
+        const double diff1 = hist.back(1) - hist.back(2);
+        const double diff2 = hist.back(0) - hist.back(1);
+        return (diff1 > 0 && diff2 > 0) ? kBuy : kNone;
+    }
 };
 
+// Signal 4: below average while volatility is high
+struct VolBreakout {
+    double discount = 0.01, vol_ratio = 0.02;
+    std::size_t min_samples = 5;
+    unsigned operator()(const MarketData& tick, const RollingWindow& hist) const {
+        if (hist.size() < min_samples) return kNone;
+        const double avg = hist.mean();
+        return (tick.price < avg * (1.0 - discount) && hist.stddev() > avg * vol_ratio) ? kBuy : kNone;
+    }
+};
+
+/// Strategy composed at compile time from signal components. Evaluation is a
+/// fold over a std::tuple: every call is static and inlinable, so adding or
+/// reordering components costs no dispatch. on_hit(index) is called for each
+/// component that fires; pass a no-op to compile the counting away.
+template <typename... Signals>
+class Pipeline {
+public:
+    static constexpr std::size_t size = sizeof...(Signals);
+
+    Pipeline() = default;
+    explicit Pipeline(Signals... s) : signals(s...) {}
+
+    template <typename OnHit>
+    unsigned operator()(const MarketData& tick, const RollingWindow& hist, OnHit&& on_hit) const {
+        return evaluate(tick, hist, on_hit, std::index_sequence_for<Signals...>{});
+    }
+
+private:
+    template <typename OnHit, std::size_t... I>
+    unsigned evaluate(const MarketData& tick, const RollingWindow& hist, OnHit& on_hit,
+                      std::index_sequence<I...>) const {
+        unsigned votes = kNone;
+        ((votes |= vote<I>(tick, hist, on_hit)), ...);
+        return votes;
+    }
+
+    template <std::size_t I, typename OnHit>
+    unsigned vote(const MarketData& tick, const RollingWindow& hist, OnHit& on_hit) const {
+        const unsigned v = std::get<I>(signals)(tick, hist);
+        if (v != kNone) on_hit(I);
+        return v;
+    }
+
+    std::tuple<Signals...> signals;
+};
+
+// Same decisions as TradeEngine::onTick's signal1..signal4
+using DefaultPipeline = Pipeline<Threshold, MeanRevert, Momentum, VolBreakout>;
+
 class TradeEngine {
 public:
-    TradeEngine(const std::vector<MarketData>& feed)
-        : market_data(feed) {}
-
-    void process() {
-        for (const auto& tick : market_data) {
-            updateHistory(tick);
-            bool buy = false, sell = false;
-
-            if (signal1(tick)) { buy = true; counter1++; }
-            if (signal2(tick)) {
-                counter2++;
-                if (tick.price < getAvg(tick.instrument_id)) {
-                    buy = true;
-                } else {
-                    sell = true;
+    TradeEngine(const std::vector<MarketData>& feed, std::size_t window = 10, std::size_t instruments = 10)
+        : TradeEngine(feed.data(), feed.size(), window, instruments) {}
+
+    // Any contiguous tick range, e.g. a MappedTickFile replayed in place.
+    // `window` is the number of recent prices each signal looks at;
+    // instrument ids must lie in [0, instruments).
+    TradeEngine(const MarketData* ticks, std::size_t count, std::size_t window = 10,
+                std::size_t instruments = 10)
+        : market_data(ticks), num_ticks(count), window_length(window), orders(count),
+          states(instruments, window) {}
+
+    // Tick-to-trade latency is measured from each tick's hand-off to onTick(),
+    // as on the replay path: generated timestamps are synthetic (t0 + 100 ns
+    // per tick), so latency from them would grow with the tick index
+    void process() { process(market_data, num_ticks); }
+
+    // Any further range through the same state (e.g. the next chunk of a long
+    // run); reserveOrders() for it first
+    void process(const MarketData* ticks, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) onTick(ticks[i], std::chrono::high_resolution_clock::now());
+    }
+
+    // One tick; latency is measured from `received` (replay stamps arrival time)
+    void onTick(const MarketData& tick, std::chrono::high_resolution_clock::time_point received) {
+        const unsigned votes = decide(tick);
+        if (votes != kNone) placeOrder(tick, (votes & kBuy) != 0, received);
+    }
+
+    // Software-pipelined process(): step i reads tick i + Lookahead's id and
+    // prefetches its state slot, prefetches the window slot tick
+    // i + Lookahead/2 will write (its slot line is cached by then), and
+    // evaluates tick i. Two clock reads per kEmitBatch ticks: the batch's
+    // hand-off time is stamped on its orders as they're emitted, and at the
+    // end of the batch their send time replaces it and their latencies are
+    // recorded, so latency spans the whole batch (an upper bound). Same
+    // orders and signal counts as process().
+    // TickT: MarketData or PackedTick.
+    template <std::size_t Lookahead = 16, typename TickT>
+    void processPipelined(const TickT* ticks, std::size_t count) {
+        static_assert(Lookahead >= 2, "need a decode and a prefetch stage");
+        for (std::size_t base = 0; base < count; base += kEmitBatch) {
+            const std::size_t end = std::min(count, base + kEmitBatch);
+            const std::size_t first_order = orders.size();
+            const auto handed_off = std::chrono::high_resolution_clock::now();
+            for (std::size_t i = base; i < end; ++i) {
+                if (i + Lookahead < count) states.prefetch(ticks[i + Lookahead].instrument_id);
+                if (i + Lookahead / 2 < count) states.prefetchWindow(ticks[i + Lookahead / 2].instrument_id);
+                const TickT& tick = ticks[i];
+                const unsigned votes = decide(tick);
+                if (votes != kNone) {
+                    const bool buy = (votes & kBuy) != 0;
+                    orders.emit() = Order{tick.instrument_id, tick.price + (buy ? 0.01 : -0.01), buy, handed_off};
                 }
             }
-            if (signal3(tick)) { buy = true; counter3++; }
-            if (signal4(tick)) { buy = true; counter4++; } 
-
-            if (buy || sell) {
-                auto now = std::chrono::high_resolution_clock::now();
-                Order o{ tick.instrument_id, tick.price + (buy ? 0.01 : -0.01), buy, now };
-                orders.push_back(o);
-                auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - tick.timestamp).count();
-                latencies.push_back(latency);
-            }
+            stampOrders(first_order);
+        }
+    }
+
+    template <std::size_t Lookahead = 16>
+    void processPipelined() { processPipelined<Lookahead>(market_data, num_ticks); }
+
+    // Order slots for `count` more ticks (chunked runs); clearOrders() hands
+    // the buffer back once the caller is done with the orders
+    void reserveOrders(std::size_t count) { orders.reserve(orders.size() + count); }
+    void clearOrders() { orders.clear(); }
+
+    // Same loop as process() with the signals supplied by a composed Pipeline.
+    // CountSignals = false leaves no counter updates on the hot path.
+    template <bool CountSignals = false, typename PipelineT>
+    void processPipeline(const PipelineT& pipeline) {
+        if constexpr (CountSignals) pipeline_hits.assign(PipelineT::size, 0);
+        for (std::size_t i = 0; i < num_ticks; ++i) {
+            const MarketData& tick = market_data[i];
+            const auto received = std::chrono::high_resolution_clock::now(); // as process()
+            ++ticks_processed;
+            const auto& hist = states.push(tick.instrument_id, tick.price);
+            const unsigned votes = pipeline(tick, hist, [this](std::size_t k) {
+                if constexpr (CountSignals) ++pipeline_hits[k];
+                else (void)k;
+            });
+            if (votes != kNone) placeOrder(tick, (votes & kBuy) != 0, received);
         }
     }
 
+    std::size_t ordersPlaced() const { return orders_emitted; }
+    std::size_t ticksProcessed() const { return ticks_processed; }
+    std::uint64_t signalHits(std::size_t k) const { return states.hits(k); }
+
     void exportOrderHistoryToCSV(const std::string& filename) {
         std::ofstream file(filename);
         file << "instrument_id,price,side,timestamp_ns\n";
@@ -93,93 +514,116 @@ public:
         std::ofstream file(filename);
         file << "timestamp_ns,price\n";
         
-        auto it = price_history.find(instrument_id);
-        if (it != price_history.end()) {
-            const auto& prices = it->second;
-            for (size_t i = 0; i < prices.size(); ++i) {
+        if (instrument_id >= 0 && static_cast<std::size_t>(instrument_id) < states.size()) {
+            size_t i = 0;
+            states.window(instrument_id).forEach([&](double price) {
                 // Simulate timestamps for visualization
-                auto fake_timestamp = std::chrono::nanoseconds(i * 1000000);
-                file << fake_timestamp.count() << "," << prices[i] << "\n";
-            }
+                auto fake_timestamp = std::chrono::nanoseconds(i++ * 1000000);
+                file << fake_timestamp.count() << "," << price << "\n";
+            });
         }
         std::cout << "Price visualization data for instrument " << instrument_id 
                   << " exported to " << filename << std::endl;
     }
 
     void reportStats() {
-        long long sum = 0, max_latency = 0;
-        for (auto l : latencies) {
-            sum += l;
-            if (l > max_latency) max_latency = l;
-        }
-
         std::cout << "\n--- Performance Report ---\n";
-        std::cout << "Total Market Ticks Processed: " << market_data.size() << "\n";
-        std::cout << "Total Orders Placed: " << orders.size() << "\n";
-        std::cout << "Average Tick-to-Trade Latency (ns): " << (latencies.empty() ? 0 : sum / latencies.size()) << "\n";
-        std::cout << "Maximum Tick-to-Trade Latency (ns): " << max_latency << "\n";
-        std::cout << "Signal 1 triggered: " << counter1 << " times\n";
-        std::cout << "Signal 2 triggered: " << counter2 << " times\n";
-        std::cout << "Signal 3 triggered: " << counter3 << " times\n";
-        std::cout << "Signal 4 triggered: " << counter4 << " times\n";
+        std::cout << "Total Market Ticks Processed: " << ticks_processed << "\n";
+        std::cout << "Total Orders Placed: " << orders_emitted << "\n";
+        std::cout << "Average Tick-to-Trade Latency (ns): " << static_cast<long long>(latencies.mean()) << "\n";
+        std::cout << "Maximum Tick-to-Trade Latency (ns): " << latencies.max() << "\n";
+        latencies.printSummary(std::cout, "Tick-to-Trade Latency (ns):");
+        std::cout << "Signal window (ticks): " << window_length << ", instruments: " << states.size() << "\n";
+        if (!pipeline_hits.empty()) {
+            for (std::size_t k = 0; k < pipeline_hits.size(); ++k)
+                std::cout << "Pipeline signal " << k + 1 << " triggered: " << pipeline_hits[k] << " times\n";
+            return;
+        }
+        for (std::size_t k = 0; k < kSignals; ++k)
+            std::cout << "Signal " << k + 1 << " triggered: " << states.hits(k) << " times\n";
     }
 
 private:
-    const std::vector<MarketData>& market_data;
-    std::vector<Order> orders;
-    std::vector<long long> latencies;
-    std::unordered_map<int, std::vector<double>> price_history; // dictionary of price history (vector) per instrument (single int)
-    int counter1 = 0, counter2 = 0, counter3 = 0, counter4 = 0;
+    static constexpr std::size_t kEmitBatch = 16; // ticks per send-time clock read (pipelined)
+
+    const MarketData* market_data;
+    std::size_t num_ticks;
+    std::size_t ticks_processed = 0;
+    std::size_t orders_emitted = 0; // across clearOrders()
+    std::size_t window_length;
+    OrderBuffer orders; // preallocated: one slot per tick
+    LatencyHistogram latencies; // fixed memory, no end-of-run sort
+    InstrumentStates states; // windows, stats and signal counters by instrument id
+    std::vector<std::uint64_t> pipeline_hits; // per component, processPipeline<true> only
+
+    // signal1..signal4 on one tick: updates its window and hit counters and
+    // returns the combined vote (buy wins a tie, kNone if nothing fired)
+    template <typename TickT>
+    unsigned decide(const TickT& tick) {
+        ++ticks_processed;
+        const int id = tick.instrument_id;
+        const auto& hist = states.push(id, tick.price);
+        bool buy = false, sell = false;
+
+        if (signal1(tick)) { buy = true; states.hit(id, 0); }
+        if (signal2(tick, hist)) {
+            states.hit(id, 1);
+            if (tick.price < hist.mean()) {
+                buy = true;
+            } else {
+                sell = true;
+            }
+        }
+        if (signal3(hist)) { buy = true; states.hit(id, 2); }
+        if (signal4(tick, hist)) { buy = true; states.hit(id, 3); }
 
-    void updateHistory(const MarketData& tick) { // cannot preallocate as we don't know which instruments will appear
-        auto& hist = price_history[tick.instrument_id]; // keep last 10 prices of each instrument, reference to avoid copies
-        hist.push_back(tick.price);
-        if (hist.size() > 10) hist.erase(hist.begin());
+        return buy ? kBuy : sell ? kSell : kNone;
     }
 
-    double getAvg(int id) {
-        auto& hist = price_history[id];
-        double sum = 0;
-        for (double p : hist) sum += p;
-        return hist.empty() ? 0 : sum / hist.size();
+    void placeOrder(const MarketData& tick, bool buy, std::chrono::high_resolution_clock::time_point received) {
+        auto now = std::chrono::high_resolution_clock::now();
+        orders.emit() = Order{ tick.instrument_id, tick.price + (buy ? 0.01 : -0.01), buy, now };
+        ++orders_emitted;
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - received).count();
+        latencies.record(latency);
     }
 
-    double getVolatility(int id) {
-        auto& hist = price_history[id];
-        if (hist.size() < 2) return 0.0;
-        
-        double mean = getAvg(id);
-        double variance = 0.0;
-        for (double price : hist) {
-            variance += (price - mean) * (price - mean);
+    // Pipelined emission: orders [first, size()) carry their batch's hand-off time
+    void stampOrders(std::size_t first) {
+        if (first == orders.size()) return;
+        const auto now = std::chrono::high_resolution_clock::now();
+        for (std::size_t k = first; k < orders.size(); ++k) {
+            latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - orders[k].timestamp).count());
+            orders[k].timestamp = now;
         }
-        variance /= hist.size();
-        return std::sqrt(variance);
+        orders_emitted += orders.size() - first;
     }
 
-    bool signal1(const MarketData& tick) {
+    template <typename TickT>
+    bool signal1(const TickT& tick) {
         return tick.price < 105.0 || tick.price > 195.0;
     }
 
-    bool signal2(const MarketData& tick) {
-        if (price_history[tick.instrument_id].size() < 5) return false;
-        double avg = getAvg(tick.instrument_id);
+    template <typename TickT>
+    bool signal2(const TickT& tick, const RollingWindow& hist) {
+        if (hist.size() < 5) return false;
+        double avg = hist.mean();
         return tick.price < avg * 0.98 || tick.price > avg * 1.02;
     }
 
-    bool signal3(const MarketData& tick) {
-        auto& hist = price_history[tick.instrument_id];
+    bool signal3(const RollingWindow& hist) {
         if (hist.size() < 3) return false;
-        double diff1 = hist[hist.size() - 2] - hist[hist.size() - 3];
-        double diff2 = hist[hist.size() - 1] - hist[hist.size() - 2];
+        double diff1 = hist.back(1) - hist.back(2);
+        double diff2 = hist.back(0) - hist.back(1);
         return diff1 > 0 && diff2 > 0;
     }
 
-    bool signal4(const MarketData& tick) {
-        if (price_history[tick.instrument_id].size() < 5) return false;
+    template <typename TickT>
+    bool signal4(const TickT& tick, const RollingWindow& hist) {
+        if (hist.size() < 5) return false;
         
-        double volatility = getVolatility(tick.instrument_id);
-        double avg = getAvg(tick.instrument_id);
+        double volatility = hist.stddev();
+        double avg = hist.mean();
         double volatility_threshold = avg * 0.02; // 2% of average price
         
         // Buy if price is below average and volatility is high
@@ -187,15 +631,220 @@ private:
     }
 };
 
-int main() {
+// Hand-written process() vs the composed DefaultPipeline on the same feed:
+// fresh engine per run, only the processing loop is timed
+static void benchmarkPipelines(const std::vector<MarketData>& feed, std::size_t window, int instruments) {
+    auto timed = [&](const char* name, auto&& run) {
+        TradeEngine engine(feed, window, instruments);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        run(engine);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now() - t0).count();
+        std::printf("%-26s %8.2f ns/tick  orders=%zu\n", name,
+                    static_cast<double>(ns) / feed.size(), engine.ordersPlaced());
+    };
+    std::cout << "\n--- Pipeline vs hand-written (" << feed.size() << " ticks) ---\n";
+    timed("process()", [](TradeEngine& e) { e.process(); });
+    timed("Pipeline (no counters)", [](TradeEngine& e) { e.processPipeline(DefaultPipeline{}); });
+    timed("Pipeline (counters)", [](TradeEngine& e) { e.processPipeline<true>(DefaultPipeline{}); });
+    // Reordered components: same votes, so the same orders
+    timed("Pipeline (reordered)", [](TradeEngine& e) {
+        e.processPipeline(Pipeline<VolBreakout, Momentum, MeanRevert, Threshold>{});
+    });
+}
+
+// process() vs processPipelined() on the padded feed and on PackedTick, over
+// 10M and 100M ticks. Longer runs go through in 10M-tick chunks: each chunk
+// is generated (and packed) untimed, then run through all three engines,
+// whose state carries over; orders are cleared between chunks.
+static void benchmarkProcessing(std::size_t window, int instruments) {
+    constexpr std::size_t kChunk = 10'000'000;
+    std::cout << "\n--- Tick processing loop (window " << window << ", " << instruments << " instruments) ---\n";
+    std::printf("%-12s %-28s %9s %12s %10s\n", "ticks", "loop", "ns/tick", "Mticks/s", "orders");
+    for (std::size_t total : {std::size_t{10'000'000}, std::size_t{100'000'000}}) {
+        TradeEngine plain(nullptr, 0, window, instruments), padded(nullptr, 0, window, instruments),
+            packed(nullptr, 0, window, instruments);
+        for (TradeEngine* e : {&plain, &padded, &packed}) e->reserveOrders(kChunk);
+        long long ns[3] = {0, 0, 0};
+        std::vector<MarketData> feed;
+        MarketDataFeed generator(feed, instruments);
+        auto timed = [](auto&& run) {
+            const auto t0 = std::chrono::high_resolution_clock::now();
+            run();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::high_resolution_clock::now() - t0).count();
+        };
+        for (std::size_t done = 0, c = 0; done < total; done += kChunk, ++c) {
+            const std::size_t n = std::min(kChunk, total - done);
+            generator.generateData(static_cast<int>(n), 20250920 + static_cast<std::uint32_t>(c));
+            const std::vector<PackedTick> compact = packTicks(feed.data(), n);
+            ns[0] += timed([&] { plain.process(feed.data(), n); });
+            ns[1] += timed([&] { padded.processPipelined(feed.data(), n); });
+            ns[2] += timed([&] { packed.processPipelined(compact.data(), n); });
+            for (TradeEngine* e : {&plain, &padded, &packed}) e->clearOrders();
+        }
+        const char* names[3] = {"process()", "pipelined, MarketData (64B)", "pipelined, PackedTick (24B)"};
+        const TradeEngine* engines[3] = {&plain, &padded, &packed};
+        for (int v = 0; v < 3; ++v)
+            std::printf("%-12zu %-28s %9.2f %12.1f %10zu\n", total, names[v], static_cast<double>(ns[v]) / total,
+                        total * 1e3 / static_cast<double>(ns[v]), engines[v]->ordersPlaced());
+        bool same = true;
+        for (int v = 1; v < 3; ++v) {
+            same = same && engines[v]->ordersPlaced() == plain.ordersPlaced();
+            for (std::size_t k = 0; k < kSignals; ++k) same = same && engines[v]->signalHits(k) == plain.signalHits(k);
+        }
+        std::printf("%-12s same orders and signal counts: %s\n", "", same ? "yes" : "NO");
+    }
+}
+
+// Usage: HFT_Engine_Signal_based [--record FILE] [--replay FILE [--paced]] [--window N]
+//                                [--instruments N] [--pipeline] [--bench-pipeline]
+//   --record  capture the generated ticks to FILE
+//   --replay  process a captured tick file (mapped in place) instead of generating
+//   --paced   replay with the captured inter-tick gaps (default: as fast as possible)
+//   --window  prices per instrument the signals average over (default 10)
+//   --instruments  size of the generated instrument universe (default 10); on
+//                  --replay, the bound the capture's ids must lie under (default:
+//                  ids up to kMaxReplayInstruments, the universe sized from them)
+//   --gen-threads  feed generator threads (default 0: one per hardware thread)
+//   --pipeline  run the generated feed through DefaultPipeline instead of process()
+//   --bench-pipeline  time process() against the composed pipelines, then exit
+//   --bench-process   time process() against processPipelined() (padded and
+//                     packed ticks) at 10M and 100M ticks, then exit
+// Generation (and recording) happens before the timed region: Total Runtime
+// covers processing only; Feed Generation is reported on its own.
+// Generated ticks carry synthetic timestamps and replayed ones capture-time
+// timestamps, so on every path latency is measured from each tick's hand-off
+// to the engine rather than from its timestamp.
+// Largest instrument universe a replay sizes its tables for when --instruments
+// isn't given: the ids come from the file, so they're bounded before use
+constexpr int kMaxReplayInstruments = 1 << 20;
+
+// Whole-string integer flag value; throws std::invalid_argument or
+// std::out_of_range (std::stoll alone would accept "10abc" as 10)
+static long long parseFlagValue(const std::string& text) {
+    std::size_t used = 0;
+    const long long v = std::stoll(text, &used);
+    if (used != text.size()) throw std::invalid_argument(text);
+    return v;
+}
+
+int main(int argc, char** argv) {
+    std::string record_path, replay_path;
+    bool paced = false;
+    long long window = 10;  // parsed signed so "-1" is rejected rather than wrapped
+    long long instruments = 10;
+    bool instruments_given = false;
+    bool use_pipeline = false, bench_pipeline = false, bench_process = false;
+    long long gen_threads = 0;
+    auto usage = [&] {
+        std::cerr << "usage: " << argv[0] << " [--record FILE] [--replay FILE [--paced]] [--window N] [--instruments N]"
+                  " [--gen-threads N] [--pipeline] [--bench-pipeline] [--bench-process]\n";
+        return 2;
+    };
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        try {
+            if (arg == "--record" && a + 1 < argc)      record_path = argv[++a];
+            else if (arg == "--replay" && a + 1 < argc) replay_path = argv[++a];
+            else if (arg == "--paced")                  paced = true;
+            else if (arg == "--window" && a + 1 < argc) window = parseFlagValue(argv[++a]);
+            else if (arg == "--instruments" && a + 1 < argc) {
+                instruments = parseFlagValue(argv[++a]);
+                instruments_given = true;
+            }
+            else if (arg == "--gen-threads" && a + 1 < argc) gen_threads = parseFlagValue(argv[++a]);
+            else if (arg == "--pipeline")               use_pipeline = true;
+            else if (arg == "--bench-pipeline")         bench_pipeline = true;
+            else if (arg == "--bench-process")          bench_process = true;
+            else return usage();
+        } catch (const std::logic_error&) { // invalid_argument, out_of_range
+            std::cerr << arg << ": bad value '" << argv[a] << "'\n";
+            return usage();
+        }
+    }
+    // The rolling windows and the generator's instrument modulo need at least one
+    if (window < 1 || instruments < 1 || instruments > std::numeric_limits<int>::max()) {
+        std::cerr << "--window and --instruments must be at least 1\n";
+        return 2;
+    }
+    if (gen_threads < 0 || gen_threads > std::numeric_limits<unsigned>::max()) {
+        std::cerr << "--gen-threads must be 0 or more\n";
+        return 2;
+    }
+    const std::size_t window_size = static_cast<std::size_t>(window);
+    const int universe_size = static_cast<int>(instruments);
+
+    if (bench_process) {
+        benchmarkProcessing(window_size, universe_size);
+        return 0;
+    }
+
     std::vector<MarketData> feed;
-    MarketDataFeed generator(feed);
+    MarketDataFeed generator(feed, universe_size);
+    std::unique_ptr<MappedTickFile<MarketData>> capture;
+    std::unique_ptr<TradeEngine> engine_ptr;
 
-    auto start = std::chrono::high_resolution_clock::now();
-    generator.generateData(1000000);
+    long long generation_ms = -1;
+    if (replay_path.empty()) {
+        const auto gen_start = std::chrono::high_resolution_clock::now();
+        generator.generateData(1000000, 20250920, static_cast<unsigned>(gen_threads));
+        generation_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - gen_start).count();
+        if (!record_path.empty()) {
+            try {
+                TickRecorder<MarketData> recorder(record_path);
+                recorder.record(feed.data(), feed.data() + feed.size());
+                recorder.close();
+                std::cout << "Recorded " << recorder.size() << " ticks to " << record_path << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return 1;
+            }
+        }
+        if (bench_pipeline) {
+            benchmarkPipelines(feed, window_size, universe_size);
+            return 0;
+        }
+    }
 
-    TradeEngine engine(feed);
-    engine.process();
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!replay_path.empty()) {
+        try {
+            capture = std::make_unique<MappedTickFile<MarketData>>(replay_path);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        // The capture's ids decide the table size, and they index it: every id
+        // must lie in [0, limit) before anything is sized or touched
+        const int limit = instruments_given ? universe_size : kMaxReplayInstruments;
+        int universe = 0;
+        for (std::size_t i = 0; i < capture->size(); ++i) {
+            const int id = (*capture)[i].instrument_id;
+            if (id < 0 || id >= limit) {
+                std::cerr << replay_path << ": tick " << i << " has instrument id " << id
+                          << ", outside [0, " << limit << ")\n";
+                return 1;
+            }
+            universe = std::max(universe, id + 1);
+        }
+        engine_ptr = std::make_unique<TradeEngine>(capture->begin(), capture->size(), window_size, universe);
+        replayTicks(capture->begin(), capture->end(),
+                    [&](const MarketData& tick) {
+                        engine_ptr->onTick(tick, std::chrono::high_resolution_clock::now());
+                    },
+                    [](const MarketData& tick) {
+                        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            tick.timestamp.time_since_epoch()).count();
+                    },
+                    paced ? ReplayPacing::Original : ReplayPacing::AsFastAsPossible);
+    } else {
+        engine_ptr = std::make_unique<TradeEngine>(feed, window_size, universe_size);
+        if (use_pipeline) engine_ptr->processPipeline<true>(DefaultPipeline{});
+        else              engine_ptr->process();
+    }
+    TradeEngine& engine = *engine_ptr;
 
     auto end = std::chrono::high_resolution_clock::now();
     auto runtime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -208,6 +857,7 @@ int main() {
     
     // Report statistics
     engine.reportStats();
+    if (generation_ms >= 0) std::cout << "Feed Generation (ms): " << generation_ms << std::endl;
     std::cout << "Total Runtime (ms): " << runtime << std::endl;
 
     return 0;